@@ -6,7 +6,7 @@
 
 #include <cassert>
 
-#include <queue>
+#include <algorithm>
 #include <tuple>
 #include <vector>
 
@@ -15,8 +15,16 @@
 #include <origin.graph/handle.hpp>
 #include <origin.graph/graph.hpp>
 #include <origin.graph/io.hpp>
+#include <origin.graph/parallel.hpp>
+#include <origin.graph/compressed_graph.hpp>
 
 #include <origin.graph/adjacency_list.impl/pool.hpp>
+#include <origin.graph/adjacency_list.impl/soa_pool.hpp>
+#include <origin.graph/adjacency_list.impl/generational_pool.hpp>
+#include <origin.graph/adjacency_list.impl/edge_index.hpp>
+#include <origin.graph/adjacency_list.impl/small_vector.hpp>
+#include <origin.graph/adjacency_list.impl/edge_input.hpp>
+#include <origin.graph/adjacency_list.impl/capacity.hpp>
 
 namespace origin
 {
@@ -28,13 +36,11 @@ namespace origin
 
     // The handle accessor provides alternative accessors for the different
     // kinds of handle iterators required by the adjacency list data structure.
+    // By default, C is a pool, and the handle is the index of the iterator.
     template<typename C, typename H>
-      struct handle_accessor;
-
-    template<typename T, typename H>
-      struct handle_accessor<pool<T>, H>
+      struct handle_accessor
       {
-        using I = Iterator_of<const pool<T>>;
+        using I = Iterator_of<const C>;
 
         H get(I i) const { return i.index(); }
       };
@@ -47,6 +53,14 @@ namespace origin
         H get(I i) const { return *i; }
       };
 
+    template<typename T, std::size_t N, typename H>
+      struct handle_accessor<small_vector<T, N>, H>
+      {
+        using I = Iterator_of<const small_vector<T, N>>;
+
+        H get(I i) const { return *i; }
+      };
+
 
     // The handle iterator wraps a constant iterator of the container type C and
     // returns handles of type H when dereferenced.
@@ -112,56 +126,219 @@ namespace origin
     // In an undirected adjacency list, the source and target vertices refer to
     // the vertices in the order they were specified on addition. There is no
     // other meaning attributed to them.
-    template<typename E>
+    //
+    // The endpoints and positions are stored with values of type S, the
+    // handle width of the graph.
+    template<typename E, typename S = std::size_t>
       struct edge
       {
         using value_type = E;
+        using index_type = S;
+        using vertex_type = basic_vertex_handle<S>;
 
         edge()
-          : data(-1, -1, E{})
+          : data(-1, -1, E{}), spos(-1), tpos(-1)
         { }
 
-        edge(vertex_handle s, vertex_handle t)
-          : data(s, t, E{})
+        edge(vertex_type s, vertex_type t)
+          : data(s, t, E{}), spos(-1), tpos(-1)
         { }
 
         template<typename... Args>
-          edge(vertex_handle s, vertex_handle t, Args&&... args)
-            : data(s, t, std::forward<Args>(args)...)
+          edge(vertex_type s, vertex_type t, Args&&... args)
+            : data(s, t, std::forward<Args>(args)...), spos(-1), tpos(-1)
           { }
 
-        std::size_t& source()       { return std::get<0>(data); }
-        std::size_t  source() const { return std::get<0>(data); }
+        vertex_type& source()       { return std::get<0>(data); }
+        vertex_type  source() const { return std::get<0>(data); }
 
-        std::size_t& target()       { return std::get<1>(data); }
-        std::size_t  target() const { return std::get<1>(data); }
+        vertex_type& target()       { return std::get<1>(data); }
+        vertex_type  target() const { return std::get<1>(data); }
 
         E&       value()       { return std::get<2>(data); }
         const E& value() const { return std::get<2>(data); }
 
-        std::tuple<vertex_handle, vertex_handle,  E> data;
+        // Returns the position of the edge in the incidence list of its
+        // source (or target) vertex.
+        S& source_pos()       { return spos; }
+        S  source_pos() const { return spos; }
+
+        S& target_pos()       { return tpos; }
+        S  target_pos() const { return tpos; }
+
+        std::tuple<vertex_type, vertex_type,  E> data;
+        S spos;
+        S tpos;
       };
 
-    // An (incident) edge list is a vector of indexes.
-    using edge_list = std::vector<edge_handle>;
+    // An (incident) edge list is a vector of indexes. The first few indexes
+    // are stored inline, sized so that each list occupies 32 bytes. Most
+    // vertices never allocate storage for their incident edges. With 32-bit
+    // handles, six edges fit inline rather than three.
+    template<typename S>
+      using basic_edge_list = small_vector<basic_edge_handle<S>, 24 / sizeof(S)>;
+
+    using edge_list = basic_edge_list<std::size_t>;
+
+    // Erase the handle at position p in the incidence list l. Unless ordered
+    // is true, the last handle is moved into position p (swap and pop), which
+    // takes constant time. Otherwise, the handles following p are shifted
+    // down. Each edge that is moved is reported to fix(e, from, to) so that
+    // its recorded position can be updated.
+    template<typename L, typename F>
+      void
+      erase_incident(L& l, std::size_t p, bool ordered, F fix)
+      {
+        assert(p < l.size());
+        std::size_t last = l.size() - 1;
+        if (ordered) {
+          for (std::size_t i = p; i != last; ++i) {
+            l[i] = l[i + 1];
+            fix(l[i], i + 1, i);
+          }
+        } else if (p != last) {
+          l[p] = l[last];
+          fix(l[p], last, p);
+        }
+        l.pop_back();
+      }
+
+    // Remove the handles in the incidence list l that do not satisfy keep,
+    // preserving the order of the remaining handles. Each handle that is
+    // moved is reported to fix(e, from, to).
+    template<typename L, typename P, typename F>
+      void
+      filter_incident(L& l, P keep, F fix)
+      {
+        std::size_t k = 0;
+        for (std::size_t i = 0; i < l.size(); ++i) {
+          if (keep(l[i])) {
+            if (k != i) {
+              l[k] = l[i];
+              fix(l[k], i, k);
+            }
+            ++k;
+          }
+        }
+        while (l.size() != k)
+          l.pop_back();
+      }
+
+    // Vertex marks record the state of vertices during a batched removal.
+    // A vertex is either unmarked, doomed (to be removed), or a surviving
+    // neighbor of a doomed vertex.
+    class vertex_marks
+    {
+    public:
+      enum state : char { none, doomed, affected };
+
+      state get(std::size_t v) const
+      {
+        return v < marks_.size() ? state(marks_[v]) : none;
+      }
 
-    // An alias for the edge pool.
-    template<typename E>
-      using edge_pool = pool<edge<E>>;
+      void set(std::size_t v, state s)
+      {
+        if (v >= marks_.size())
+          marks_.resize(v + 1, none);
+        marks_[v] = s;
+      }
+
+    private:
+      std::vector<char> marks_;
+    };
+
+    // An alias for the edge pool. The pool template is the storage policy
+    // of the adjacency list.
+    template<typename E, template<typename> class Pool = pool, typename S = std::size_t>
+      using edge_pool = Pool<edge<E, S>>;
 
     // An alias for the vertex iterator.
-    template<typename E>
-      using edge_iterator = handle_iterator<edge_pool<E>, edge_handle>;
+    template<typename E, template<typename> class Pool = pool, typename S = std::size_t>
+      using edge_iterator = handle_iterator<edge_pool<E, Pool, S>, basic_edge_handle<S>>;
 
     // An alias for the edge range.
-    template<typename E>
-      using edge_range = bounded_range<edge_iterator<E>>;
+    template<typename E, template<typename> class Pool = pool, typename S = std::size_t>
+      using edge_range = bounded_range<edge_iterator<E, Pool, S>>;
 
     // An alias for the incident edge iterator.
-    using incidence_iterator = handle_iterator<edge_list, edge_handle>;
+    template<typename S = std::size_t>
+      using incidence_iterator = handle_iterator<basic_edge_list<S>, basic_edge_handle<S>>;
 
     // An alias for the icident edge range.
-    using incidence_range = bounded_range<incidence_iterator>;
+    template<typename S = std::size_t>
+      using incidence_range = bounded_range<incidence_iterator<S>>;
+
+
+    // ---------------------------------------------------------------------- //
+    //                              Handle Map
+    //
+    // A handle map records the translation of vertex and edge handles when
+    // a graph is compacted. The old value of a handle indexes its new value.
+    // The handles of removed vertices and edges are mapped to npos.
+    struct handle_map
+    {
+      std::vector<std::size_t> vertices;
+      std::vector<std::size_t> edges;
+    };
+
+    // Replace each handle in the incidence list l by its compacted value.
+    template<typename L>
+      inline void
+      remap_edges(L& l, const std::vector<std::size_t>& map)
+      {
+        for (auto& e : l)
+          e = map[e];
+      }
+
+
+    // ---------------------------------------------------------------------- //
+    //                                Snapshot
+    //
+    // A snapshot is a compressed (CSR) copy of an adjacency list, together
+    // with the translation of handles between the two. The vertices and
+    // edges of the compressed graph are numbered densely, so the handles of
+    // removed vertices and edges have no counterpart; dense maps them to
+    // npos. The original map is the inverse: the handle of each vertex and
+    // edge of the compressed graph in the adjacency list.
+    template<typename C>
+      struct snapshot
+      {
+        C          graph;    // The compressed graph
+        handle_map dense;    // From adjacency list to compressed graph
+        handle_map original; // From compressed graph to adjacency list
+      };
+
+    // Returns the inverse of the dense numbering orig, which maps each dense
+    // index to a handle. The result is indexed by handle, and is large
+    // enough to hold the greatest handle in orig. Other handles map to npos.
+    inline std::vector<std::size_t>
+    invert_handles(const std::vector<std::size_t>& orig)
+    {
+      std::size_t n = orig.size();
+      std::vector<std::size_t> extent(parallel_block_count(n), 0);
+      parallel_blocks(n, [&](std::size_t b, std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i != last; ++i)
+          extent[b] = std::max(extent[b], orig[i] + 1);
+      });
+      std::size_t k = *std::max_element(extent.begin(), extent.end());
+      std::vector<std::size_t> map(k, handle::npos);
+      parallel_for(n, [&](std::size_t i) { map[orig[i]] = i; });
+      return map;
+    }
+
+    // Number the vertices of g densely, in the order of iteration, recording
+    // the translation in the snapshot s.
+    template<typename G, typename C>
+      void
+      number_vertices(const G& g, snapshot<C>& s)
+      {
+        std::vector<std::size_t>& orig = s.original.vertices;
+        orig.reserve(g.order());
+        for (auto v : g.vertices())
+          orig.push_back(v);
+        s.dense.vertices = invert_handles(orig);
+      }
 
   } // namespace adjacency_list_impl
 
@@ -173,6 +350,27 @@ namespace origin
   //
   // A directed adjacency list...
   //
+  // The Pool template parameter selects the storage of the vertex and edge
+  // sets. The default, adjacency_list_impl::pool, interleaves the links of
+  // the live list with each object. The adjacency_list_impl::soa_pool stores
+  // only the objects, and finds live objects with a bitmap of free slots,
+  // which reduces the memory touched when scanning or accessing small
+  // vertices and edges.
+  //
+  // When Pool is an adjacency_list_impl::generational_pool, the graph can
+  // also stamp vertex and edge handles with the generation of their slot.
+  // Resolving a stamped handle yields an invalid handle if its object has
+  // since been removed, even if the slot was reused.
+  //
+  // The Index template parameter selects how edges are found by their
+  // endpoints, as in g(u, v), g.remove_edge(u, v), and g.remove_edges(u, v).
+  // The default, adjacency_list_impl::linear_edge_index, searches the
+  // incidence lists and costs no memory. The adjacency_list_impl::
+  // hash_edge_index maintains a hash table of edges keyed on their
+  // endpoints, making lookup expected constant time. When there are
+  // parallel edges, the edge found by an indexed lookup is not necessarily
+  // the first in either incidence list.
+  //
 
 
   namespace directed_adjacency_list_impl
@@ -180,7 +378,7 @@ namespace origin
     // Imports
     using adjacency_list_impl::pool;
     using adjacency_list_impl::handle_iterator;
-    using adjacency_list_impl::edge_list;
+    using adjacency_list_impl::basic_edge_list;
 
 
     // ---------------------------------------------------------------------- //
@@ -191,10 +389,13 @@ namespace origin
     // separate edge container.
     //
     // Note that the class will compress the value type if it is empty.
-    template<typename V>
+    template<typename V, typename S = std::size_t>
       struct vertex
       {
         using value_type = V;
+        using index_type = S;
+        using edge_list = basic_edge_list<S>;
+        using edge_handle = basic_edge_handle<S>;
         using iterator = typename edge_list::iterator;
         using const_iterator = typename edge_list::const_iterator;
 
@@ -223,7 +424,6 @@ namespace origin
         std::size_t out_degree() const { return out().size(); }
 
         void insert_out(edge_handle e) { insert_edge(out(), e); }
-        void erase_out(edge_handle e)  { erase_edge(out(), e); }
 
         iterator begin_out() { return out().begin(); }
         iterator end_out()   { return out().end(); }
@@ -234,7 +434,6 @@ namespace origin
         std::size_t in_degree() const { return in().size(); }
 
         void insert_in(edge_handle e) { insert_edge(in(), e); }
-        void erase_in(edge_handle e)  { erase_edge(in(), e); }
 
         iterator begin_in() { return in().begin(); }
         iterator end_in()   { return in().end(); }
@@ -243,67 +442,82 @@ namespace origin
 
         // Helper functions
         void insert_edge(edge_list& l, edge_handle e);
-        void erase_edge(edge_list& l, edge_handle e);
 
       public:
         std::tuple<edge_list, edge_list, V> data;
       };
 
-    template<typename V>
+    template<typename V, typename S>
       inline void
-      vertex<V>::insert_edge(edge_list& l, edge_handle e)
+      vertex<V, S>::insert_edge(edge_list& l, edge_handle e)
       {
         l.push_back(e);
       }
 
-    template<typename V>
-      inline void
-      vertex<V>::erase_edge(edge_list& l, edge_handle e)
-      {
-        auto i = std::find(l.begin(), l.end(), e);
-        if (i != l.end())
-          l.erase(i);
-      }
-
     // A vertex set is a pool of vertices.
-    template<typename V>
-      using vertex_pool = pool<vertex<V>>;
+    template<typename V, template<typename> class Pool = pool, typename S = std::size_t>
+      using vertex_pool = Pool<vertex<V, S>>;
 
     // An alias for the vertex iterator.
-    template<typename V>
-      using vertex_iterator = handle_iterator<vertex_pool<V>, vertex_handle>;
+    template<typename V, template<typename> class Pool = pool, typename S = std::size_t>
+      using vertex_iterator = handle_iterator<vertex_pool<V, Pool, S>, basic_vertex_handle<S>>;
 
     // An alias for the vertex range.
-    template<typename V>
-      using vertex_range = bounded_range<vertex_iterator<V>>;
+    template<typename V, template<typename> class Pool = pool, typename S = std::size_t>
+      using vertex_range = bounded_range<vertex_iterator<V, Pool, S>>;
 
   } // namespace directed_adjacency_list_impl
 
 
   // Implementation of a diretected adjacency list.
-  template<typename V = empty_t, typename E = empty_t>
+  template<typename V = empty_t,
+           typename E = empty_t,
+           template<typename> class Pool = adjacency_list_impl::pool,
+           typename Index = adjacency_list_impl::linear_edge_index,
+           typename Size = std::size_t>
     class directed_adjacency_list
     {
-      using this_type = directed_adjacency_list<V, E>;
+      using this_type = directed_adjacency_list<V, E, Pool, Index, Size>;
 
-      using vertex_node = directed_adjacency_list_impl::vertex<V>;
-      using vertex_set = directed_adjacency_list_impl::vertex_pool<V>;
-      using vertex_iter = directed_adjacency_list_impl::vertex_iterator<V>;
+      using vertex_node = directed_adjacency_list_impl::vertex<V, Size>;
+      using vertex_set = directed_adjacency_list_impl::vertex_pool<V, Pool, Size>;
+      using vertex_iter = directed_adjacency_list_impl::vertex_iterator<V, Pool, Size>;
 
-      using edge_node = adjacency_list_impl::edge<E>;
-      using edge_set = adjacency_list_impl::edge_pool<E>;
-      using edge_iter = adjacency_list_impl::edge_iterator<E>;
+      using edge_node = adjacency_list_impl::edge<E, Size>;
+      using edge_set = adjacency_list_impl::edge_pool<E, Pool, Size>;
+      using edge_iter = adjacency_list_impl::edge_iterator<E, Pool, Size>;
 
-      using incidence_iter = adjacency_list_impl::incidence_iterator;
+      using edge_list = adjacency_list_impl::basic_edge_list<Size>;
+      using incidence_iter = adjacency_list_impl::incidence_iterator<Size>;
     public:
-      using vertex = vertex_handle;
-      using vertex_range = directed_adjacency_list_impl::vertex_range<V>;
+      using size_type = Size;
+
+      using vertex = basic_vertex_handle<Size>;
+      using vertex_range = directed_adjacency_list_impl::vertex_range<V, Pool, Size>;
+
+      using edge = basic_edge_handle<Size>;
+      using edge_range = adjacency_list_impl::edge_range<E, Pool, Size>;
+
+      using incidence_range = adjacency_list_impl::incidence_range<Size>;
+
+      using capacity_type = adjacency_list_impl::graph_capacity;
+
+      using handle_map = adjacency_list_impl::handle_map;
+
+      using compressed_type = compressed_directed_graph<V, E>;
+      using snapshot_type = adjacency_list_impl::snapshot<compressed_type>;
 
-      using edge = edge_handle;
-      using edge_range = adjacency_list_impl::edge_range<E>;
+      using stamped_vertex = generational_handle<vertex>;
+      using stamped_edge = generational_handle<edge>;
 
-      using incidence_range = adjacency_list_impl::incidence_range;
+      // Construction
+      directed_adjacency_list() = default;
 
+      template<typename I>
+        directed_adjacency_list(I first, I last, std::size_t n = 0);
+
+      template<typename I>
+        void assign_edges(I first, I last, std::size_t n = 0);
 
       // Observers
       bool        null() const  { return verts_.empty(); }
@@ -312,6 +526,14 @@ namespace origin
       bool        empty() const { return edges_.empty(); }
       std::size_t size() const  { return edges_.size(); }
 
+      // Capacity
+      capacity_type capacity() const;
+      void reserve_vertices(std::size_t n);
+      void reserve_edges(std::size_t m);
+      void reserve_out(vertex v, std::size_t k);
+      void reserve_in(vertex v, std::size_t k);
+      void shrink_to_fit();
+
       // Vertex observers
       std::size_t out_degree(vertex v) const { return node(v).out_degree(); }
       std::size_t in_degree(vertex v) const  { return node(v).in_degree(); }
@@ -342,6 +564,12 @@ namespace origin
       void remove_vertex(vertex v);
       void remove_vertices();
 
+      template<typename R>
+        void remove_vertices(const R& range);
+
+      template<typename P>
+        void remove_vertices_if(P pred);
+
       // Edge set
       edge add_edge(vertex u, vertex v);
       edge add_edge(vertex u, vertex v, E&& x);
@@ -356,6 +584,27 @@ namespace origin
       void remove_edges(vertex v);
       void remove_edges();
 
+      // Removal order
+      // By default, removing an edge may reorder the incidence lists of its
+      // endpoints. Preserving order makes removal linear in the degree.
+      void preserve_order(bool b)   { ordered_ = b; }
+      bool preserves_order() const  { return ordered_; }
+
+      // Maintenance
+      handle_map compact();
+
+      // Snapshots
+      snapshot_type snapshot() const;
+      snapshot_type freeze();
+
+      // Generational handles
+      // These are available only when Pool is a generational pool.
+      stamped_vertex stamp(vertex v) const;
+      stamped_edge   stamp(edge e) const;
+
+      vertex resolve(stamped_vertex v) const;
+      edge   resolve(stamped_edge e) const;
+
       // Iterators
       vertex_range    vertices() const;
       edge_range      edges() const;
@@ -376,139 +625,280 @@ namespace origin
       template<typename S, typename P>
         edge find_edge(const S& seq, P pred) const;
 
+      void remove_batch(const std::vector<vertex>& vs);
+      snapshot_type make_snapshot() const;
       void link_edge(vertex u, vertex v, edge e);
-      void unlink_edge(vertex u, vertex v, edge e);
+      void unlink_edge(edge e);
+      void erase_edge(edge e);
       void unlink_out_edge(vertex u, vertex v);
       void unlink_in_edge(vertex u, vertex v);
       void unlink_out_edges(vertex u, vertex v);
       void unlink_in_edges(vertex u, vertex v);
-      void unlink_target(edge e);
-      void unlink_source(edge e);
+      void detach_out(vertex u, std::size_t p);
+      void detach_in(vertex v, std::size_t p);
 
       template<typename S, typename P>
         void unlink_first_edge(S& seq, P pred);
 
-      template<typename S1, typename S2, typename P>
-        void unlink_multi_edge(S1& seq1, S2& seq2, P pred);
+      template<typename S, typename P>
+        void unlink_multi_edge(S& seq, P pred);
 
     private:
       vertex_set verts_;
       edge_set   edges_;
+      Index      index_;
+      bool       ordered_ = false;
     };
 
 
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline auto
-    directed_adjacency_list<V, E>::operator()(vertex u, vertex v) const -> edge
+    directed_adjacency_list<V, E, Pool, Index, Size>::operator()(vertex u, vertex v) const -> edge
     {
+      if (Index::indexed)
+        return edge(index_.find(u, v));
       if (out_degree(u) <= in_degree(v))
         return find_out_edge(u, v);
       else
         return find_in_edge(u, v);
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline auto
-    directed_adjacency_list<V, E>::find_out_edge(vertex u, vertex v) const -> edge
+    directed_adjacency_list<V, E, Pool, Index, Size>::find_out_edge(vertex u, vertex v) const -> edge
     {
       using P = has_target<this_type>;
       const vertex_node& n = node(u);
       return find_edge(n.out(), P(*this, v));
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline auto
-    directed_adjacency_list<V, E>::find_in_edge(vertex u, vertex v) const -> edge
+    directed_adjacency_list<V, E, Pool, Index, Size>::find_in_edge(vertex u, vertex v) const -> edge
     {
       using P = has_source<this_type>;
       const vertex_node& n = node(v);
       return find_edge(n.in(), P(*this, u));
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     template<typename S, typename P>
       inline auto
-      directed_adjacency_list<V, E>::find_edge(const S& seq, P pred) const -> edge
+      directed_adjacency_list<V, E, Pool, Index, Size>::find_edge(const S& seq, P pred) const -> edge
       {
         auto i = find_if(seq, pred);
         return i == seq.end() ? edge() : *i;
       }
 
+  // Construct a graph from the input edges in [first, last), with at least
+  // n vertices. See assign_edges for details.
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
+    template<typename I>
+      inline
+      directed_adjacency_list<V, E, Pool, Index, Size>::directed_adjacency_list(I first, I last, std::size_t n)
+      {
+        assign_edges(first, last, n);
+      }
+
+  // Replace the contents of the graph with the input edges in [first, last).
+  // Each input edge is a pair (u, v) or a tuple (u, v, x), where x is the
+  // value of the edge. The graph has at least n vertices, and at least one
+  // more than the greatest endpoint. Vertex values are default constructed.
+  //
+  // The range is traversed twice. The first pass counts the degree of each
+  // vertex, so that the vertex set, the edge set, and every incidence list
+  // are allocated exactly once. The second pass adds the edges.
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
+    template<typename I>
+      void
+      directed_adjacency_list<V, E, Pool, Index, Size>::assign_edges(I first, I last, std::size_t n)
+      {
+        adjacency_list_impl::degree_count c =
+          adjacency_list_impl::count_degrees(first, last, n);
+        remove_vertices();
+        verts_.reserve(c.order);
+        edges_.reserve(c.size);
+        index_.reserve(c.size);
+        for (std::size_t i = 0; i < c.order; ++i) {
+          vertex_node& vn = node(add_vertex());
+          vn.out().reserve(c.out[i]);
+          vn.in().reserve(c.in[i]);
+        }
+        for ( ; first != last; ++first)
+          adjacency_list_impl::emplace_input(*this, *first);
+      }
+
   // Add a vertex to the graph, returning a handle to the new object. If
   // V is a user-supplied type, its value is default constructed.
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline auto
-    directed_adjacency_list<V, E>::add_vertex() -> vertex
+    directed_adjacency_list<V, E, Pool, Index, Size>::add_vertex() -> vertex
     {
       return verts_.emplace();
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline auto
-    directed_adjacency_list<V, E>::add_vertex(V&& x) -> vertex
+    directed_adjacency_list<V, E, Pool, Index, Size>::add_vertex(V&& x) -> vertex
     {
       return verts_.emplace(std::move(x));
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline auto
-    directed_adjacency_list<V, E>::add_vertex(const V& x) -> vertex
+    directed_adjacency_list<V, E, Pool, Index, Size>::add_vertex(const V& x) -> vertex
     {
       return verts_.emplace(x);
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     template<typename... Args>
       inline auto
-      directed_adjacency_list<V, E>::emplace_vertex(Args&&... args) -> vertex
+      directed_adjacency_list<V, E, Pool, Index, Size>::emplace_vertex(Args&&... args) -> vertex
       {
         return verts_.emplace(std::forward<Args>(args)...);
       }
 
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline void
-    directed_adjacency_list<V, E>::remove_vertex(vertex v)
+    directed_adjacency_list<V, E, Pool, Index, Size>::remove_vertex(vertex v)
     {
       remove_edges(v);
       verts_.erase(v);
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline void
-    directed_adjacency_list<V, E>::remove_vertices()
+    directed_adjacency_list<V, E, Pool, Index, Size>::remove_vertices()
     {
       edges_.clear();
+      index_.clear();
       verts_.clear();
     }
 
+  // Remove each vertex in range, and all of their incident edges. The
+  // range may contain duplicates.
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
+    template<typename R>
+      inline void
+      directed_adjacency_list<V, E, Pool, Index, Size>::remove_vertices(const R& range)
+      {
+        std::vector<vertex> vs;
+        for (vertex v : range)
+          vs.push_back(v);
+        remove_batch(vs);
+      }
+
+  // Remove each vertex satisfying pred, and all of their incident edges.
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
+    template<typename P>
+      inline void
+      directed_adjacency_list<V, E, Pool, Index, Size>::remove_vertices_if(P pred)
+      {
+        std::vector<vertex> vs;
+        for (vertex v : vertices())
+          if (pred(v))
+            vs.push_back(v);
+        remove_batch(vs);
+      }
+
+  // Remove the vertices in vs, and all of their incident edges.
+  //
+  // Rather than unlinking incident edges one at a time, the doomed vertices
+  // are marked, and the incidence lists of each surviving neighbor are
+  // filtered in a single pass. The order of the surviving edges in those
+  // lists is preserved. Doomed edges are collected before any is erased:
+  // an edge is collected from the out list of its source, or from the in
+  // list of its target when the source survives.
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
+    void
+    directed_adjacency_list<V, E, Pool, Index, Size>::remove_batch(const std::vector<vertex>& vs)
+    {
+      using marks = adjacency_list_impl::vertex_marks;
+      marks m;
+      std::vector<vertex> doomed;
+      for (vertex v : vs) {
+        if (m.get(v) != marks::doomed) {
+          m.set(v, marks::doomed);
+          doomed.push_back(v);
+        }
+      }
+
+      // Find the surviving neighbors.
+      std::vector<vertex> affected;
+      auto touch = [&](vertex u) {
+        if (m.get(u) == marks::none) {
+          m.set(u, marks::affected);
+          affected.push_back(u);
+        }
+      };
+      for (vertex v : doomed) {
+        for (edge e : node(v).out())
+          touch(target(e));
+        for (edge e : node(v).in())
+          touch(source(e));
+      }
+
+      // Filter their incidence lists.
+      auto keep = [&](edge e) {
+        return m.get(source(e)) != marks::doomed
+            && m.get(target(e)) != marks::doomed;
+      };
+      auto fix_out = [this](edge e, std::size_t, std::size_t to) {
+        get_edge(e).source_pos() = to;
+      };
+      auto fix_in = [this](edge e, std::size_t, std::size_t to) {
+        get_edge(e).target_pos() = to;
+      };
+      for (vertex u : affected) {
+        vertex_node& un = node(u);
+        adjacency_list_impl::filter_incident(un.out(), keep, fix_out);
+        adjacency_list_impl::filter_incident(un.in(), keep, fix_in);
+      }
+
+      // Erase the doomed edges and vertices.
+      std::vector<edge> dead;
+      for (vertex v : doomed) {
+        const vertex_node& vn = node(v);
+        dead.insert(dead.end(), vn.out().begin(), vn.out().end());
+        for (edge e : vn.in())
+          if (m.get(source(e)) != marks::doomed)
+            dead.push_back(e);
+      }
+      for (edge e : dead)
+        erase_edge(e);
+      for (vertex v : doomed)
+        verts_.erase(v);
+    }
+
   // Add a defaul edge from u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline auto
-    directed_adjacency_list<V, E>::add_edge(vertex u, vertex v) -> edge
+    directed_adjacency_list<V, E, Pool, Index, Size>::add_edge(vertex u, vertex v) -> edge
     {
       return emplace_edge(u, v);
     }
 
   // Move x into an edge connecting u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline auto
-    directed_adjacency_list<V, E>::add_edge(vertex u, vertex v, E&& x) -> edge
+    directed_adjacency_list<V, E, Pool, Index, Size>::add_edge(vertex u, vertex v, E&& x) -> edge
     {
       return emplace_edge(u, v, std::move(x));
     }
 
   // Copy x into an edge connecting u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline auto
-    directed_adjacency_list<V, E>::add_edge(vertex u, vertex v, const E& x) -> edge
+    directed_adjacency_list<V, E, Pool, Index, Size>::add_edge(vertex u, vertex v, const E& x) -> edge
     {
       return emplace_edge(u, v, x);
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     template<typename... Args>
       inline auto
-      directed_adjacency_list<V, E>::
+      directed_adjacency_list<V, E, Pool, Index, Size>::
         emplace_edge(vertex u, vertex v, Args&&... args) -> edge
       {
         edge e = edges_.emplace(u, v, std::forward<Args>(args)...);
@@ -516,216 +906,444 @@ namespace origin
         return e;
       }
 
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline void
-    directed_adjacency_list<V, E>::link_edge(vertex u, vertex v, edge e)
+    directed_adjacency_list<V, E, Pool, Index, Size>::link_edge(vertex u, vertex v, edge e)
     {
       vertex_node& un = node(u);
       vertex_node& vn = node(v);
+      edge_node& en = get_edge(e);
+      en.source_pos() = un.out_degree();
+      en.target_pos() = vn.in_degree();
       un.insert_out(e);
       vn.insert_in(e);
+      index_.insert(u, v, e);
     }
 
   // Remove the specified edge from the graph.
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline void
-    directed_adjacency_list<V, E>::remove_edge(edge e)
+    directed_adjacency_list<V, E, Pool, Index, Size>::remove_edge(edge e)
     {
-      unlink_edge(source(e), target(e), e);
+      unlink_edge(e);
     }
 
   // Unlink the given edge from the source and target vertices, and erase
-  // it from the edge set.
-  template<typename V, typename E>
+  // it from the edge set. The edge records its position in both incidence
+  // lists, so no search is required.
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline void
-    directed_adjacency_list<V, E>::unlink_edge(vertex u, vertex v, edge e)
+    directed_adjacency_list<V, E, Pool, Index, Size>::unlink_edge(edge e)
     {
-      vertex_node& un = node(u);
-      vertex_node& vn = node(v);
-      un.erase_out(e);
-      vn.erase_in(e);
+      const edge_node& en = get_edge(e);
+      detach_out(en.source(), en.source_pos());
+      detach_in(en.target(), en.target_pos());
+      erase_edge(e);
+    }
+
+  // Erase the edge e from the edge set and the edge index.
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
+    inline void
+    directed_adjacency_list<V, E, Pool, Index, Size>::erase_edge(edge e)
+    {
+      index_.erase(source(e), target(e), e);
       edges_.erase(e);
     }
 
+  // Erase the pth out edge of u, updating the source position of any edge
+  // moved by the erasure.
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
+    inline void
+    directed_adjacency_list<V, E, Pool, Index, Size>::detach_out(vertex u, std::size_t p)
+    {
+      auto fix = [this](edge f, std::size_t, std::size_t to) {
+        get_edge(f).source_pos() = to;
+      };
+      adjacency_list_impl::erase_incident(node(u).out(), p, ordered_, fix);
+    }
+
+  // Erase the pth in edge of v, updating the target position of any edge
+  // moved by the erasure.
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
+    inline void
+    directed_adjacency_list<V, E, Pool, Index, Size>::detach_in(vertex v, std::size_t p)
+    {
+      auto fix = [this](edge f, std::size_t, std::size_t to) {
+        get_edge(f).target_pos() = to;
+      };
+      adjacency_list_impl::erase_incident(node(v).in(), p, ordered_, fix);
+    }
+
 
   // Remove the first edge connecting u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline void
-    directed_adjacency_list<V, E>::remove_edge(vertex u, vertex v)
+    directed_adjacency_list<V, E, Pool, Index, Size>::remove_edge(vertex u, vertex v)
     {
-      if (out_degree(u) <= in_degree(v))
+      if (Index::indexed) {
+        if (edge e = (*this)(u, v))
+          unlink_edge(e);
+      } else if (out_degree(u) <= in_degree(v))
         unlink_out_edge(u, v);
       else
         unlink_in_edge(u, v);
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline void
-    directed_adjacency_list<V, E>::unlink_out_edge(vertex u, vertex v)
+    directed_adjacency_list<V, E, Pool, Index, Size>::unlink_out_edge(vertex u, vertex v)
     {
       using P = has_target<this_type>;
       vertex_node& un = node(u);
       unlink_first_edge(un.out(), P(*this, v));
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline void
-    directed_adjacency_list<V, E>::unlink_in_edge(vertex u, vertex v)
+    directed_adjacency_list<V, E, Pool, Index, Size>::unlink_in_edge(vertex u, vertex v)
     {
       using P = has_source<this_type>;
       vertex_node& vn = node(v);
       unlink_first_edge(vn.in(), P(*this, u));
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     template<typename S, typename P>
       inline void
-      directed_adjacency_list<V, E>::unlink_first_edge(S& seq, P pred)
+      directed_adjacency_list<V, E, Pool, Index, Size>::unlink_first_edge(S& seq, P pred)
       {
         auto i = find_if(seq, pred);
-        if (i != seq.end());
-          remove_edge(*i);
+        if (i != seq.end())
+          unlink_edge(*i);
       }
 
   // Remove all edges connecting u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline void
-    directed_adjacency_list<V, E>::remove_edges(vertex u, vertex v)
+    directed_adjacency_list<V, E, Pool, Index, Size>::remove_edges(vertex u, vertex v)
     {
-      if (out_degree(u) <= in_degree(v))
+      if (Index::indexed) {
+        while (edge e = (*this)(u, v))
+          unlink_edge(e);
+      } else if (out_degree(u) <= in_degree(v))
         unlink_out_edges(u, v);
       else
         unlink_in_edges(u, v);
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline void
-    directed_adjacency_list<V, E>::unlink_out_edges(vertex u, vertex v)
+    directed_adjacency_list<V, E, Pool, Index, Size>::unlink_out_edges(vertex u, vertex v)
     {
       using P = has_target<this_type>;
       vertex_node& un = node(u);
-      vertex_node& vn = node(v);
-      unlink_multi_edge(un.out(), vn.in(), P(*this, v));
+      unlink_multi_edge(un.out(), P(*this, v));
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline void
-    directed_adjacency_list<V, E>::unlink_in_edges(vertex u, vertex v)
+    directed_adjacency_list<V, E, Pool, Index, Size>::unlink_in_edges(vertex u, vertex v)
     {
       using P = has_source<this_type>;
-      vertex_node& un = node(u);
       vertex_node& vn = node(v);
-      unlink_multi_edge(vn.in(), un.out(), P(*this, u));
+      unlink_multi_edge(vn.in(), P(*this, u));
     }
 
-  // Remove all edges from seq1 that are connected to seq2.
-  template<typename V, typename E>
-    template<typename S1, typename S2, typename P>
+  // Remove all edges in seq that satisfy pred.
+  //
+  // The sequence is scanned from back to front. Erasing an edge only moves
+  // handles that have already been visited (the last handle, or those
+  // following the erased position), so no edge is skipped.
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
+    template<typename S, typename P>
       inline void
-      directed_adjacency_list<V, E>::unlink_multi_edge(S1& seq1, S2& seq2, P pred)
+      directed_adjacency_list<V, E, Pool, Index, Size>::unlink_multi_edge(S& seq, P pred)
       {
-        // Partition the 1st sequence by the given predicate into "save" and
-        // "erase" components.
-        //
-        // NOTE: We may want this to be a stable partition... not sure. It
-        // seems like the saved edges are not reordered by the partitioning.
-        auto i = partition(seq1, negate(pred));
-        for (auto j = i; j != seq1.end(); ++j) {
-          // Remove those edges from the in 2nd sequence.
-          auto k = remove(seq2, *j);
-          seq2.erase(k, seq2.end());
-
-          // Erase the edge from the graph's edge set.
-          edges_.erase(*j);
+        for (std::size_t i = seq.size(); i != 0; --i) {
+          edge e = seq[i - 1];
+          if (pred(e))
+            unlink_edge(e);
         }
-
-        // Finally, erase those edges from the first sequence.
-        seq1.erase(i, seq1.end());
       }
 
 
   // Remove all edges incident to the vertex v.
-  template<typename V, typename E>
+  //
+  // Note that loops are erased with the out edges. By the time the in edges
+  // are cleared, no in edge has v as its source.
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline void
-    directed_adjacency_list<V, E>::remove_edges(vertex v)
+    directed_adjacency_list<V, E, Pool, Index, Size>::remove_edges(vertex v)
     {
       vertex_node& vn = node(v);
 
       // Clear the out edges
-      for (auto e : vn.out())
-        unlink_target(e);
+      for (edge e : vn.out()) {
+        detach_in(target(e), get_edge(e).target_pos());
+        erase_edge(e);
+      }
       vn.out().clear();
 
       // Clear the in edges
-      for(auto e : vn.in())
-        unlink_source(e);
+      for (edge e : vn.in()) {
+        detach_out(source(e), get_edge(e).source_pos());
+        erase_edge(e);
+      }
       vn.in().clear();
     }
 
-  template<typename V, typename E>
+
+  // Remove all edges from a graph, making it empty.
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline void
-    directed_adjacency_list<V, E>::unlink_target(edge e)
+    directed_adjacency_list<V, E, Pool, Index, Size>::remove_edges()
     {
-      vertex_node& t = node(target(e));
-      auto i = find(t.in(), e);
-      t.in().erase(i);
-      edges_.erase(e);
+      for (vertex_node& n : verts_) {
+        n.out().clear();
+        n.in().clear();
+      }
+      edges_.clear();
+      index_.clear();
+    }
+
+  // Compact the vertex and edge sets so that their handles are dense,
+  // releasing the storage of removed vertices and edges. The relative
+  // order of vertices and edges is preserved. All existing handles are
+  // invalidated; the returned map translates them to their new values.
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
+    auto
+    directed_adjacency_list<V, E, Pool, Index, Size>::compact() -> handle_map
+    {
+      handle_map map {verts_.compact(), edges_.compact()};
+      index_.clear();
+      for (auto i = edges_.begin(); i != edges_.end(); ++i) {
+        edge_node& e = *i;
+        e.source() = map.vertices[e.source()];
+        e.target() = map.vertices[e.target()];
+        index_.insert(e.source(), e.target(), i.index());
+      }
+      for (vertex_node& v : verts_) {
+        adjacency_list_impl::remap_edges(v.out(), map.edges);
+        adjacency_list_impl::remap_edges(v.in(), map.edges);
+      }
+      return map;
+    }
+
+  // Returns a compressed snapshot of the graph: a read-only copy in CSR
+  // format, with vertices and edges renumbered densely, and the translation
+  // of handles between the graph and the snapshot. The snapshot does not
+  // refer to the graph, so the graph may be modified as soon as this
+  // returns, but not while it runs.
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
+    auto
+    directed_adjacency_list<V, E, Pool, Index, Size>::snapshot() const -> snapshot_type
+    {
+      snapshot_type s = make_snapshot();
+      const std::vector<std::size_t>& verts = s.original.vertices;
+      const std::vector<std::size_t>& edges = s.original.edges;
+      parallel_for(verts.size(), [&](std::size_t i) {
+        s.graph(vertex_handle(i)) = node(verts[i]).value();
+      });
+      parallel_for(edges.size(), [&](std::size_t i) {
+        s.graph(edge_handle(i)) = get_edge(edges[i]).value();
+      });
+      return s;
+    }
+
+  // Move the graph into a compressed snapshot, leaving it null. Vertex and
+  // edge values are moved rather than copied.
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
+    auto
+    directed_adjacency_list<V, E, Pool, Index, Size>::freeze() -> snapshot_type
+    {
+      snapshot_type s = make_snapshot();
+      const std::vector<std::size_t>& verts = s.original.vertices;
+      const std::vector<std::size_t>& edges = s.original.edges;
+      parallel_for(verts.size(), [&](std::size_t i) {
+        s.graph(vertex_handle(i)) = std::move(node(verts[i]).value());
+      });
+      parallel_for(edges.size(), [&](std::size_t i) {
+        s.graph(edge_handle(i)) = std::move(get_edge(edges[i]).value());
+      });
+      remove_vertices();
+      return s;
+    }
+
+  // Build the structure of a snapshot. Vertices are numbered in the order
+  // of iteration, and edges are numbered by source, in the order of each
+  // out edge list. Except for numbering the vertices, each step is a
+  // parallel loop over the vertices or edges of the snapshot.
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
+    auto
+    directed_adjacency_list<V, E, Pool, Index, Size>::make_snapshot() const -> snapshot_type
+    {
+      snapshot_type s;
+      adjacency_list_impl::number_vertices(*this, s);
+      const std::vector<std::size_t>& verts = s.original.vertices;
+      const std::vector<std::size_t>& vmap = s.dense.vertices;
+      std::size_t n = verts.size();
+
+      typename compressed_type::arrays a;
+      a.out.resize(n + 1, 0);
+      a.in.resize(n + 1, 0);
+      parallel_for(n, [&](std::size_t i) {
+        const vertex_node& vn = node(verts[i]);
+        a.out[i] = vn.out_degree();
+        a.in[i] = vn.in_degree();
+      });
+      compressed_graph_impl::prefix_sum(a.out);
+      compressed_graph_impl::prefix_sum(a.in);
+
+      // Number the edges and record their targets.
+      std::size_t m = a.out[n];
+      s.original.edges.resize(m);
+      a.targets.resize(m);
+      parallel_for(n, [&](std::size_t i) {
+        std::size_t k = a.out[i];
+        for (edge e : node(verts[i]).out()) {
+          s.original.edges[k] = e;
+          a.targets[k] = vmap[target(e)];
+          ++k;
+        }
+      });
+      s.dense.edges = adjacency_list_impl::invert_handles(s.original.edges);
+
+      // Translate the in edge lists.
+      const std::vector<std::size_t>& emap = s.dense.edges;
+      a.ins.resize(m);
+      parallel_for(n, [&](std::size_t i) {
+        std::size_t k = a.in[i];
+        for (edge e : node(verts[i]).in())
+          a.ins[k++] = emap[e];
+      });
+
+      s.graph = compressed_type(std::move(a));
+      return s;
+    }
+
+  // Returns the vertex v stamped with the current generation of its slot.
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
+    inline auto
+    directed_adjacency_list<V, E, Pool, Index, Size>::stamp(vertex v) const -> stamped_vertex
+    {
+      return {v, verts_.generation(v)};
+    }
+
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
+    inline auto
+    directed_adjacency_list<V, E, Pool, Index, Size>::stamp(edge e) const -> stamped_edge
+    {
+      return {e, edges_.generation(e)};
+    }
+
+  // Returns the vertex referred to by the stamped handle v, or an invalid
+  // handle if that vertex has been removed.
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
+    inline auto
+    directed_adjacency_list<V, E, Pool, Index, Size>::resolve(stamped_vertex v) const -> vertex
+    {
+      vertex h = v.handle();
+      return h && stamp(h) == v ? h : vertex();
+    }
+
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
+    inline auto
+    directed_adjacency_list<V, E, Pool, Index, Size>::resolve(stamped_edge e) const -> edge
+    {
+      edge h = e.handle();
+      return h && stamp(h) == e ? h : edge();
+    }
+
+  // Returns the number of vertices, edges, and incident edges for which
+  // storage has been allocated.
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
+    auto
+    directed_adjacency_list<V, E, Pool, Index, Size>::capacity() const -> capacity_type
+    {
+      capacity_type c {verts_.capacity(), edges_.capacity(), 0};
+      for (const vertex_node& n : verts_)
+        c.incidence += n.out().capacity() + n.in().capacity();
+      return c;
     }
 
-  // Note that loops will not result in the double erasure of an edge. The
-  // edge is initially erased in unlink_source, and the erase operation
-  // here will have no effect.
-  template<typename V, typename E>
+  // Ensure that n vertices can be stored without reallocating the vertex
+  // set.
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline void
-    directed_adjacency_list<V, E>::unlink_source(edge e)
+    directed_adjacency_list<V, E, Pool, Index, Size>::reserve_vertices(std::size_t n)
     {
-      vertex_node& t = node(source(e));
-      auto i = find(t.out(), e);
-      t.out().erase(i);
-      edges_.erase(e);
+      verts_.reserve(n);
     }
 
+  // Ensure that m edges can be stored without reallocating the edge set.
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
+    inline void
+    directed_adjacency_list<V, E, Pool, Index, Size>::reserve_edges(std::size_t m)
+    {
+      edges_.reserve(m);
+      index_.reserve(m);
+    }
 
-  // Remove all edges from a graph, making it empty.
-  template<typename V, typename E>
+  // Ensure that the vertex v can have k out (or in) edges without
+  // reallocating its incidence list.
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
+    inline void
+    directed_adjacency_list<V, E, Pool, Index, Size>::reserve_out(vertex v, std::size_t k)
+    {
+      node(v).out().reserve(k);
+    }
+
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline void
-    directed_adjacency_list<V, E>::remove_edges()
+    directed_adjacency_list<V, E, Pool, Index, Size>::reserve_in(vertex v, std::size_t k)
+    {
+      node(v).in().reserve(k);
+    }
+
+  // Release unused storage in the vertex set, the edge set, the edge
+  // index, and every incidence list. The slots of removed vertices and
+  // edges are retained; compact the graph to release them.
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
+    void
+    directed_adjacency_list<V, E, Pool, Index, Size>::shrink_to_fit()
     {
       for (vertex_node& n : verts_) {
-        n.out().clear();
-        n.in().clear();
+        n.out().shrink_to_fit();
+        n.in().shrink_to_fit();
       }
-      edges_.clear();
+      verts_.shrink_to_fit();
+      edges_.shrink_to_fit();
+      index_.shrink_to_fit();
     }
 
   // Retrun a range over the vertex set.
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline auto
-    directed_adjacency_list<V, E>::vertices() const -> vertex_range
+    directed_adjacency_list<V, E, Pool, Index, Size>::vertices() const -> vertex_range
     {
       return {vertex_iter(verts_.begin()), vertex_iter(verts_.end())};
     }
 
   // Return a range over the edge set.
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline auto
-    directed_adjacency_list<V, E>::edges() const -> edge_range
+    directed_adjacency_list<V, E, Pool, Index, Size>::edges() const -> edge_range
     {
       return {edge_iter(edges_.begin()), edge_iter(edges_.end())};
     }
 
   // Return a range over the out edges of the vertex v.
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline auto
-    directed_adjacency_list<V, E>::out_edges(vertex v) const -> incidence_range
+    directed_adjacency_list<V, E, Pool, Index, Size>::out_edges(vertex v) const -> incidence_range
     {
       const vertex_node& vn = node(v);
       return {incidence_iter(vn.begin_out()), incidence_iter(vn.end_out())};
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline auto
-    directed_adjacency_list<V, E>::in_edges(vertex v) const -> incidence_range
+    directed_adjacency_list<V, E, Pool, Index, Size>::in_edges(vertex v) const -> incidence_range
     {
       const vertex_node& vn = node(v);
       return {incidence_iter(vn.begin_in()), incidence_iter(vn.end_in())};
@@ -744,17 +1362,19 @@ namespace origin
   {
     using origin::adjacency_list_impl::pool;
     using origin::adjacency_list_impl::handle_iterator;
-    using origin::adjacency_list_impl::edge_list;
+    using origin::adjacency_list_impl::basic_edge_list;
 
     // ---------------------------------------------------------------------- //
     //                        Vertex Representation
 
     // A vertex in an undirected adjacency list is simply a list of incident
     // edges. No distinction is made between in or out edges.
-    template<typename V>
+    template<typename V, typename S = std::size_t>
       struct vertex
       {
         using value_type = V;
+        using index_type = S;
+        using edge_list = basic_edge_list<S>;
         using iterator = typename edge_list::iterator;
         using const_iterator = typename edge_list::const_iterator;
 
@@ -779,7 +1399,6 @@ namespace origin
         std::size_t degree() const { return edges().size(); }
 
         void insert(std::size_t e);
-        void erase(std::size_t e);
 
         iterator begin() { return edges().begin(); }
         iterator end()   { return edges().end(); }
@@ -790,61 +1409,77 @@ namespace origin
         std::tuple<edge_list, V> data;
       };
 
-    template<typename V>
+    template<typename V, typename S>
       inline void
-      vertex<V>::insert(std::size_t e)
+      vertex<V, S>::insert(std::size_t e)
       {
         edges().push_back(e);
       }
 
-    template<typename V>
-      inline void
-      vertex<V>::erase(std::size_t e)
-      {
-        auto i = std::find(begin(), end(), e);
-        if (i != end())
-          edges().erase(i);
-      }
-
     // A vertex set is a pool of vertices.
-    template<typename V>
-      using vertex_pool = pool<vertex<V>>;
+    template<typename V, template<typename> class Pool = pool, typename S = std::size_t>
+      using vertex_pool = Pool<vertex<V, S>>;
 
     // An alias for the vertex iterator.
-    template<typename V>
-      using vertex_iterator = handle_iterator<vertex_pool<V>, vertex_handle>;
+    template<typename V, template<typename> class Pool = pool, typename S = std::size_t>
+      using vertex_iterator = handle_iterator<vertex_pool<V, Pool, S>, basic_vertex_handle<S>>;
 
     // An alias for the vertex range.
-    template<typename V>
-      using vertex_range = bounded_range<vertex_iterator<V>>;
+    template<typename V, template<typename> class Pool = pool, typename S = std::size_t>
+      using vertex_range = bounded_range<vertex_iterator<V, Pool, S>>;
 
   } // namespace undirected_adjacency_list_impl
 
 
   // Implementation of the undirected adjacency list.
-  template<typename V = empty_t, typename E = empty_t>
+  template<typename V = empty_t,
+           typename E = empty_t,
+           template<typename> class Pool = adjacency_list_impl::pool,
+           typename Index = adjacency_list_impl::linear_edge_index,
+           typename Size = std::size_t>
     class undirected_adjacency_list
     {
-      using this_type = undirected_adjacency_list<V, E>;
+      using this_type = undirected_adjacency_list<V, E, Pool, Index, Size>;
 
-      using vertex_node = undirected_adjacency_list_impl::vertex<V>;
-      using vertex_set = undirected_adjacency_list_impl::vertex_pool<V>;
-      using vertex_iter = undirected_adjacency_list_impl::vertex_iterator<V>;
+      using vertex_node = undirected_adjacency_list_impl::vertex<V, Size>;
+      using vertex_set = undirected_adjacency_list_impl::vertex_pool<V, Pool, Size>;
+      using vertex_iter = undirected_adjacency_list_impl::vertex_iterator<V, Pool, Size>;
 
-      using edge_node = adjacency_list_impl::edge<E>;
-      using edge_set = adjacency_list_impl::edge_pool<E>;
-      using edge_iter = adjacency_list_impl::edge_iterator<E>;
+      using edge_node = adjacency_list_impl::edge<E, Size>;
+      using edge_set = adjacency_list_impl::edge_pool<E, Pool, Size>;
+      using edge_iter = adjacency_list_impl::edge_iterator<E, Pool, Size>;
 
-      using incidence_iter = adjacency_list_impl::incidence_iterator;
+      using edge_list = adjacency_list_impl::basic_edge_list<Size>;
+      using incidence_iter = adjacency_list_impl::incidence_iterator<Size>;
     public:
-      using vertex = vertex_handle;
-      using vertex_range = undirected_adjacency_list_impl::vertex_range<V>;
+      using size_type = Size;
+
+      using vertex = basic_vertex_handle<Size>;
+      using vertex_range = undirected_adjacency_list_impl::vertex_range<V, Pool, Size>;
+
+      using edge = basic_edge_handle<Size>;
+      using edge_range = adjacency_list_impl::edge_range<E, Pool, Size>;
+
+      using incidence_range = adjacency_list_impl::incidence_range<Size>;
+
+      using capacity_type = adjacency_list_impl::graph_capacity;
+
+      using handle_map = adjacency_list_impl::handle_map;
 
-      using edge = edge_handle;
-      using edge_range = adjacency_list_impl::edge_range<E>;
+      using compressed_type = compressed_undirected_graph<V, E>;
+      using snapshot_type = adjacency_list_impl::snapshot<compressed_type>;
 
-      using incidence_range = adjacency_list_impl::incidence_range;
+      using stamped_vertex = generational_handle<vertex>;
+      using stamped_edge = generational_handle<edge>;
 
+      // Construction
+      undirected_adjacency_list() = default;
+
+      template<typename I>
+        undirected_adjacency_list(I first, I last, std::size_t n = 0);
+
+      template<typename I>
+        void assign_edges(I first, I last, std::size_t n = 0);
 
       // Observers
       bool        null() const  { return verts_.empty(); }
@@ -853,6 +1488,13 @@ namespace origin
       bool        empty() const { return edges_.empty(); }
       std::size_t size() const  { return edges_.size(); }
 
+      // Capacity
+      capacity_type capacity() const;
+      void reserve_vertices(std::size_t n);
+      void reserve_edges(std::size_t m);
+      void reserve_incident(vertex v, std::size_t k);
+      void shrink_to_fit();
+
       // Vertex observers
       std::size_t degree(vertex v) const { return node(v).degree(); }
 
@@ -885,6 +1527,12 @@ namespace origin
       void remove_vertex(vertex v);
       void remove_vertices();
 
+      template<typename R>
+        void remove_vertices(const R& range);
+
+      template<typename P>
+        void remove_vertices_if(P pred);
+
       // Edge set
       edge add_edge(vertex u, vertex v);
       edge add_edge(vertex u, vertex v, E&& x);
@@ -899,6 +1547,27 @@ namespace origin
       void remove_edges(vertex v);
       void remove_edges();
 
+      // Removal order
+      // By default, removing an edge may reorder the incidence lists of its
+      // endpoints. Preserving order makes removal linear in the degree.
+      void preserve_order(bool b)   { ordered_ = b; }
+      bool preserves_order() const  { return ordered_; }
+
+      // Maintenance
+      handle_map compact();
+
+      // Snapshots
+      snapshot_type snapshot() const;
+      snapshot_type freeze();
+
+      // Generational handles
+      // These are available only when Pool is a generational pool.
+      stamped_vertex stamp(vertex v) const;
+      stamped_edge   stamp(edge e) const;
+
+      vertex resolve(stamped_vertex v) const;
+      edge   resolve(stamped_edge e) const;
+
       // Iterators
       vertex_range    vertices() const;
       edge_range      edges() const;
@@ -917,30 +1586,34 @@ namespace origin
       template<typename S, typename P>
         edge find_endpoints(const S& seq, P pred) const;
 
+      void remove_batch(const std::vector<vertex>& vs);
+      snapshot_type make_snapshot() const;
       void link_edge(vertex u, vertex v, edge e);
-      void unlink_loop(vertex v, edge e);
-      void unlink_edge(vertex u, vertex v, edge e);
+      void unlink_edge(edge e);
+      void erase_edge(edge e);
       void unlink_first_loop(vertex v);
       void unlink_first_edge(vertex u, vertex v);
       void unlink_multi_loop(vertex v);
       void unlink_multi_edge(vertex u, vertex v);
+      void detach(vertex v, std::size_t p);
 
-      template<typename S, typename I>
-        void erase_loop(S& seq, I iter);
-
-      template<typename S, typename I>
-        void erase_edge(S& seq1, I iter1, S& seq2, I iter2);
+      template<typename P>
+        void unlink_matching(vertex v, P pred);
 
     private:
       vertex_set verts_;
       edge_set   edges_;
+      Index      index_;
+      bool       ordered_ = false;
     };
 
   // Returns true if the an edge {u, v} is in the graph.
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline auto
-    undirected_adjacency_list<V, E>::operator()(vertex u, vertex v) const -> edge
+    undirected_adjacency_list<V, E, Pool, Index, Size>::operator()(vertex u, vertex v) const -> edge
     {
+      if (Index::indexed)
+        return edge(index_.find(std::min(u, v), std::max(u, v)));
       if (degree(u) <= degree(v))
         return find_edge(u, v);
       else
@@ -953,9 +1626,9 @@ namespace origin
   // Note that, if u and v are connected, then the edge was added as either
   // (u, v) or (v, u). We prefer to search the vertex with the smaller degree
   // for evidence of either construction.
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline auto
-    undirected_adjacency_list<V, E>::find_edge(vertex u, vertex v) const -> edge
+    undirected_adjacency_list<V, E, Pool, Index, Size>::find_edge(vertex u, vertex v) const -> edge
     {
       using P = has_endpoints<this_type>;
       const vertex_node& n = node(v);
@@ -964,10 +1637,10 @@ namespace origin
 
   // Return an iterator to the the first incident edge whose end (either
   // source or target) is equal to v.
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     template<typename S, typename P>
       inline auto
-      undirected_adjacency_list<V, E>::
+      undirected_adjacency_list<V, E, Pool, Index, Size>::
         find_endpoints(const S& seq, P pred) const -> edge
       {
         auto i = find_if(seq, pred);
@@ -975,82 +1648,209 @@ namespace origin
       }
 
 
+  // Construct a graph from the input edges in [first, last), with at least
+  // n vertices. See assign_edges for details.
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
+    template<typename I>
+      inline
+      undirected_adjacency_list<V, E, Pool, Index, Size>::undirected_adjacency_list(I first, I last, std::size_t n)
+      {
+        assign_edges(first, last, n);
+      }
+
+  // Replace the contents of the graph with the input edges in [first, last).
+  // Each input edge is a pair (u, v) or a tuple (u, v, x), where x is the
+  // value of the edge. The graph has at least n vertices, and at least one
+  // more than the greatest endpoint. Vertex values are default constructed.
+  //
+  // The range is traversed twice. The first pass counts the degree of each
+  // vertex, so that the vertex set, the edge set, and every incidence list
+  // are allocated exactly once. The second pass adds the edges.
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
+    template<typename I>
+      void
+      undirected_adjacency_list<V, E, Pool, Index, Size>::assign_edges(I first, I last, std::size_t n)
+      {
+        adjacency_list_impl::degree_count c =
+          adjacency_list_impl::count_degrees(first, last, n);
+        remove_vertices();
+        verts_.reserve(c.order);
+        edges_.reserve(c.size);
+        index_.reserve(c.size);
+        for (std::size_t i = 0; i < c.order; ++i) {
+          vertex_node& vn = node(add_vertex());
+          vn.edges().reserve(c.out[i] + c.in[i]);
+        }
+        for ( ; first != last; ++first)
+          adjacency_list_impl::emplace_input(*this, *first);
+      }
+
   // Add a vertex to the graph, returning a handle to the new object. If
   // V is a user-supplied type, its value is default constructed.
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline auto
-    undirected_adjacency_list<V, E>::add_vertex() -> vertex
+    undirected_adjacency_list<V, E, Pool, Index, Size>::add_vertex() -> vertex
     {
       return verts_.emplace();
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline auto
-    undirected_adjacency_list<V, E>::add_vertex(V&& x) -> vertex
+    undirected_adjacency_list<V, E, Pool, Index, Size>::add_vertex(V&& x) -> vertex
     {
       return verts_.emplace(std::move(x));
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline auto
-    undirected_adjacency_list<V, E>::add_vertex(const V& x) -> vertex
+    undirected_adjacency_list<V, E, Pool, Index, Size>::add_vertex(const V& x) -> vertex
     {
       return verts_.emplace(x);
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     template<typename... Args>
       inline auto
-      undirected_adjacency_list<V, E>::emplace_vertex(Args&&... args) -> vertex
+      undirected_adjacency_list<V, E, Pool, Index, Size>::emplace_vertex(Args&&... args) -> vertex
       {
         return verts_.emplace(std::forward<Args>(args)...);
       }
 
 
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline void
-    undirected_adjacency_list<V, E>::remove_vertex(vertex v)
+    undirected_adjacency_list<V, E, Pool, Index, Size>::remove_vertex(vertex v)
     {
       remove_edges(v);
       verts_.erase(v);
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline void
-    undirected_adjacency_list<V, E>::remove_vertices()
+    undirected_adjacency_list<V, E, Pool, Index, Size>::remove_vertices()
     {
       edges_.clear();
+      index_.clear();
       verts_.clear();
     }
 
+  // Remove each vertex in range, and all of their incident edges. The
+  // range may contain duplicates.
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
+    template<typename R>
+      inline void
+      undirected_adjacency_list<V, E, Pool, Index, Size>::remove_vertices(const R& range)
+      {
+        std::vector<vertex> vs;
+        for (vertex v : range)
+          vs.push_back(v);
+        remove_batch(vs);
+      }
+
+  // Remove each vertex satisfying pred, and all of their incident edges.
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
+    template<typename P>
+      inline void
+      undirected_adjacency_list<V, E, Pool, Index, Size>::remove_vertices_if(P pred)
+      {
+        std::vector<vertex> vs;
+        for (vertex v : vertices())
+          if (pred(v))
+            vs.push_back(v);
+        remove_batch(vs);
+      }
+
+  // Remove the vertices in vs, and all of their incident edges. See
+  // directed_adjacency_list::remove_batch for details. Here, each doomed
+  // edge is collected from the list of its source at its source position,
+  // or from the list of its target when the source survives.
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
+    void
+    undirected_adjacency_list<V, E, Pool, Index, Size>::remove_batch(const std::vector<vertex>& vs)
+    {
+      using marks = adjacency_list_impl::vertex_marks;
+      marks m;
+      std::vector<vertex> doomed;
+      for (vertex v : vs) {
+        if (m.get(v) != marks::doomed) {
+          m.set(v, marks::doomed);
+          doomed.push_back(v);
+        }
+      }
+
+      // Find the surviving neighbors.
+      std::vector<vertex> affected;
+      for (vertex v : doomed) {
+        for (edge e : node(v).edges()) {
+          vertex u = source(e) == v ? target(e) : source(e);
+          if (m.get(u) == marks::none) {
+            m.set(u, marks::affected);
+            affected.push_back(u);
+          }
+        }
+      }
+
+      // Filter their incidence lists.
+      auto keep = [&](edge e) {
+        return m.get(source(e)) != marks::doomed
+            && m.get(target(e)) != marks::doomed;
+      };
+      for (vertex u : affected) {
+        auto fix = [this, u](edge e, std::size_t from, std::size_t to) {
+          edge_node& en = get_edge(e);
+          if (en.source() == u && en.source_pos() == from)
+            en.source_pos() = to;
+          else
+            en.target_pos() = to;
+        };
+        adjacency_list_impl::filter_incident(node(u).edges(), keep, fix);
+      }
+
+      // Erase the doomed edges and vertices.
+      std::vector<edge> dead;
+      for (vertex v : doomed) {
+        const edge_list& l = node(v).edges();
+        for (std::size_t i = 0; i < l.size(); ++i) {
+          const edge_node& en = get_edge(l[i]);
+          if (en.source() == v ? en.source_pos() == i
+                               : m.get(en.source()) != marks::doomed)
+            dead.push_back(l[i]);
+        }
+      }
+      for (edge e : dead)
+        erase_edge(e);
+      for (vertex v : doomed)
+        verts_.erase(v);
+    }
+
   // Add a defaul edge from u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline auto
-    undirected_adjacency_list<V, E>::add_edge(vertex u, vertex v) -> edge
+    undirected_adjacency_list<V, E, Pool, Index, Size>::add_edge(vertex u, vertex v) -> edge
     {
       return emplace_edge(u, v);
     }
 
   // Move x into an edge connecting u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline auto
-    undirected_adjacency_list<V, E>::add_edge(vertex u, vertex v, E&& x) -> edge
+    undirected_adjacency_list<V, E, Pool, Index, Size>::add_edge(vertex u, vertex v, E&& x) -> edge
     {
       return emplace_edge(u, v, std::move(x));
     }
 
   // Copy x into an edge connecting u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline auto
-    undirected_adjacency_list<V, E>::add_edge(vertex u, vertex v, const E& x) -> edge
+    undirected_adjacency_list<V, E, Pool, Index, Size>::add_edge(vertex u, vertex v, const E& x) -> edge
     {
       return emplace_edge(u, v, x);
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     template<typename... Args>
       inline auto
-      undirected_adjacency_list<V, E>::
+      undirected_adjacency_list<V, E, Pool, Index, Size>::
         emplace_edge(vertex u, vertex v, Args&&... args) -> edge
       {
         edge e = edges_.emplace(u, v, std::forward<Args>(args)...);
@@ -1058,84 +1858,90 @@ namespace origin
         return e;
       }
 
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline void
-    undirected_adjacency_list<V, E>::link_edge(vertex u, vertex v, edge e)
+    undirected_adjacency_list<V, E, Pool, Index, Size>::link_edge(vertex u, vertex v, edge e)
     {
+      edge_node& en = get_edge(e);
       vertex_node& un = node(u);
-      vertex_node& vn = node(v);
+      en.source_pos() = un.degree();
       un.insert(e);
+      vertex_node& vn = node(v);
+      en.target_pos() = vn.degree();
       vn.insert(e);
+      index_.insert(std::min(u, v), std::max(u, v), e);
     }
 
   // Remove the specified edge from the graph.
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline void
-    undirected_adjacency_list<V, E>::remove_edge(edge e)
+    undirected_adjacency_list<V, E, Pool, Index, Size>::remove_edge(edge e)
     {
-      vertex u = source(e);
-      vertex v = target(e);
-      if (u == v)
-        unlink_loop(u, e);
-      else
-        unlink_edge(u, v, e);
+      unlink_edge(e);
     }
 
-  // Unlink the given edge from the vertex, when the edge is looped.
-  template<typename V, typename E>
+  // Unlink the given edge from the incidence lists of its endpoints, and
+  // erase it from the edge set.
+  //
+  // A loop appears twice in the incidence list of its vertex. The later
+  // position is detached first so that the earlier one is not disturbed.
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline void
-    undirected_adjacency_list<V, E>::unlink_loop(vertex v, edge e)
+    undirected_adjacency_list<V, E, Pool, Index, Size>::unlink_edge(edge e)
     {
-      vertex_node& n = node(v);
-      auto i = find(n.edges(), e);
-      if (i != n.end())
-        erase_loop(n.edges(), i);
-    }
-
-  // Erase the loop edge referred to by the edge list iterator i.
-  template<typename V, typename E>
-    template<typename S, typename I>
-      inline void
-      undirected_adjacency_list<V, E>::erase_loop(S& seq, I iter)
-      {
-        edges_.erase(*iter);
-        seq.erase(iter, std::next(iter, 2));
+      const edge_node& en = get_edge(e);
+      vertex u = en.source();
+      vertex v = en.target();
+      std::size_t i = en.source_pos();
+      std::size_t j = en.target_pos();
+      if (u == v && i < j) {
+        detach(v, j);
+        detach(u, i);
+      } else {
+        detach(u, i);
+        detach(v, j);
       }
+      erase_edge(e);
+    }
 
-  // Unlink the given edge from the source and target vertices, and erase
-  // it from the edge set.
-  template<typename V, typename E>
+  // Erase the edge e from the edge set and the edge index. The endpoints of
+  // an edge are indexed in increasing order.
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline void
-    undirected_adjacency_list<V, E>::unlink_edge(vertex u, vertex v, edge e)
+    undirected_adjacency_list<V, E, Pool, Index, Size>::erase_edge(edge e)
     {
-      vertex_node& un = node(u);
-      vertex_node& vn = node(v);
-
-      // Find the edge in the corresponding edge lists, and then erase them.
-      auto i = find(un.edges(), e);
-      auto j = find(vn.edges(), e);
-      if (i != un.end())
-        erase_edge(un.edges(), i, vn.edges(), j);
+      vertex u = source(e);
+      vertex v = target(e);
+      index_.erase(std::min(u, v), std::max(u, v), e);
+      edges_.erase(e);
     }
 
-  // Erase the edge e from the graph by removing the endpoints and the edge
-  // object.
-  template<typename V, typename E>
-    template<typename S, typename I>
-      inline void
-      undirected_adjacency_list<V, E>::erase_edge(S& seq1, I iter1, S& seq2, I iter2)
-        {
-          edges_.erase(*iter1);
-          seq1.erase(iter1);
-          seq2.erase(iter2);
-        }
+  // Erase the pth incident edge of v, updating the recorded position of any
+  // edge moved by the erasure. For a loop, the position being moved is the
+  // one that matches its old position.
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
+    inline void
+    undirected_adjacency_list<V, E, Pool, Index, Size>::detach(vertex v, std::size_t p)
+    {
+      auto fix = [this, v](edge f, std::size_t from, std::size_t to) {
+        edge_node& fn = get_edge(f);
+        if (fn.source() == v && fn.source_pos() == from)
+          fn.source_pos() = to;
+        else
+          fn.target_pos() = to;
+      };
+      adjacency_list_impl::erase_incident(node(v).edges(), p, ordered_, fix);
+    }
 
   // Remove the first edge connecting u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline void
-    undirected_adjacency_list<V, E>::remove_edge(vertex u, vertex v)
+    undirected_adjacency_list<V, E, Pool, Index, Size>::remove_edge(vertex u, vertex v)
     {
-      if (u == v)
+      if (Index::indexed) {
+        if (edge e = (*this)(u, v))
+          unlink_edge(e);
+      } else if (u == v)
         unlink_first_loop(v);
       else if (degree(u) <= degree(v))
         unlink_first_edge(u, v);
@@ -1144,141 +1950,352 @@ namespace origin
     }
 
   // Find and remove the first loop connecting v to itself.
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline void
-    undirected_adjacency_list<V, E>::unlink_first_loop(vertex v)
+    undirected_adjacency_list<V, E, Pool, Index, Size>::unlink_first_loop(vertex v)
     {
-      using P = has_endpoint<this_type>;
+      using P = is_looped<this_type>;
       vertex_node& n = node(v);
       auto i = find_if(n.edges(), P(*this, v));
       if (i != n.end())
-        erase_loop(n.edges(), i);
+        unlink_edge(*i);
     }
 
   // Find and remove the first edge connecting u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline void
-    undirected_adjacency_list<V, E>::unlink_first_edge(vertex u, vertex v)
+    undirected_adjacency_list<V, E, Pool, Index, Size>::unlink_first_edge(vertex u, vertex v)
     {
       using P = has_endpoints<this_type>;
       vertex_node& un = node(u);
-      vertex_node& vn = node(v);
-
-      // Find the first edge with u and v as endpoints. If we didn't find
-      // it, just return.
       auto i = find_if(un.edges(), P(*this, u, v));
-      if (i == un.end())
-        return;
-
-      // Find the corresponding edge in v's list. Note that *i must exist
-      // in the incidence list of vn, otherwise, the graph is ill-formed.
-      auto j = find(vn.begin(), vn.end(), *i);
-      assert(j != vn.end());
-      erase_edge(un.edges(), i, vn.edges(), j);
+      if (i != un.end())
+        unlink_edge(*i);
     }
 
   // Remove all edges connecting u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline void
-    undirected_adjacency_list<V, E>::remove_edges(vertex u, vertex v)
+    undirected_adjacency_list<V, E, Pool, Index, Size>::remove_edges(vertex u, vertex v)
     {
-      if (u == v)
+      if (Index::indexed) {
+        while (edge e = (*this)(u, v))
+          unlink_edge(e);
+      } else if (u == v)
         unlink_multi_loop(u);
       else
         unlink_multi_edge(u, v);
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline void
-    undirected_adjacency_list<V, E>::unlink_multi_loop(vertex v)
+    undirected_adjacency_list<V, E, Pool, Index, Size>::unlink_multi_loop(vertex v)
     {
       using P = is_looped<this_type>;
-      vertex_node& n = node(v);
-      auto i = partition(n, negate(P(*this, v)));
-      for (auto j = i; j != n.end(); advance(j, 2))
-        edges_.erase(*j);
-      n.edges().erase(i, n.end());
+      unlink_matching(v, P(*this, v));
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline void
-    undirected_adjacency_list<V, E>::unlink_multi_edge(vertex u, vertex v)
+    undirected_adjacency_list<V, E, Pool, Index, Size>::unlink_multi_edge(vertex u, vertex v)
     {
       using P = has_endpoints<this_type>;
-      vertex_node& un = node(u);
-      vertex_node& vn = node(v);
-
-      auto i = partition(un.edges(), negate(P(*this, u, v)));
-      auto j = partition(vn.edges(), negate(P(*this, v, u)));
-      for (auto k = i; k != un.end(); ++k)
-        edges_.erase(*k);
-      un.edges().erase(i, un.end());
-      vn.edges().erase(j, vn.end());
+      if (degree(u) <= degree(v))
+        unlink_matching(u, P(*this, u, v));
+      else
+        unlink_matching(v, P(*this, v, u));
     }
 
+  // Remove all edges incident to v that satisfy pred.
+  //
+  // The incidence list is scanned from back to front. Erasing an edge only
+  // moves handles that have already been visited, except when the second
+  // position of a loop is erased; that can move an unvisited handle to an
+  // earlier position, where it is still visited. The index is clamped
+  // since erasing a loop shrinks the list by two.
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
+    template<typename P>
+      inline void
+      undirected_adjacency_list<V, E, Pool, Index, Size>::unlink_matching(vertex v, P pred)
+      {
+        const edge_list& l = node(v).edges();
+        for (std::size_t i = l.size(); i != 0; --i) {
+          i = std::min(i, l.size());
+          if (i == 0)
+            break;
+          edge e = l[i - 1];
+          if (pred(e))
+            unlink_edge(e);
+        }
+      }
+
 
   // Remove all edges incident to the vertex v.
-  template<typename V, typename E>
+  //
+  // Each edge is detached from the incidence list of its opposite endpoint.
+  // A loop appears twice in the list of v, so it is erased when its later
+  // position is reached.
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline void
-    undirected_adjacency_list<V, E>::remove_edges(vertex v)
+    undirected_adjacency_list<V, E, Pool, Index, Size>::remove_edges(vertex v)
     {
-      vertex_node& vn = node(v);
-
-      // Clear the incident edges by removing each edge from the incidence
-      // list of its corresponding endpoint. Handle loops differenty.
-      //
-      // TODO: This looks a little dense. It's also a little inefficient
-      // in the case of multigraphs. Ideally, we should find the set of
-      // edges connecting u to v and erase those in a single block.
-      auto i = vn.begin();
-      while (i != vn.end()) {
-        if (is_loop(*this, *i)) {
-          edges_.erase(*i);
-          std::advance(i, 2);
+      edge_list& l = node(v).edges();
+      for (std::size_t i = 0; i < l.size(); ++i) {
+        edge e = l[i];
+        const edge_node& en = get_edge(e);
+        if (en.source() == en.target()) {
+          if (i == std::max(en.source_pos(), en.target_pos()))
+            erase_edge(e);
         } else {
-          vertex_node& n = node(opposite(*this, *i, v));
-          auto j = find(n.edges(), *i);
-          if (j != n.end()) {
-            n.edges().erase(j);
-            edges_.erase(*i);
-          }
-          ++i;
+          if (en.source() == v)
+            detach(en.target(), en.target_pos());
+          else
+            detach(en.source(), en.source_pos());
+          erase_edge(e);
         }
       }
-      vn.edges().clear();
+      l.clear();
     }
 
 
   // Remove all edges from a graph, making it empty.
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline void
-    undirected_adjacency_list<V, E>::remove_edges()
+    undirected_adjacency_list<V, E, Pool, Index, Size>::remove_edges()
     {
       for (vertex_node& n : verts_)
         n.edges().clear();
       edges_.clear();
+      index_.clear();
+    }
+
+  // Compact the vertex and edge sets so that their handles are dense. See
+  // directed_adjacency_list::compact for details.
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
+    auto
+    undirected_adjacency_list<V, E, Pool, Index, Size>::compact() -> handle_map
+    {
+      handle_map map {verts_.compact(), edges_.compact()};
+      index_.clear();
+      for (auto i = edges_.begin(); i != edges_.end(); ++i) {
+        edge_node& e = *i;
+        e.source() = map.vertices[e.source()];
+        e.target() = map.vertices[e.target()];
+        index_.insert(std::min(e.source(), e.target()),
+                      std::max(e.source(), e.target()),
+                      i.index());
+      }
+      for (vertex_node& v : verts_)
+        adjacency_list_impl::remap_edges(v.edges(), map.edges);
+      return map;
+    }
+
+  // Returns a compressed snapshot of the graph. See
+  // directed_adjacency_list::snapshot for details.
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
+    auto
+    undirected_adjacency_list<V, E, Pool, Index, Size>::snapshot() const -> snapshot_type
+    {
+      snapshot_type s = make_snapshot();
+      const std::vector<std::size_t>& verts = s.original.vertices;
+      const std::vector<std::size_t>& edges = s.original.edges;
+      parallel_for(verts.size(), [&](std::size_t i) {
+        s.graph(vertex_handle(i)) = node(verts[i]).value();
+      });
+      parallel_for(edges.size(), [&](std::size_t i) {
+        s.graph(edge_handle(i)) = get_edge(edges[i]).value();
+      });
+      return s;
+    }
+
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
+    auto
+    undirected_adjacency_list<V, E, Pool, Index, Size>::freeze() -> snapshot_type
+    {
+      snapshot_type s = make_snapshot();
+      const std::vector<std::size_t>& verts = s.original.vertices;
+      const std::vector<std::size_t>& edges = s.original.edges;
+      parallel_for(verts.size(), [&](std::size_t i) {
+        s.graph(vertex_handle(i)) = std::move(node(verts[i]).value());
+      });
+      parallel_for(edges.size(), [&](std::size_t i) {
+        s.graph(edge_handle(i)) = std::move(get_edge(edges[i]).value());
+      });
+      remove_vertices();
+      return s;
+    }
+
+  // Build the structure of a snapshot. Each edge is numbered by the vertex
+  // that owns it: its source, at the position recorded for the source. This
+  // counts a loop once, although it appears twice in the incidence list.
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
+    auto
+    undirected_adjacency_list<V, E, Pool, Index, Size>::make_snapshot() const -> snapshot_type
+    {
+      snapshot_type s;
+      adjacency_list_impl::number_vertices(*this, s);
+      const std::vector<std::size_t>& verts = s.original.vertices;
+      const std::vector<std::size_t>& vmap = s.dense.vertices;
+      std::size_t n = verts.size();
+
+      // Returns true if the p-th incident edge of v is owned by v.
+      auto owns = [this](vertex v, std::size_t p, edge e) {
+        const edge_node& en = get_edge(e);
+        return en.source() == v && en.source_pos() == p;
+      };
+
+      typename compressed_type::arrays a;
+      std::vector<std::size_t> owned(n + 1, 0);
+      a.off.resize(n + 1, 0);
+      parallel_for(n, [&](std::size_t i) {
+        const edge_list& l = node(verts[i]).edges();
+        a.off[i] = l.size();
+        for (std::size_t p = 0; p < l.size(); ++p)
+          owned[i] += owns(verts[i], p, l[p]);
+      });
+      compressed_graph_impl::prefix_sum(a.off);
+      compressed_graph_impl::prefix_sum(owned);
+
+      // Number the edges and record their endpoints.
+      std::size_t m = owned[n];
+      s.original.edges.resize(m);
+      a.ends.resize(m);
+      parallel_for(n, [&](std::size_t i) {
+        const edge_list& l = node(verts[i]).edges();
+        std::size_t k = owned[i];
+        for (std::size_t p = 0; p < l.size(); ++p) {
+          if (owns(verts[i], p, l[p])) {
+            const edge_node& en = get_edge(l[p]);
+            s.original.edges[k] = l[p];
+            a.ends[k] = {vmap[en.source()], vmap[en.target()]};
+            ++k;
+          }
+        }
+      });
+      s.dense.edges = adjacency_list_impl::invert_handles(s.original.edges);
+
+      // Translate the incidence lists, and record the neighbor reached by
+      // each incident edge.
+      const std::vector<std::size_t>& emap = s.dense.edges;
+      a.inc.resize(a.off[n]);
+      a.adj.resize(a.off[n]);
+      parallel_for(n, [&](std::size_t i) {
+        std::size_t k = a.off[i];
+        for (edge e : node(verts[i]).edges()) {
+          const edge_node& en = get_edge(e);
+          vertex v = en.source() == verts[i] ? en.target() : en.source();
+          a.adj[k] = vmap[v];
+          a.inc[k++] = emap[e];
+        }
+      });
+
+      s.graph = compressed_type(std::move(a));
+      return s;
+    }
+
+  // Generational handles. See directed_adjacency_list for details.
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
+    inline auto
+    undirected_adjacency_list<V, E, Pool, Index, Size>::stamp(vertex v) const -> stamped_vertex
+    {
+      return {v, verts_.generation(v)};
+    }
+
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
+    inline auto
+    undirected_adjacency_list<V, E, Pool, Index, Size>::stamp(edge e) const -> stamped_edge
+    {
+      return {e, edges_.generation(e)};
+    }
+
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
+    inline auto
+    undirected_adjacency_list<V, E, Pool, Index, Size>::resolve(stamped_vertex v) const -> vertex
+    {
+      vertex h = v.handle();
+      return h && stamp(h) == v ? h : vertex();
+    }
+
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
+    inline auto
+    undirected_adjacency_list<V, E, Pool, Index, Size>::resolve(stamped_edge e) const -> edge
+    {
+      edge h = e.handle();
+      return h && stamp(h) == e ? h : edge();
+    }
+
+  // Returns the number of vertices, edges, and incident edges for which
+  // storage has been allocated.
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
+    auto
+    undirected_adjacency_list<V, E, Pool, Index, Size>::capacity() const -> capacity_type
+    {
+      capacity_type c {verts_.capacity(), edges_.capacity(), 0};
+      for (const vertex_node& n : verts_)
+        c.incidence += n.edges().capacity();
+      return c;
+    }
+
+  // Ensure that n vertices can be stored without reallocating the vertex
+  // set.
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
+    inline void
+    undirected_adjacency_list<V, E, Pool, Index, Size>::reserve_vertices(std::size_t n)
+    {
+      verts_.reserve(n);
+    }
+
+  // Ensure that m edges can be stored without reallocating the edge set.
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
+    inline void
+    undirected_adjacency_list<V, E, Pool, Index, Size>::reserve_edges(std::size_t m)
+    {
+      edges_.reserve(m);
+      index_.reserve(m);
+    }
+
+  // Ensure that the vertex v can have k incident edges without reallocating
+  // its incidence list. A loop counts twice.
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
+    inline void
+    undirected_adjacency_list<V, E, Pool, Index, Size>::reserve_incident(vertex v, std::size_t k)
+    {
+      node(v).edges().reserve(k);
+    }
+
+  // Release unused storage. See directed_adjacency_list::shrink_to_fit.
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
+    void
+    undirected_adjacency_list<V, E, Pool, Index, Size>::shrink_to_fit()
+    {
+      for (vertex_node& n : verts_) {
+        n.edges().shrink_to_fit();
+      }
+      verts_.shrink_to_fit();
+      edges_.shrink_to_fit();
+      index_.shrink_to_fit();
     }
 
   // Retrun a range over the vertex set.
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline auto
-    undirected_adjacency_list<V, E>::vertices() const -> vertex_range
+    undirected_adjacency_list<V, E, Pool, Index, Size>::vertices() const -> vertex_range
     {
       return {vertex_iter(verts_.begin()), vertex_iter(verts_.end())};
     }
 
   // Return a range over the edge set.
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline auto
-    undirected_adjacency_list<V, E>::edges() const -> edge_range
+    undirected_adjacency_list<V, E, Pool, Index, Size>::edges() const -> edge_range
     {
       return {edge_iter(edges_.begin()), edge_iter(edges_.end())};
     }
 
   // Return a range over the out edges of the vertex v.
-  template<typename V, typename E>
+  template<typename V, typename E, template<typename> class Pool, typename Index, typename Size>
     inline auto
-    undirected_adjacency_list<V, E>::edges(vertex v) const -> incidence_range
+    undirected_adjacency_list<V, E, Pool, Index, Size>::edges(vertex v) const -> incidence_range
     {
       const vertex_node& vn = node(v);
       return {incidence_iter(vn.begin()), incidence_iter(vn.end())};
@@ -0,0 +1,201 @@
+// Copyright (c) 2009-2015 Andrew Sutton
+// All rights reserved
+
+#ifndef ORIGIN_GRAPH_ADJACENCY_LIST_IMPL_BITMAP_HPP
+#define ORIGIN_GRAPH_ADJACENCY_LIST_IMPL_BITMAP_HPP
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace origin
+{
+  namespace adjacency_list_impl
+  {
+    // ---------------------------------------------------------------------- //
+    //                            Free Index Set
+    //
+    // The free index set records the erased (free) indexes of a pool. It is
+    // a hierarchical bitmap: level 0 stores one bit per index, and each bit
+    // in level k + 1 summarizes whether the corresponding 64-bit word in
+    // level k has any bits set. The top level always consists of a single
+    // word.
+    //
+    // Finding the least free index is done by descending from the top level,
+    // selecting the lowest set bit in each word (count trailing zeros). This
+    // preserves the "least index first" property of the min-queue that the
+    // set replaces, but without the sift operations or the storage of a full
+    // index per free slot.
+    //
+    // Performance properties:
+    //    - Insertion: O(log64 n)
+    //    - Erasure: O(log64 n)
+    //    - Least element: O(log64 n)
+    // Where n is the largest index ever inserted. For any pool that fits in
+    // memory, that is at most 6 levels.
+    class free_index_set
+    {
+    public:
+      using word_type = std::uint64_t;
+      using word_list = std::vector<word_type>;
+
+      static constexpr std::size_t npos = -1;
+      static constexpr std::size_t bits = 64;
+
+      free_index_set();
+
+      // Observers
+      bool empty() const { return count_ == 0; }
+      std::size_t size() const { return count_; }
+
+      bool contains(std::size_t n) const;
+
+      // Returns the least index in the set, or npos if the set is empty.
+      std::size_t front() const;
+
+      // Insert and erase
+      void insert(std::size_t n);
+      void erase(std::size_t n);
+      std::size_t take();
+      void clear();
+
+      // Debugging and Testing
+      // Returns the words of the given level of the bitmap.
+      const word_list& level(std::size_t k) const { return levels_[k]; }
+      std::size_t depth() const { return levels_.size(); }
+
+    private:
+      static word_type bit(std::size_t n) { return word_type(1) << (n % bits); }
+      static std::size_t lsb(word_type w) { return __builtin_ctzll(w); }
+
+      void grow(std::size_t n);
+      void summarize(std::size_t k);
+
+    private:
+      std::vector<word_list> levels_; // Level 0 is the leaf level
+      std::size_t count_;             // The number of free indexes
+    };
+
+    inline
+    free_index_set::free_index_set()
+      : levels_(), count_(0)
+    { }
+
+    // Returns true if the index n is in the set.
+    inline bool
+    free_index_set::contains(std::size_t n) const
+    {
+      if (levels_.empty() || n / bits >= levels_[0].size())
+        return false;
+      return levels_[0][n / bits] & bit(n);
+    }
+
+    // Descend from the top of the hierarchy, selecting the least non-empty
+    // word at each level.
+    inline std::size_t
+    free_index_set::front() const
+    {
+      if (empty())
+        return npos;
+      std::size_t n = 0;
+      for (std::size_t k = levels_.size(); k != 0; --k) {
+        word_type w = levels_[k - 1][n];
+        assert(w != 0);
+        n = n * bits + lsb(w);
+      }
+      return n;
+    }
+
+    // Add the index n to the set. The index must not already be in the set.
+    //
+    // Bits are propagated upwards only while the word being modified was
+    // previously empty; otherwise the higher levels already record it.
+    inline void
+    free_index_set::insert(std::size_t n)
+    {
+      assert(!contains(n));
+      if (levels_.empty() || n / bits >= levels_[0].size())
+        grow(n);
+      for (word_list& l : levels_) {
+        word_type& w = l[n / bits];
+        bool was_empty = (w == 0);
+        w |= bit(n);
+        if (!was_empty)
+          break;
+        n /= bits;
+      }
+      ++count_;
+    }
+
+    // Remove the index n from the set. The index must be in the set.
+    inline void
+    free_index_set::erase(std::size_t n)
+    {
+      assert(contains(n));
+      for (word_list& l : levels_) {
+        word_type& w = l[n / bits];
+        w &= ~bit(n);
+        if (w != 0)
+          break;
+        n /= bits;
+      }
+      --count_;
+    }
+
+    // Remove and return the least index in the set.
+    inline std::size_t
+    free_index_set::take()
+    {
+      std::size_t n = front();
+      erase(n);
+      return n;
+    }
+
+    // Remove all indexes from the set. Note that this releases the storage
+    // for the bitmap; it is not worth preserving.
+    inline void
+    free_index_set::clear()
+    {
+      levels_.clear();
+      count_ = 0;
+    }
+
+    // Extend the bitmap so that the index n can be stored. Every level is
+    // widened to summarize the level below it. New words are all zero, so
+    // existing summaries remain valid. When a new top level is created, it
+    // must be initialized from the (previous) top.
+    inline void
+    free_index_set::grow(std::size_t n)
+    {
+      std::size_t words = n / bits + 1;
+      for (std::size_t k = 0; ; ++k) {
+        bool fresh = (k == levels_.size());
+        if (fresh)
+          levels_.emplace_back();
+        word_list& l = levels_[k];
+        if (l.size() < words)
+          l.resize(words, 0);
+        if (fresh && k != 0)
+          summarize(k);
+        if (l.size() == 1)
+          break;
+        words = (l.size() + bits - 1) / bits;
+      }
+    }
+
+    // Set the bits of level k from the non-empty words of level k - 1.
+    inline void
+    free_index_set::summarize(std::size_t k)
+    {
+      const word_list& src = levels_[k - 1];
+      word_list& dst = levels_[k];
+      for (std::size_t i = 0; i < src.size(); ++i) {
+        if (src[i])
+          dst[i / bits] |= bit(i);
+      }
+    }
+
+  } // namespace adjacency_list_impl
+} // namespace origin
+
+#endif
@@ -0,0 +1,29 @@
+// Copyright (c) 2009-2015 Andrew Sutton
+// All rights reserved
+
+#ifndef ORIGIN_GRAPH_ADJACENCY_LIST_IMPL_CAPACITY_HPP
+#define ORIGIN_GRAPH_ADJACENCY_LIST_IMPL_CAPACITY_HPP
+
+#include <cstddef>
+
+namespace origin
+{
+  namespace adjacency_list_impl
+  {
+    // ---------------------------------------------------------------------- //
+    //                             Graph Capacity
+    //
+    // A graph capacity reports the number of objects for which storage has
+    // been allocated in a graph. The incidence capacity is the total over
+    // all incidence lists, including any inline storage.
+    struct graph_capacity
+    {
+      std::size_t vertices;
+      std::size_t edges;
+      std::size_t incidence;
+    };
+
+  } // namespace adjacency_list_impl
+} // namespace origin
+
+#endif
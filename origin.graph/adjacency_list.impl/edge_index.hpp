@@ -0,0 +1,245 @@
+// Copyright (c) 2009-2015 Andrew Sutton
+// All rights reserved
+
+#ifndef ORIGIN_GRAPH_ADJACENCY_LIST_IMPL_EDGE_INDEX_HPP
+#define ORIGIN_GRAPH_ADJACENCY_LIST_IMPL_EDGE_INDEX_HPP
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace origin
+{
+  namespace adjacency_list_impl
+  {
+    // ---------------------------------------------------------------------- //
+    //                              Edge Indexes
+    //
+    // An edge index maps a pair of vertex indexes (u, v) to an edge
+    // connecting them. It is a policy of the adjacency lists, which use it
+    // to find edges by their endpoints. Every edge index has the following
+    // interface:
+    //
+    //    indexed          True if the index supports lookup
+    //    find(u, v)       Returns an edge connecting u to v, or npos
+    //    insert(u, v, e)  Records the edge e connecting u to v
+    //    erase(u, v, e)   Forgets the edge e connecting u to v
+    //    clear()          Forgets all edges
+    //    reserve(n)       Prepares the index to hold n edges
+    //    shrink_to_fit()  Releases unused storage
+    //
+    // The graph is responsible for presenting the endpoints of an undirected
+    // edge in a canonical order.
+
+
+    // ---------------------------------------------------------------------- //
+    //                              Linear Index
+    //
+    // The linear index stores nothing. When a graph uses it, edges are found
+    // by searching the incidence lists of their endpoints, which takes time
+    // linear in the degree of the smaller endpoint.
+    struct linear_edge_index
+    {
+      static constexpr bool indexed = false;
+      static constexpr std::size_t npos = -1;
+
+      std::size_t find(std::size_t, std::size_t) const { return npos; }
+
+      void insert(std::size_t, std::size_t, std::size_t) { }
+      void erase(std::size_t, std::size_t, std::size_t) { }
+      void clear() { }
+      void reserve(std::size_t) { }
+      void shrink_to_fit() { }
+    };
+
+
+    // ---------------------------------------------------------------------- //
+    //                               Hash Index
+    //
+    // The hash index is an open-addressed hash table with linear probing,
+    // keyed on the endpoints of each edge. Each edge occupies one slot, so
+    // parallel edges occupy several slots with the same key; find returns
+    // the first of them in probe order. Erasure uses backward shifting
+    // rather than tombstones, so probe sequences never lengthen over time.
+    //
+    // The table holds at most half as many edges as it has slots.
+    //
+    // Performance properties:
+    //    - Find: O(1) expected
+    //    - Insertion: O(1) expected, amortized
+    //    - Erasure: O(1) expected
+    class hash_edge_index
+    {
+    public:
+      static constexpr bool indexed = true;
+      static constexpr std::size_t npos = -1;
+
+      hash_edge_index();
+
+      // Observers
+      bool empty() const { return count_ == 0; }
+      std::size_t size() const { return count_; }
+
+      // Capacity
+      std::size_t capacity() const { return slots_.size() / 2; }
+      void reserve(std::size_t n);
+      void shrink_to_fit();
+
+      // Lookup
+      std::size_t find(std::size_t u, std::size_t v) const;
+
+      // Insert and erase
+      void insert(std::size_t u, std::size_t v, std::size_t e);
+      void erase(std::size_t u, std::size_t v, std::size_t e);
+      void clear();
+
+    private:
+      struct slot
+      {
+        bool empty() const { return e == npos; }
+
+        std::size_t u;
+        std::size_t v;
+        std::size_t e;
+      };
+
+      static std::size_t hash(std::size_t u, std::size_t v);
+
+      std::size_t home(const slot& s) const { return hash(s.u, s.v) & mask(); }
+      std::size_t mask() const { return slots_.size() - 1; }
+
+      void rehash(std::size_t n);
+
+    private:
+      std::vector<slot> slots_; // Size is zero or a power of two
+      std::size_t count_;       // The number of edges
+    };
+
+    inline
+    hash_edge_index::hash_edge_index()
+      : slots_(), count_(0)
+    { }
+
+    // Combine the endpoints and apply the finalizer of splitmix64. The
+    // finalizer mixes every input bit into the low bits used for probing.
+    inline std::size_t
+    hash_edge_index::hash(std::size_t u, std::size_t v)
+    {
+      std::uint64_t x = std::uint64_t(u) * 0x9e3779b97f4a7c15ull ^ v;
+      x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+      x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+      return x ^ (x >> 31);
+    }
+
+    // Ensure that n edges can be stored without rehashing.
+    inline void
+    hash_edge_index::reserve(std::size_t n)
+    {
+      if (n > capacity()) {
+        std::size_t k = 16;
+        while (k / 2 < n)
+          k *= 2;
+        rehash(k);
+      }
+    }
+
+    // Rehash into the smallest table that holds the current edges.
+    inline void
+    hash_edge_index::shrink_to_fit()
+    {
+      if (count_ == 0) {
+        slots_ = std::vector<slot>();
+        return;
+      }
+      std::size_t k = 16;
+      while (k / 2 < count_)
+        k *= 2;
+      if (k < slots_.size())
+        rehash(k);
+    }
+
+    inline std::size_t
+    hash_edge_index::find(std::size_t u, std::size_t v) const
+    {
+      if (slots_.empty())
+        return npos;
+      for (std::size_t i = hash(u, v) & mask(); ; i = (i + 1) & mask()) {
+        const slot& s = slots_[i];
+        if (s.empty())
+          return npos;
+        if (s.u == u && s.v == v)
+          return s.e;
+      }
+    }
+
+    inline void
+    hash_edge_index::insert(std::size_t u, std::size_t v, std::size_t e)
+    {
+      assert(e != npos);
+      if (count_ + 1 > capacity())
+        rehash(slots_.empty() ? 16 : 2 * slots_.size());
+      std::size_t i = hash(u, v) & mask();
+      while (!slots_[i].empty())
+        i = (i + 1) & mask();
+      slots_[i] = {u, v, e};
+      ++count_;
+    }
+
+    // Remove the slot for the edge e. If e is not in the index, do nothing.
+    //
+    // After the slot is vacated, each following slot in the cluster is moved
+    // back into the hole unless its home lies cyclically within (hole, j].
+    inline void
+    hash_edge_index::erase(std::size_t u, std::size_t v, std::size_t e)
+    {
+      if (slots_.empty())
+        return;
+      std::size_t i = hash(u, v) & mask();
+      for ( ; ; i = (i + 1) & mask()) {
+        const slot& s = slots_[i];
+        if (s.empty())
+          return;
+        if (s.e == e)
+          break;
+      }
+      for (std::size_t j = (i + 1) & mask(); !slots_[j].empty(); j = (j + 1) & mask()) {
+        std::size_t k = home(slots_[j]);
+        bool stays = i < j ? (i < k && k <= j) : (i < k || k <= j);
+        if (!stays) {
+          slots_[i] = slots_[j];
+          i = j;
+        }
+      }
+      slots_[i].e = npos;
+      --count_;
+    }
+
+    // Remove all edges from the index. Storage is retained.
+    inline void
+    hash_edge_index::clear()
+    {
+      for (slot& s : slots_)
+        s.e = npos;
+      count_ = 0;
+    }
+
+    // Reinsert every edge into a table with n slots.
+    inline void
+    hash_edge_index::rehash(std::size_t n)
+    {
+      std::vector<slot> old(n, slot{npos, npos, npos});
+      old.swap(slots_);
+      for (const slot& s : old) {
+        if (!s.empty()) {
+          std::size_t i = home(s);
+          while (!slots_[i].empty())
+            i = (i + 1) & mask();
+          slots_[i] = s;
+        }
+      }
+    }
+
+  } // namespace adjacency_list_impl
+} // namespace origin
+
+#endif
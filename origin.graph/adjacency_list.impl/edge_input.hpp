@@ -0,0 +1,119 @@
+// Copyright (c) 2009-2015 Andrew Sutton
+// All rights reserved
+
+#ifndef ORIGIN_GRAPH_ADJACENCY_LIST_IMPL_EDGE_INPUT_HPP
+#define ORIGIN_GRAPH_ADJACENCY_LIST_IMPL_EDGE_INPUT_HPP
+
+#include <algorithm>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace origin
+{
+  namespace adjacency_list_impl
+  {
+    // ---------------------------------------------------------------------- //
+    //                               Edge Input
+    //
+    // Graphs can be built in bulk from a range of input edges. An input edge
+    // is a pair or tuple whose first two elements are the source and target
+    // vertex indexes. If there is a third element, it initializes the value
+    // of the edge.
+
+    template<typename T>
+      inline std::size_t
+      input_source(const T& x) { return std::get<0>(x); }
+
+    template<typename T>
+      inline std::size_t
+      input_target(const T& x) { return std::get<1>(x); }
+
+    // Returns the value of the input edge x, or a default value if x has
+    // no value.
+    template<typename E, typename T>
+      inline E
+      input_value(const T&, std::false_type) { return E{}; }
+
+    template<typename E, typename T>
+      inline E
+      input_value(const T& x, std::true_type) { return E(std::get<2>(x)); }
+
+    template<typename E, typename T>
+      inline E
+      input_value(const T& x)
+      {
+        using has_value = std::integral_constant<bool, (std::tuple_size<T>::value > 2)>;
+        return input_value<E>(x, has_value{});
+      }
+
+    // Add the input edge x to the graph g.
+    template<typename G, typename T>
+      inline void
+      emplace_input(G& g, const T& x, std::false_type)
+      {
+        g.add_edge(input_source(x), input_target(x));
+      }
+
+    template<typename G, typename T>
+      inline void
+      emplace_input(G& g, const T& x, std::true_type)
+      {
+        g.add_edge(input_source(x), input_target(x), std::get<2>(x));
+      }
+
+    template<typename G, typename T>
+      inline void
+      emplace_input(G& g, const T& x)
+      {
+        using has_value = std::integral_constant<bool, (std::tuple_size<T>::value > 2)>;
+        emplace_input(g, x, has_value{});
+      }
+
+
+    // ---------------------------------------------------------------------- //
+    //                              Degree Count
+    //
+    // A degree count records the order and size of a graph described by a
+    // range of input edges, and the number of edges leaving and entering
+    // each vertex. In an undirected graph, the degree of a vertex is the
+    // sum of the two; a loop is counted twice.
+    struct degree_count
+    {
+      std::size_t order = 0;
+      std::size_t size = 0;
+      std::vector<std::size_t> out;
+      std::vector<std::size_t> in;
+    };
+
+    // Count the degrees of the vertices in the input edges [first, last).
+    // The order is at least n, and at least one more than the greatest
+    // vertex index in the input.
+    template<typename I>
+      degree_count
+      count_degrees(I first, I last, std::size_t n)
+      {
+        degree_count c;
+        c.out.resize(n, 0);
+        c.in.resize(n, 0);
+        for ( ; first != last; ++first) {
+          std::size_t u = input_source(*first);
+          std::size_t v = input_target(*first);
+          std::size_t k = std::max(u, v) + 1;
+          if (k > c.out.size()) {
+            c.out.resize(k, 0);
+            c.in.resize(k, 0);
+          }
+          ++c.out[u];
+          ++c.in[v];
+          ++c.size;
+        }
+        c.order = c.out.size();
+        return c;
+      }
+
+  } // namespace adjacency_list_impl
+} // namespace origin
+
+#endif
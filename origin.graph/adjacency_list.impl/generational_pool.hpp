@@ -0,0 +1,122 @@
+// Copyright (c) 2009-2015 Andrew Sutton
+// All rights reserved
+
+#ifndef ORIGIN_GRAPH_ADJACENCY_LIST_IMPL_GENERATIONAL_POOL_HPP
+#define ORIGIN_GRAPH_ADJACENCY_LIST_IMPL_GENERATIONAL_POOL_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include <origin.graph/adjacency_list.impl/pool.hpp>
+
+namespace origin
+{
+  namespace adjacency_list_impl
+  {
+    // ---------------------------------------------------------------------- //
+    //                           Generational Pool
+    //
+    // A generational pool extends a pool (by default, the node pool) with a
+    // generation counter for each index. The generation of an index is
+    // incremented whenever the object at that index is erased. A handle
+    // that records the generation of its object at the time it was issued
+    // can then be checked against the current generation; a mismatch means
+    // the object was erased and the index possibly reused.
+    //
+    // Generations are stored in a separate array of 32-bit counters and are
+    // never released, even when the pool is cleared.
+    template<typename T, template<typename> class Base = pool>
+      class generational_pool : public Base<T>
+      {
+        using base_type = Base<T>;
+      public:
+        using generation_type = std::uint32_t;
+
+        // Generations
+        generation_type generation(std::size_t n) const;
+
+        // Insert
+        std::size_t insert(T&& x)      { return emplace(std::move(x)); }
+        std::size_t insert(const T& x) { return emplace(x); }
+        template<typename... Args> std::size_t emplace(Args&&... args);
+
+        // Erase
+        void erase(std::size_t n);
+        void clear();
+
+        // Compaction
+        std::vector<std::size_t> compact();
+
+      private:
+        std::vector<generation_type> gens_;
+      };
+
+    // Returns the current generation of the index n.
+    template<typename T, template<typename> class Base>
+      inline auto
+      generational_pool<T, Base>::generation(std::size_t n) const
+        -> generation_type
+      {
+        return n < gens_.size() ? gens_[n] : 0;
+      }
+
+    template<typename T, template<typename> class Base>
+      template<typename... Args>
+        inline std::size_t
+        generational_pool<T, Base>::emplace(Args&&... args)
+        {
+          std::size_t n = base_type::emplace(std::forward<Args>(args)...);
+          if (n >= gens_.size())
+            gens_.resize(n + 1, 0);
+          return n;
+        }
+
+    // Erase the object at index n, advancing its generation. If the object
+    // is not alive, do nothing.
+    template<typename T, template<typename> class Base>
+      inline void
+      generational_pool<T, Base>::erase(std::size_t n)
+      {
+        std::size_t k = this->size();
+        base_type::erase(n);
+        if (this->size() != k)
+          ++gens_[n];
+      }
+
+    // Erase every object in the pool, advancing the generation of every
+    // index.
+    template<typename T, template<typename> class Base>
+      inline void
+      generational_pool<T, Base>::clear()
+      {
+        base_type::clear();
+        for (generation_type& g : gens_)
+          ++g;
+      }
+
+    // Compact the pool. Every index is advanced to a generation greater than
+    // that of any object previously stored there or moved there, so no handle
+    // issued before compaction is current afterwards.
+    template<typename T, template<typename> class Base>
+      std::vector<std::size_t>
+      generational_pool<T, Base>::compact()
+      {
+        std::vector<std::size_t> map = base_type::compact();
+        std::vector<generation_type> gens(gens_.size());
+        for (std::size_t i = 0; i < gens_.size(); ++i)
+          gens[i] = gens_[i] + 1;
+        for (std::size_t i = 0; i < map.size(); ++i) {
+          if (map[i] != base_type::npos) {
+            generation_type& g = gens[map[i]];
+            g = std::max(g, generation_type(gens_[i] + 1));
+          }
+        }
+        gens_.swap(gens);
+        return map;
+      }
+
+  } // namespace adjacency_list_impl
+} // namespace origin
+
+#endif
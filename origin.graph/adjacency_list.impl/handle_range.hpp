@@ -0,0 +1,246 @@
+// Copyright (c) 2009-2015 Andrew Sutton
+// All rights reserved
+
+#ifndef ORIGIN_GRAPH_ADJACENCY_LIST_IMPL_HANDLE_RANGE_HPP
+#define ORIGIN_GRAPH_ADJACENCY_LIST_IMPL_HANDLE_RANGE_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+
+namespace origin
+{
+  namespace adjacency_list_impl
+  {
+    // ---------------------------------------------------------------------- //
+    //                              Handle Counter
+    //
+    // A handle counter is a random access iterator over a contiguous range
+    // of indexes, counted by a value of type T. Dereferencing the iterator
+    // returns the current index as a handle of type H.
+    template<typename T, typename H>
+      struct handle_counter
+      {
+        using handle_type = H;
+        using counter_type = T;
+
+        using value_type = H;
+        using reference = H;
+        using pointer = const H*;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::random_access_iterator_tag;
+
+        handle_counter()
+          : count()
+        { }
+
+        handle_counter(counter_type n)
+          : count(n)
+        { }
+
+        handle_type operator*() const { return H(count); }
+        handle_type operator[](difference_type n) const { return H(count + n); }
+
+        handle_counter& operator++();
+        handle_counter  operator++(int);
+        handle_counter& operator--();
+        handle_counter  operator--(int);
+
+        handle_counter& operator+=(difference_type n);
+        handle_counter& operator-=(difference_type n);
+
+        T count;
+      };
+
+    template<typename T, typename H>
+      inline handle_counter<T, H>&
+      handle_counter<T, H>::operator++()
+      {
+        ++count;
+        return *this;
+      }
+
+    template<typename T, typename H>
+      inline handle_counter<T, H>
+      handle_counter<T, H>::operator++(int)
+      {
+        handle_counter tmp = *this;
+        ++count;
+        return tmp;
+      }
+
+    template<typename T, typename H>
+      inline handle_counter<T, H>&
+      handle_counter<T, H>::operator--()
+      {
+        --count;
+        return *this;
+      }
+
+    template<typename T, typename H>
+      inline handle_counter<T, H>
+      handle_counter<T, H>::operator--(int)
+      {
+        handle_counter tmp = *this;
+        --count;
+        return tmp;
+      }
+
+    template<typename T, typename H>
+      inline handle_counter<T, H>&
+      handle_counter<T, H>::operator+=(difference_type n)
+      {
+        count += n;
+        return *this;
+      }
+
+    template<typename T, typename H>
+      inline handle_counter<T, H>&
+      handle_counter<T, H>::operator-=(difference_type n)
+      {
+        count -= n;
+        return *this;
+      }
+
+    // Arithmetic
+    template<typename T, typename H>
+      inline handle_counter<T, H>
+      operator+(handle_counter<T, H> i, std::ptrdiff_t n) { return i += n; }
+
+    template<typename T, typename H>
+      inline handle_counter<T, H>
+      operator+(std::ptrdiff_t n, handle_counter<T, H> i) { return i += n; }
+
+    template<typename T, typename H>
+      inline handle_counter<T, H>
+      operator-(handle_counter<T, H> i, std::ptrdiff_t n) { return i -= n; }
+
+    template<typename T, typename H>
+      inline std::ptrdiff_t
+      operator-(const handle_counter<T, H>& a, const handle_counter<T, H>& b)
+      {
+        return std::ptrdiff_t(a.count) - std::ptrdiff_t(b.count);
+      }
+
+    // Equality
+    template<typename T, typename H>
+      inline bool
+      operator==(const handle_counter<T, H>& a, const handle_counter<T, H>& b)
+      {
+        return a.count == b.count;
+      }
+
+    template<typename T, typename H>
+      inline bool
+      operator!=(const handle_counter<T, H>& a, const handle_counter<T, H>& b)
+      {
+        return a.count != b.count;
+      }
+
+    // Ordering
+    template<typename T, typename H>
+      inline bool
+      operator<(const handle_counter<T, H>& a, const handle_counter<T, H>& b)
+      {
+        return a.count < b.count;
+      }
+
+    template<typename T, typename H>
+      inline bool
+      operator>(const handle_counter<T, H>& a, const handle_counter<T, H>& b)
+      {
+        return b < a;
+      }
+
+    template<typename T, typename H>
+      inline bool
+      operator<=(const handle_counter<T, H>& a, const handle_counter<T, H>& b)
+      {
+        return !(b < a);
+      }
+
+    template<typename T, typename H>
+      inline bool
+      operator>=(const handle_counter<T, H>& a, const handle_counter<T, H>& b)
+      {
+        return !(a < b);
+      }
+
+
+    // ---------------------------------------------------------------------- //
+    //                               Handle Range
+    //
+    // A handle range is the range of handles [first, last). Because the
+    // handles are contiguous, a handle range can be divided into subranges
+    // in constant time. This lets parallel algorithms give each thread a
+    // block of vertices or edges without walking the range.
+    template<typename H>
+      class handle_range
+      {
+      public:
+        using iterator = handle_counter<std::size_t, H>;
+        using value_type = H;
+        using size_type = std::size_t;
+
+        handle_range()
+          : first(0), last(0)
+        { }
+
+        handle_range(std::size_t f, std::size_t l)
+          : first(f), last(l)
+        {
+          assert(f <= l);
+        }
+
+        // Observers
+        bool        empty() const { return first == last; }
+        std::size_t size() const  { return last - first; }
+
+        H operator[](std::size_t n) const { assert(n < size()); return H(first + n); }
+
+        // Splitting
+        handle_range subrange(std::size_t i, std::size_t j) const;
+        handle_range block(std::size_t b, std::size_t k) const;
+        std::pair<handle_range, handle_range> split() const;
+
+        // Iterators
+        iterator begin() const { return iterator(first); }
+        iterator end() const   { return iterator(last); }
+
+      private:
+        std::size_t first;
+        std::size_t last;
+      };
+
+    // Returns the handles at the positions [i, j) of the range.
+    template<typename H>
+      inline handle_range<H>
+      handle_range<H>::subrange(std::size_t i, std::size_t j) const
+      {
+        assert(i <= j && j <= size());
+        return {first + i, first + j};
+      }
+
+    // Returns the b-th of k nearly equal blocks that partition the range.
+    template<typename H>
+      inline handle_range<H>
+      handle_range<H>::block(std::size_t b, std::size_t k) const
+      {
+        assert(b < k);
+        return subrange(size() * b / k, size() * (b + 1) / k);
+      }
+
+    // Returns the two halves of the range.
+    template<typename H>
+      inline std::pair<handle_range<H>, handle_range<H>>
+      handle_range<H>::split() const
+      {
+        std::size_t mid = size() / 2;
+        return {subrange(0, mid), subrange(mid, size())};
+      }
+
+  } // namespace adjacency_list_impl
+} // namespace origin
+
+#endif
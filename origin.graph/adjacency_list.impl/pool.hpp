@@ -1,6 +1,16 @@
 // Copyright (c) 2009-2015 Andrew Sutton
 // All rights reserved
 
+#ifndef ORIGIN_GRAPH_ADJACENCY_LIST_IMPL_POOL_HPP
+#define ORIGIN_GRAPH_ADJACENCY_LIST_IMPL_POOL_HPP
+
+#include <cassert>
+#include <type_traits>
+#include <vector>
+
+#include <origin.graph/adjacency_list.impl/bitmap.hpp>
+#include <origin.graph/adjacency_list.impl/pool_index.hpp>
+
 namespace origin
 {
   namespace adjacency_list_impl
@@ -25,23 +35,24 @@ namespace origin
     //
     // The data structure functions like normal vector until an object is
     // erased. When erased, the object is cleared, and its index is added to the
-    // free index list, which is actually a min-queue. When a new object is
-    // inserted, the least index is taken from the queue and used as the
+    // free index set, which is a hierarchical bitmap. When a new object is
+    // inserted, the least index is taken from the set and used as the
     // location for the new object. The new object is woven into the linked
     // list of live nodes in constant time. Re-linking list to incorporate the
     // new node is done in constant time.
     //
-    // Because the free index list is a min-queue, we always return the first
-    // unoccuped index. Unless that index is 0, we are guaranteed that the
+    // Because the free index set yields the least index, we always return the
+    // first unoccuped index. Unless that index is 0, we are guaranteed that the
     // next lower index is occupied, and we can thus re-link the list based on
     // its pointers. If the returned index is 0, we rely simply use the head
     // pointer to find the first non-empty index and re-link the list with the
     // new element at the head.
     //
     // Performance properties:
-    //    - Insertion: O(log2 d)
-    //    - Erasure: O(log2 d)
-    // Where d is the number of deleted nodes in the pool.
+    //    - Insertion: O(log64 n)
+    //    - Erasure: O(log64 n)
+    // Where n is the number of nodes in the pool (live or dead). In practice,
+    // this is a small constant.
     //
     // This data structure has some similarity to conventional object pools
     // except that it doesn't really allocate memory, and it has additional
@@ -61,12 +72,12 @@ namespace origin
         using const_iterator = pool_iterator<const T>;
 
         using list_type = std::vector<node_type>;
-        using queue_type = std::priority_queue<std::size_t, 
-                                               std::vector<std::size_t>, 
-                                               std::greater<size_t>>;
+        using free_type = free_index_set;
 
         static constexpr std::size_t npos = node_type::npos;
 
+        pool();
+
         // Observers
         bool empty() const;
         std::size_t size() const;
@@ -75,11 +86,12 @@ namespace origin
         // These are not part of the general interface. They are provided
         // solely for the purposes of debugging and testing.
         const list_type& data() const;
-        const queue_type& free() const;
+        const free_type& free() const;
         
         // Capacity
         std::size_t capacity() const;
         void reserve(std::size_t n);
+        void shrink_to_fit();
 
         // Element access
         T&       operator[](std::size_t n);
@@ -94,6 +106,9 @@ namespace origin
         void erase(std::size_t x);
         void clear();
 
+        // Compaction
+        std::vector<std::size_t> compact();
+
         // Iterators
         iterator begin() { return iterator(this, head_); }
         iterator end()   { return iterator(this, npos); }
@@ -150,11 +165,17 @@ namespace origin
       private:
 
         list_type  nodes_; // The actual node vector
-        queue_type free_;  // The free index list
+        free_type  free_;  // The free index set
         std::size_t head_; // Head of the live node list
         std::size_t tail_; // Tail of the live node list
       };
 
+    template<typename T>
+      inline
+      pool<T>::pool()
+        : nodes_(), free_(), head_(npos), tail_(npos)
+      { }
+
     // Returns true if the pool contains no nodes.
     template<typename T>
       inline bool
@@ -170,10 +191,10 @@ namespace origin
       inline auto
       pool<T>::data() const -> const list_type& { return nodes_; }
 
-    // Returns the free index list.
+    // Returns the free index set.
     template<typename T>
       inline auto
-      pool<T>::free() const -> const queue_type& { return free_; }
+      pool<T>::free() const -> const free_type& { return free_; }
 
     // Returns the capacity allocated to the pool.
     template<typename T>
@@ -185,6 +206,12 @@ namespace origin
       inline void
       pool<T>::reserve(std::size_t n) { nodes_.reserve(n); }
 
+    // Release unused capacity. Note that the slots of erased objects are
+    // not released; compact the pool to reclaim them.
+    template<typename T>
+      inline void
+      pool<T>::shrink_to_fit() { nodes_.shrink_to_fit(); }
+
     // Returns a reference to the element in the nth position. This function
     // results in undefined behavior if the element at the nth position has been
     // previously erased.
@@ -375,14 +402,12 @@ namespace origin
           tail_ = n;
         }
 
-    // Take the next free index from the free list.
+    // Take the least free index from the free index set.
     template<typename T>
       inline std::size_t
       pool<T>::take()
       {
-        std::size_t n = free_.top();
-        free_.pop();
-        return n;
+        return free_.take();
       }
 
     // Erase the element at the nth position in the pool, returning the index
@@ -471,13 +496,13 @@ namespace origin
       }
 
     // Finally destroy the node at the nth position and return its index to the
-    // free index list.
+    // free index set.
     template<typename T>
       inline void
       pool<T>::recycle(std::size_t n)
       {
         node(n).reset();
-        free_.push(n);
+        free_.insert(n);
       }
 
     // Reset the pool to its initial state.
@@ -485,10 +510,43 @@ namespace origin
       inline void
       pool<T>::clear()
       {
-        // std::priority_queue does not have clear() method, so we have to
-        // reset it by brute force.
-        free_ = std::move(queue_type());
+        free_.clear();
         nodes_.clear();
+        head_ = tail_ = npos;
+      }
+
+    // Move all live objects to the front of the pool, preserving their
+    // relative order, and release the storage of the dead nodes. This
+    // returns a mapping from the old index of each node to its new index.
+    // Indexes of dead nodes are mapped to npos.
+    //
+    // Because the live list is ordered by index, the ith live node is
+    // simply moved to position i. This invalidates all indexes into the
+    // pool, so callers are responsible for translating any stored indexes
+    // through the returned mapping.
+    template<typename T>
+      std::vector<std::size_t>
+      pool<T>::compact()
+      {
+        std::vector<std::size_t> map(nodes_.size(), npos);
+        std::size_t n = size();
+
+        list_type live;
+        live.reserve(n);
+        for (std::size_t i = head_; i != npos; ) {
+          node_type& p = node(i);
+          std::size_t k = live.size();
+          std::size_t next = (k + 1 == n) ? k : k + 1;
+          live.emplace_back(k == 0 ? 0 : k - 1, next, std::move(p.get()));
+          map[i] = k;
+          i = (p.next == i) ? npos : std::size_t(p.next);
+        }
+
+        nodes_.swap(live);
+        free_.clear();
+        head_ = n == 0 ? npos : 0;
+        tail_ = n == 0 ? npos : n - 1;
+        return map;
       }
 
 
@@ -500,11 +558,14 @@ namespace origin
     // pool. The data buffer stores a possibly initialized value.
     //
     // A node is uninitialized when either of prev or next is the same as
-    // limit (i.e., size_t(-1)).
+    // limit (i.e., size_t(-1)). The links are handles whose width is the
+    // index type of T (see pool_index).
     template<typename T>
       class pool_node
       {
       public:
+        using link_type = pool_link_type<T>;
+
         static constexpr std::size_t npos = -1;
 
         pool_node();
@@ -513,6 +574,14 @@ namespace origin
         template<typename... Args>
           pool_node(std::size_t p, std::size_t n, Args&&... args);
 
+        // Copy and move
+        // Only the initialized object is copied or moved. These are required
+        // to relocate nodes when the node vector grows or is compacted.
+        pool_node(const pool_node& x);
+        pool_node(pool_node&& x) noexcept(std::is_nothrow_move_constructible<T>::value);
+
+        pool_node& operator=(const pool_node&) = delete;
+        pool_node& operator=(pool_node&&) = delete;
 
         ~pool_node();
 
@@ -536,8 +605,8 @@ namespace origin
         void reset();
         void destroy();
 
-        std::size_t prev;
-        std::size_t next;
+        link_type prev;
+        link_type next;
         Aligned_storage<sizeof(T), alignof(T)> data;
       };
 
@@ -552,6 +621,23 @@ namespace origin
           new (&data) T(std::forward<Args>(args)...);
         }
 
+    template<typename T>
+      pool_node<T>::pool_node(const pool_node& x)
+        : prev(x.prev), next(x.next)
+      {
+        if (valid())
+          new (&data) T(x.get());
+      }
+
+    template<typename T>
+      pool_node<T>::pool_node(pool_node&& x)
+        noexcept(std::is_nothrow_move_constructible<T>::value)
+        : prev(x.prev), next(x.next)
+      {
+        if (valid())
+          new (&data) T(std::move(x.get()));
+      }
+
     template<typename T>
       pool_node<T>::~pool_node() { destroy(); }
 
@@ -588,10 +674,10 @@ namespace origin
         inline void
         pool_node<T>::assign(std::size_t p, std::size_t n, Args&&... args)
         {
-          prev = p;
-          next = n;
           destroy();
           new (&data) T(std::forward<Args>(args)...);
+          prev = p;
+          next = n;
         }
 
     template<typename T>
@@ -726,8 +812,10 @@ namespace origin
       pool_iterator<T>::incr() 
       {
         const node_type& n = p_->node(i_);
-        i_ = (n.next == i_ ? pool_node<T>::npos : n.next);
+        i_ = (n.next == i_ ? pool_node<T>::npos : std::size_t(n.next));
       }
 
   } // namespace adjacency_list_impl
 } // namespace origin
+
+#endif
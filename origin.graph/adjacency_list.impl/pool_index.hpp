@@ -0,0 +1,39 @@
+// Copyright (c) 2009-2015 Andrew Sutton
+// All rights reserved
+
+#ifndef ORIGIN_GRAPH_ADJACENCY_LIST_IMPL_POOL_INDEX_HPP
+#define ORIGIN_GRAPH_ADJACENCY_LIST_IMPL_POOL_INDEX_HPP
+
+#include <cstddef>
+
+#include <origin.graph/handle.hpp>
+
+namespace origin
+{
+  namespace adjacency_list_impl
+  {
+    // ---------------------------------------------------------------------- //
+    //                               Pool Index
+    //
+    // The pools store the links of their live lists as handles. The width
+    // of those handles is the index type of the pooled objects: T::index_type
+    // if T declares one, and std::size_t otherwise. The vertices and edges
+    // of a graph with narrow handles declare a narrow index type, so their
+    // pools have narrow links.
+    template<typename T>
+      typename T::index_type pool_index_of(int);
+
+    template<typename T>
+      std::size_t pool_index_of(...);
+
+    template<typename T>
+      using pool_index = decltype(pool_index_of<T>(0));
+
+    // The type of a link in a pool of T.
+    template<typename T>
+      using pool_link_type = basic_handle<pool_index<T>>;
+
+  } // namespace adjacency_list_impl
+} // namespace origin
+
+#endif
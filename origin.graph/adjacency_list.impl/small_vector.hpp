@@ -0,0 +1,303 @@
+// Copyright (c) 2009-2015 Andrew Sutton
+// All rights reserved
+
+#ifndef ORIGIN_GRAPH_ADJACENCY_LIST_IMPL_SMALL_VECTOR_HPP
+#define ORIGIN_GRAPH_ADJACENCY_LIST_IMPL_SMALL_VECTOR_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace origin
+{
+  namespace adjacency_list_impl
+  {
+    // ---------------------------------------------------------------------- //
+    //                              Small Vector
+    //
+    // A small vector is a sequence of trivially copyable objects that stores
+    // up to N elements inline, and spills to the heap only when it grows
+    // beyond that. It is used for the incidence lists of vertices: most
+    // vertices have small degree, so most incidence lists never allocate,
+    // and scanning them does not leave the vertex.
+    //
+    // The size and capacity are 32-bit, so the vector occupies 8 bytes plus
+    // the larger of N elements or a pointer. The storage is inline exactly
+    // when the capacity is N.
+    //
+    // Performance properties:
+    //    - Insertion (at the end): O(1) amortized
+    //    - Erasure (at the end): O(1)
+    //    - Erasure (elsewhere): O(n)
+    template<typename T, std::size_t N>
+      class small_vector
+      {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "small vector elements must be trivially copyable");
+        static_assert(N > 0, "small vector must have inline capacity");
+      public:
+        using value_type = T;
+        using size_type = std::size_t;
+
+        using iterator       = T*;
+        using const_iterator = const T*;
+
+        static constexpr std::size_t inline_capacity = N;
+
+        small_vector();
+        small_vector(std::initializer_list<T> list);
+        small_vector(const small_vector& x);
+        small_vector(small_vector&& x) noexcept;
+        ~small_vector();
+
+        small_vector& operator=(const small_vector& x);
+        small_vector& operator=(small_vector&& x) noexcept;
+
+        void swap(small_vector& x) noexcept;
+
+        // Observers
+        bool empty() const { return size_ == 0; }
+        std::size_t size() const { return size_; }
+
+        // Returns true if the elements are stored inline.
+        bool is_inline() const { return cap_ == N; }
+
+        // Capacity
+        std::size_t capacity() const { return cap_; }
+        void reserve(std::size_t n);
+        void shrink_to_fit();
+
+        // Element access
+        T*       data()       { return is_inline() ? buffer() : ptr_; }
+        const T* data() const { return is_inline() ? buffer() : ptr_; }
+
+        T&       operator[](std::size_t n)       { assert(n < size_); return data()[n]; }
+        const T& operator[](std::size_t n) const { assert(n < size_); return data()[n]; }
+
+        T&       back()       { assert(!empty()); return data()[size_ - 1]; }
+        const T& back() const { assert(!empty()); return data()[size_ - 1]; }
+
+        // Insert
+        void push_back(const T& x);
+
+        // Erase
+        void pop_back() { assert(!empty()); --size_; }
+        iterator erase(const_iterator i);
+        void clear() { size_ = 0; }
+
+        // Iterators
+        iterator begin() { return data(); }
+        iterator end()   { return data() + size_; }
+
+        const_iterator begin() const { return data(); }
+        const_iterator end() const   { return data() + size_; }
+
+      private:
+        T*       buffer()       { return reinterpret_cast<T*>(&buf_); }
+        const T* buffer() const { return reinterpret_cast<const T*>(&buf_); }
+
+        void reallocate(std::size_t n);
+        void release();
+
+      private:
+        std::uint32_t size_; // The number of elements
+        std::uint32_t cap_;  // The capacity; N when storage is inline
+        union
+        {
+          T* ptr_;           // Heap storage
+          typename std::aligned_storage<N * sizeof(T), alignof(T)>::type buf_;
+        };
+      };
+
+    template<typename T, std::size_t N>
+      inline
+      small_vector<T, N>::small_vector()
+        : size_(0), cap_(N)
+      { }
+
+    template<typename T, std::size_t N>
+      inline
+      small_vector<T, N>::small_vector(std::initializer_list<T> list)
+        : small_vector()
+      {
+        reserve(list.size());
+        for (const T& x : list)
+          push_back(x);
+      }
+
+    template<typename T, std::size_t N>
+      inline
+      small_vector<T, N>::small_vector(const small_vector& x)
+        : small_vector()
+      {
+        reserve(x.size_);
+        std::memcpy(data(), x.data(), x.size_ * sizeof(T));
+        size_ = x.size_;
+      }
+
+    // Moving a small vector steals its heap storage, if any. The moved-from
+    // vector is left empty, with inline storage.
+    template<typename T, std::size_t N>
+      inline
+      small_vector<T, N>::small_vector(small_vector&& x) noexcept
+        : small_vector()
+      {
+        swap(x);
+      }
+
+    template<typename T, std::size_t N>
+      inline
+      small_vector<T, N>::~small_vector()
+      {
+        release();
+      }
+
+    template<typename T, std::size_t N>
+      inline small_vector<T, N>&
+      small_vector<T, N>::operator=(const small_vector& x)
+      {
+        if (this != &x) {
+          clear();
+          reserve(x.size_);
+          std::memcpy(data(), x.data(), x.size_ * sizeof(T));
+          size_ = x.size_;
+        }
+        return *this;
+      }
+
+    template<typename T, std::size_t N>
+      inline small_vector<T, N>&
+      small_vector<T, N>::operator=(small_vector&& x) noexcept
+      {
+        if (this != &x) {
+          release();
+          size_ = 0;
+          cap_ = N;
+          swap(x);
+        }
+        return *this;
+      }
+
+    // Exchange the contents of two small vectors. Inline elements are
+    // copied; heap storage is exchanged.
+    template<typename T, std::size_t N>
+      void
+      small_vector<T, N>::swap(small_vector& x) noexcept
+      {
+        small_vector* a = this;
+        small_vector* b = &x;
+        if (a->is_inline() && b->is_inline()) {
+          auto tmp = buf_;
+          buf_ = x.buf_;
+          x.buf_ = tmp;
+        } else if (!a->is_inline() && !b->is_inline()) {
+          std::swap(ptr_, x.ptr_);
+        } else {
+          // Let a be the inline vector.
+          if (!a->is_inline())
+            std::swap(a, b);
+          T* p = b->ptr_;
+          std::memcpy(b->buffer(), a->buffer(), a->size_ * sizeof(T));
+          a->ptr_ = p;
+        }
+        std::swap(size_, x.size_);
+        std::swap(cap_, x.cap_);
+      }
+
+    // Ensure that n elements can be stored without reallocation.
+    template<typename T, std::size_t N>
+      inline void
+      small_vector<T, N>::reserve(std::size_t n)
+      {
+        if (n > cap_)
+          reallocate(n);
+      }
+
+    // Reduce the capacity to the size, or move the elements back inline if
+    // they fit.
+    template<typename T, std::size_t N>
+      inline void
+      small_vector<T, N>::shrink_to_fit()
+      {
+        if (!is_inline() && size_ < cap_)
+          reallocate(size_);
+      }
+
+    template<typename T, std::size_t N>
+      inline void
+      small_vector<T, N>::push_back(const T& x)
+      {
+        if (size_ == cap_) {
+          T tmp = x; // x may refer to an element of this vector
+          reallocate(2 * cap_);
+          data()[size_++] = tmp;
+        } else {
+          data()[size_++] = x;
+        }
+      }
+
+    // Erase the element at the position i, shifting the following elements
+    // down. Returns an iterator to the element that followed i.
+    template<typename T, std::size_t N>
+      inline auto
+      small_vector<T, N>::erase(const_iterator i) -> iterator
+      {
+        // Shift within the active buffer, so that the bounds of the copy are
+        // those of the elements (GCC cannot see them through end()).
+        T* first = data();
+        std::size_t k = i - first;
+        assert(k < size_);
+        std::copy(first + k + 1, first + size_, first + k);
+        --size_;
+        return first + k;
+      }
+
+    // Move the elements into storage for n elements. If n is no greater
+    // than N, the storage becomes inline.
+    template<typename T, std::size_t N>
+      void
+      small_vector<T, N>::reallocate(std::size_t n)
+      {
+        assert(n >= size_);
+        assert(n <= UINT32_MAX);
+        if (n <= N) {
+          if (!is_inline()) {
+            T* p = ptr_;
+            std::memcpy(buffer(), p, size_ * sizeof(T));
+            std::allocator<T>().deallocate(p, cap_);
+            cap_ = N;
+          }
+          return;
+        }
+        T* p = std::allocator<T>().allocate(n);
+        std::memcpy(p, data(), size_ * sizeof(T));
+        release();
+        ptr_ = p;
+        cap_ = n;
+      }
+
+    // Release heap storage, if any. This does not reset the capacity.
+    template<typename T, std::size_t N>
+      inline void
+      small_vector<T, N>::release()
+      {
+        if (!is_inline())
+          std::allocator<T>().deallocate(ptr_, cap_);
+      }
+
+    template<typename T, std::size_t N>
+      inline void
+      swap(small_vector<T, N>& a, small_vector<T, N>& b)
+      {
+        a.swap(b);
+      }
+
+  } // namespace adjacency_list_impl
+} // namespace origin
+
+#endif
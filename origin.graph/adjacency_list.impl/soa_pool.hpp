@@ -0,0 +1,414 @@
+// Copyright (c) 2009-2015 Andrew Sutton
+// All rights reserved
+
+#ifndef ORIGIN_GRAPH_ADJACENCY_LIST_IMPL_SOA_POOL_HPP
+#define ORIGIN_GRAPH_ADJACENCY_LIST_IMPL_SOA_POOL_HPP
+
+#include <cassert>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <origin.graph/adjacency_list.impl/bitmap.hpp>
+
+namespace origin
+{
+  namespace adjacency_list_impl
+  {
+    template<typename T> class soa_pool_iterator;
+
+    // ---------------------------------------------------------------------- //
+    //                                SoA Pool
+    //
+    // An SoA pool has the same interface and the same insertion, erasure,
+    // and iteration properties as the node pool (see pool). However, it
+    // stores no per-slot links: the objects are kept in one array, and the
+    // free index set is the only record of which slots are alive. An index
+    // is alive if it is less than the number of slots and not free.
+    //
+    // Live objects are visited in index order. The successor of an index is
+    // the next index that is not free, and it is found by scanning the leaf
+    // level of the free index set a word at a time, so a scan reads one bit
+    // per slot besides the objects themselves.
+    //
+    // Storage for objects is managed directly by the pool since only the
+    // pool knows which slots are initialized. The object array always has
+    // at least as much capacity as there are slots.
+    template<typename T>
+      class soa_pool
+      {
+        friend class soa_pool_iterator<T>;
+        friend class soa_pool_iterator<const T>;
+      public:
+        using value_type = T;
+
+        using iterator       = soa_pool_iterator<T>;
+        using const_iterator = soa_pool_iterator<const T>;
+
+        using free_type = free_index_set;
+
+        static constexpr std::size_t npos = -1;
+
+        soa_pool();
+        soa_pool(const soa_pool& x);
+        soa_pool(soa_pool&& x);
+        ~soa_pool();
+
+        soa_pool& operator=(soa_pool x);
+
+        void swap(soa_pool& x);
+
+        // Observers
+        bool empty() const { return size() == 0; }
+        std::size_t size() const { return slots_ - free_.size(); }
+
+        // Debugging and Testing
+        const free_type& free() const { return free_; }
+
+        // Capacity
+        std::size_t capacity() const { return cap_; }
+        void reserve(std::size_t n);
+        void shrink_to_fit();
+
+        // Element access
+        T&       operator[](std::size_t n);
+        const T& operator[](std::size_t n) const;
+
+        // Insert
+        std::size_t insert(T&& x)      { return emplace(std::move(x)); }
+        std::size_t insert(const T& x) { return emplace(x); }
+        template<typename... Args> std::size_t emplace(Args&&... args);
+
+        // Erase
+        void erase(std::size_t n);
+        void clear();
+
+        // Compaction
+        std::vector<std::size_t> compact();
+
+        // Iterators
+        iterator begin() { return iterator(this, first()); }
+        iterator end()   { return iterator(this, npos); }
+
+        const_iterator begin() const { return const_iterator(this, first()); }
+        const_iterator end() const   { return const_iterator(this, npos); }
+
+      private:
+        // Returns true if the object at index n is alive.
+        bool alive(std::size_t n) const
+        {
+          return n < slots_ && !free_.contains(n);
+        }
+
+        // Returns the least live index, or npos if there is none.
+        std::size_t first() const { return alive(0) ? 0 : successor(0); }
+
+        std::size_t successor(std::size_t n) const;
+
+        void reallocate(std::size_t n);
+        void relocate(T* data, std::size_t n);
+        void destroy();
+
+      private:
+        std::size_t slots_; // The number of indexes, live or free
+        T*          data_;  // Object storage
+        std::size_t cap_;   // Capacity of the object storage
+        free_type   free_;  // The free index set
+      };
+
+    template<typename T>
+      inline
+      soa_pool<T>::soa_pool()
+        : slots_(0), data_(nullptr), cap_(0), free_()
+      { }
+
+    template<typename T>
+      soa_pool<T>::soa_pool(const soa_pool& x)
+        : soa_pool()
+      {
+        reserve(x.slots_);
+        const T* src = x.data_;
+        for (std::size_t i = x.first(); i != npos; i = x.successor(i))
+          new (data_ + i) T(src[i]);
+        slots_ = x.slots_;
+        free_ = x.free_;
+      }
+
+    template<typename T>
+      inline
+      soa_pool<T>::soa_pool(soa_pool&& x)
+        : soa_pool()
+      {
+        swap(x);
+      }
+
+    template<typename T>
+      inline
+      soa_pool<T>::~soa_pool() { destroy(); }
+
+    template<typename T>
+      inline soa_pool<T>&
+      soa_pool<T>::operator=(soa_pool x)
+      {
+        swap(x);
+        return *this;
+      }
+
+    template<typename T>
+      inline void
+      soa_pool<T>::swap(soa_pool& x)
+      {
+        using std::swap;
+        swap(slots_, x.slots_);
+        swap(data_, x.data_);
+        swap(cap_, x.cap_);
+        swap(free_, x.free_);
+      }
+
+    // Reserve at least n objects of capacity.
+    template<typename T>
+      inline void
+      soa_pool<T>::reserve(std::size_t n)
+      {
+        if (n > cap_)
+          reallocate(n);
+      }
+
+    // Release unused capacity. As with pool::shrink_to_fit, the slots of
+    // erased objects are not released.
+    template<typename T>
+      inline void
+      soa_pool<T>::shrink_to_fit()
+      {
+        if (cap_ != slots_)
+          reallocate(slots_);
+      }
+
+    template<typename T>
+      inline T&
+      soa_pool<T>::operator[](std::size_t n)
+      {
+        assert(alive(n));
+        return data_[n];
+      }
+
+    template<typename T>
+      inline const T&
+      soa_pool<T>::operator[](std::size_t n) const
+      {
+        assert(alive(n));
+        return data_[n];
+      }
+
+    // Construct a new object at the least free index, or at the end of the
+    // pool if there are no free indexes. When the storage is full, the new
+    // object is constructed in the new buffer before the live objects are
+    // relocated, so the arguments may refer to objects in the pool.
+    template<typename T>
+      template<typename... Args>
+        inline std::size_t
+        soa_pool<T>::emplace(Args&&... args)
+        {
+          std::size_t n;
+          if (free_.empty()) {
+            n = slots_;
+            if (n == cap_) {
+              std::size_t c = cap_ ? 2 * cap_ : 1;
+              T* data = std::allocator<T>().allocate(c);
+              new (data + n) T(std::forward<Args>(args)...);
+              relocate(data, c);
+            } else {
+              new (data_ + n) T(std::forward<Args>(args)...);
+            }
+            ++slots_;
+          } else {
+            n = free_.front();
+            new (data_ + n) T(std::forward<Args>(args)...);
+            free_.erase(n);
+          }
+          return n;
+        }
+
+    // Erase the object at the nth position, returning its index to the free
+    // index set. If the object is not alive, do nothing.
+    template<typename T>
+      inline void
+      soa_pool<T>::erase(std::size_t n)
+      {
+        assert(n < slots_);
+        if (alive(n)) {
+          data_[n].~T();
+          free_.insert(n);
+        }
+      }
+
+    // Returns the least live index greater than n, or npos if there is
+    // none. Free indexes are skipped a word at a time; words of the free
+    // set beyond its leaf level are all live.
+    template<typename T>
+      inline std::size_t
+      soa_pool<T>::successor(std::size_t n) const
+      {
+        using word_type = free_type::word_type;
+        constexpr std::size_t bits = free_type::bits;
+
+        const std::size_t m = slots_;
+        const free_type::word_list* f = free_.depth() ? &free_.level(0) : nullptr;
+        for (std::size_t i = n + 1; i < m; i = (i / bits + 1) * bits) {
+          std::size_t w = i / bits;
+          word_type free = f && w < f->size() ? (*f)[w] : 0;
+          word_type live = ~free & (~word_type(0) << (i % bits));
+          if (live) {
+            std::size_t k = w * bits + __builtin_ctzll(live);
+            return k < m ? k : npos;
+          }
+        }
+        return npos;
+      }
+
+    // Reset the pool to its initial state. Object storage is retained.
+    template<typename T>
+      inline void
+      soa_pool<T>::clear()
+      {
+        for (std::size_t i = first(); i != npos; i = successor(i))
+          data_[i].~T();
+        slots_ = 0;
+        free_.clear();
+      }
+
+    // Move all live objects to the front of the pool, preserving their
+    // relative order, and shrink the object storage to fit. See
+    // pool::compact for details.
+    template<typename T>
+      std::vector<std::size_t>
+      soa_pool<T>::compact()
+      {
+        std::vector<std::size_t> map(slots_, npos);
+        std::size_t n = size();
+
+        std::allocator<T> alloc;
+        T* data = n ? alloc.allocate(n) : nullptr;
+        std::size_t k = 0;
+        for (std::size_t i = first(); i != npos; i = successor(i), ++k) {
+          new (data + k) T(std::move(data_[i]));
+          data_[i].~T();
+          map[i] = k;
+        }
+        if (data_)
+          alloc.deallocate(data_, cap_);
+
+        data_ = data;
+        cap_ = n;
+        slots_ = n;
+        free_.clear();
+        return map;
+      }
+
+    // Reallocate object storage to hold n objects, relocating the live
+    // objects into the new buffer. The storage must be able to hold every
+    // index in the pool.
+    template<typename T>
+      void
+      soa_pool<T>::reallocate(std::size_t n)
+      {
+        assert(n >= slots_);
+        relocate(n ? std::allocator<T>().allocate(n) : nullptr, n);
+      }
+
+    // Move the live objects into the storage data, which holds n objects,
+    // and release the old storage.
+    template<typename T>
+      void
+      soa_pool<T>::relocate(T* data, std::size_t n)
+      {
+        for (std::size_t i = first(); i != npos; i = successor(i)) {
+          new (data + i) T(std::move(data_[i]));
+          data_[i].~T();
+        }
+        if (data_)
+          std::allocator<T>().deallocate(data_, cap_);
+        data_ = data;
+        cap_ = n;
+      }
+
+    // Destroy all live objects and release the object storage.
+    template<typename T>
+      inline void
+      soa_pool<T>::destroy()
+      {
+        clear();
+        if (data_)
+          std::allocator<T>().deallocate(data_, cap_);
+        data_ = nullptr;
+        cap_ = 0;
+      }
+
+
+    // ---------------------------------------------------------------------- //
+    //                            SoA Pool Iterator
+    //
+    // A forward iterator over the elements in an SoA pool.
+    template<typename T>
+      class soa_pool_iterator
+      {
+      public:
+        using value_type = Remove_const<T>;
+        using pool_type = If<Const<T>(), const soa_pool<value_type>, soa_pool<value_type>>;
+
+        soa_pool_iterator()
+          : p_(nullptr), i_(-1)
+        { }
+
+        soa_pool_iterator(pool_type* p, std::size_t i)
+          : p_(p), i_(i)
+        { }
+
+        // Const conversion.
+        template<typename U>
+          soa_pool_iterator(const soa_pool_iterator<U>& x)
+            : p_(x.container()), i_(x.index())
+          { }
+
+        // Returns the pool being iterated over.
+        pool_type* container() const { return p_; }
+
+        // Returns the current index of the iterator.
+        std::size_t index() const { return i_; }
+
+        T& operator*() const  { return p_->data_[i_]; }
+        T* operator->() const { return p_->data_ + i_; }
+
+        bool operator==(const soa_pool_iterator& x) const
+        {
+          assert(p_ == x.p_);
+          return i_ == x.i_;
+        }
+
+        bool operator!=(const soa_pool_iterator& x) const
+        {
+          return !operator==(x);
+        }
+
+        soa_pool_iterator& operator++()
+        {
+          i_ = p_->successor(i_);
+          return *this;
+        }
+
+        soa_pool_iterator operator++(int)
+        {
+          soa_pool_iterator tmp = *this;
+          operator++();
+          return tmp;
+        }
+
+      private:
+        pool_type*  p_; // The pool
+        std::size_t i_; // The current index
+      };
+
+  } // namespace adjacency_list_impl
+} // namespace origin
+
+#endif
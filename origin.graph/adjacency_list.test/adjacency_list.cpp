@@ -1,6 +1,9 @@
 // Copyright (c) 2009-2015 Andrew Sutton
 // All rights reserved
 
+#include <cstdint>
+#include <set>
+
 #include <origin.graph/adjacency_list.hpp>
 
 #include "../graph.test/testing.hpp"
@@ -21,6 +24,9 @@ struct X
 
 bool X::trace = false;
 
+template<typename T>
+  using generational_soa_pool = adjacency_list_impl::generational_pool<T, adjacency_list_impl::soa_pool>;
+
 void
 trace_insert()
 {
@@ -36,6 +42,280 @@ trace_insert()
   X::trace = false;
 }
 
+// Removing a vertex and compacting the graph yields dense handles that
+// preserve the structure of the graph.
+template<typename G>
+  void
+  check_compact()
+  {
+    cout << "*** compact (" << typestr<G>() << ") ***\n";
+    G g = build_reflexive_clique<G>(4);
+    g.remove_vertex(1);
+    assert(g.order() == 3);
+    assert(g.size() == 6);
+
+    auto map = g.compact();
+    assert(map.vertices[1] == vertex_handle::npos);
+    assert(map.vertices[3] == 2);
+    assert(g.order() == 3);
+    assert(g.size() == 6);
+
+    // Vertex values follow their vertices, and edges are renumbered densely.
+    assert(g(Vertex<G>(0)) == 'a');
+    assert(g(Vertex<G>(1)) == 'c');
+    assert(g(Vertex<G>(2)) == 'd');
+    std::size_t n = 0;
+    for (auto e : g.edges())
+      assert(e == Edge<G>(n++));
+
+    // The edge (c, d) was labeled 8 in the original clique.
+    Edge<G> e = g(Vertex<G>(1), Vertex<G>(2));
+    assert(e);
+    assert(g(e) == 8);
+    assert(has_degrees(g, 1, {2, 2, 4}));
+  }
+
+// Stamped handles are rejected once their object has been removed, even
+// when the slot is reused by a new object.
+template<typename G>
+  void
+  check_stamped()
+  {
+    cout << "*** stamped handles (" << typestr<G>() << ") ***\n";
+    G g = build_reflexive_clique<G>(3);
+    auto v = g.stamp(Vertex<G>(1));
+    auto e = g.stamp(Edge<G>(4));
+    assert(g.resolve(v) == Vertex<G>(1));
+    assert(g.resolve(e) == Edge<G>(4));
+
+    g.remove_vertex(1);
+    assert(!g.resolve(v));
+    assert(!g.resolve(e));
+
+    Vertex<G> u = g.add_vertex('z');
+    assert(u == Vertex<G>(1));
+    assert(!g.resolve(v));
+    assert(g.resolve(g.stamp(u)) == u);
+
+    // Compaction invalidates all stamps.
+    auto w = g.stamp(Vertex<G>(2));
+    g.compact();
+    assert(!g.resolve(w));
+  }
+
+// Returns the values of the edges in the (out) incidence list of v.
+template<typename V, typename E, template<typename> class P, typename I, typename S>
+  std::vector<E>
+  incident_values(const directed_adjacency_list<V, E, P, I, S>& g, std::size_t v)
+  {
+    std::vector<E> r;
+    for (auto e : g.out_edges(v))
+      r.push_back(g(e));
+    return r;
+  }
+
+template<typename V, typename E, template<typename> class P, typename I, typename S>
+  std::vector<E>
+  incident_values(const undirected_adjacency_list<V, E, P, I, S>& g, std::size_t v)
+  {
+    std::vector<E> r;
+    for (auto e : g.edges(v))
+      r.push_back(g(e));
+    return r;
+  }
+
+// When order is preserved, removing an edge leaves the remaining incident
+// edges in their original order. Otherwise, the removed edge is replaced by
+// the last edge in the list. In either case, the positions recorded by the
+// moved edges must remain valid for later removals.
+template<typename G>
+  void
+  check_ordered_removal()
+  {
+    cout << "*** ordered removal (" << typestr<G>() << ") ***\n";
+    for (bool ordered : {false, true}) {
+      G g = build_reflexive_bidi_clique<G>(3);
+      g.preserve_order(ordered);
+      assert(g.preserves_order() == ordered);
+
+      std::vector<int> vals = incident_values(g, 0);
+      auto i = std::find(vals.begin(), vals.end(), 2); // The first a--b
+      if (ordered) {
+        vals.erase(i);
+      } else {
+        *i = vals.back();
+        vals.pop_back();
+      }
+      g.remove_edge(Edge<G>(2));
+      assert(incident_values(g, 0) == vals);
+
+      // Remove every other edge by handle, then the rest by vertex.
+      for (std::size_t n = 0; n < 12; n += 2) {
+        if (n != 2)
+          g.remove_edge(Edge<G>(n));
+      }
+      assert(g.size() == 6);
+      g.remove_edges(1);
+      g.remove_edges(0);
+      g.remove_edges(2);
+      assert(g.empty());
+    }
+  }
+
+// Returns true if e connects u to v. Undirected edges may connect them in
+// either order.
+template<typename G>
+  bool
+  connects(const G& g, Edge<G> e, Vertex<G> u, Vertex<G> v)
+  {
+    if (!e)
+      return false;
+    if (g.source(e) == u && g.target(e) == v)
+      return true;
+    return !Directed_graph<G>() && g.source(e) == v && g.target(e) == u;
+  }
+
+// Lookup by endpoints finds an edge for every connected pair, and stops
+// finding edges once they are removed or renumbered.
+template<typename G>
+  void
+  check_indexed_lookup()
+  {
+    cout << "*** indexed lookup (" << typestr<G>() << ") ***\n";
+    G g = build_reflexive_bidi_clique<G>(4);
+    for (int u = 0; u < 4; ++u)
+      for (int v = 0; v < 4; ++v)
+        assert(connects(g, g(u, v), u, v));
+
+    g.remove_edges(0, 1);
+    assert(!g(0, 1));
+    assert(bool(g(1, 0)) == Directed_graph<G>());
+    g.remove_edge(2, 2);
+    assert(connects(g, g(2, 2), 2, 2));
+    g.remove_edge(2, 2);
+    assert(!g(2, 2));
+
+    g.remove_vertex(1);
+    g.compact();
+    for (int u = 0; u < 3; ++u)
+      for (int v = 0; v < 3; ++v)
+        if (u != 1 || v != 1)
+          assert(connects(g, g(u, v), u, v));
+    assert(!g(1, 1));
+
+    g.remove_edges();
+    assert(!g(0, 0));
+  }
+
+// Returns the edges of g as (source, target, value) triples.
+template<typename G>
+  std::multiset<std::tuple<std::size_t, std::size_t, int>>
+  edge_triples(const G& g)
+  {
+    std::multiset<std::tuple<std::size_t, std::size_t, int>> r;
+    for (auto e : g.edges())
+      r.emplace(g.source(e), g.target(e), g(e));
+    return r;
+  }
+
+// Removing a batch of vertices leaves the same graph as removing them one
+// at a time, and leaves the remaining edges removable by handle.
+template<typename G>
+  void
+  check_remove_vertices()
+  {
+    cout << "*** remove vertices (" << typestr<G>() << ") ***\n";
+    for (bool ordered : {false, true}) {
+      G g1 = build_reflexive_bidi_clique<G>(5);
+      G g2 = g1;
+      g1.preserve_order(ordered);
+      g1.remove_vertices(std::vector<Vertex<G>> {1, 3, 1});
+      g2.remove_vertex(1);
+      g2.remove_vertex(3);
+      assert(g1.order() == 3);
+      assert(g1.size() == 12);
+      assert(edge_triples(g1) == edge_triples(g2));
+      for (auto v : g1.vertices())
+        assert(g1.degree(v) == g2.degree(v));
+
+      // Remove vertices by value.
+      g1.remove_vertices_if([&g1](Vertex<G> v) { return g1(v) == 'e'; });
+      assert(g1.order() == 2);
+      assert(g1.size() == 6);
+
+      std::vector<Edge<G>> es;
+      for (auto e : g1.edges())
+        es.push_back(e);
+      for (auto e : es)
+        g1.remove_edge(e);
+      assert(g1.empty());
+      for (auto v : g1.vertices())
+        assert(g1.degree(v) == 0);
+    }
+  }
+
+// A snapshot has the vertices and edges of the graph, renumbered densely,
+// and translates handles in both directions. It is unaffected by later
+// changes to the graph.
+template<typename G>
+  void
+  check_snapshot_of(const G& g)
+  {
+    auto s = g.snapshot();
+    const auto& c = s.graph;
+    assert(c.order() == g.order());
+    assert(c.size() == g.size());
+    for (auto v : g.vertices()) {
+      auto w = Vertex<G>(s.dense.vertices[v]);
+      assert(Vertex<G>(s.original.vertices[w]) == v);
+      assert(c(w) == g(v));
+      assert(c.degree(w) == g.degree(v));
+    }
+    for (auto e : g.edges()) {
+      auto f = Edge<G>(s.dense.edges[e]);
+      assert(Edge<G>(s.original.edges[f]) == e);
+      assert(c(f) == g(e));
+      assert(c.source(f) == Vertex<G>(s.dense.vertices[g.source(e)]));
+      assert(c.target(f) == Vertex<G>(s.dense.vertices[g.target(e)]));
+    }
+  }
+
+template<typename G>
+  void
+  check_snapshot()
+  {
+    cout << "*** snapshot (" << typestr<G>() << ") ***\n";
+    G g = build_reflexive_bidi_clique<G>(5);
+    g.remove_vertex(1);
+    g.remove_edge(g(3, 3));
+    check_snapshot_of(g);
+
+    auto s = g.snapshot();
+    assert(s.dense.vertices[1] == handle::npos);
+    g.remove_edges();
+    assert(s.graph.size() == 19);
+
+    // A graph large enough to be divided among threads.
+    G h;
+    for (int i = 0; i < 20000; ++i)
+      h.add_vertex('a' + i % 26);
+    for (int i = 0; i < 20000; ++i) {
+      h.add_edge(i, (i * 7 + 1) % 20000, i);
+      h.add_edge(i, i, -i);
+    }
+    for (int i = 0; i < 20000; i += 3)
+      h.remove_vertex(i);
+    check_snapshot_of(h);
+
+    // Freezing moves the graph into the snapshot.
+    std::size_t n = h.order();
+    std::size_t m = h.size();
+    auto t = h.freeze();
+    assert(h.null());
+    assert(t.graph.order() == n);
+    assert(t.graph.size() == m);
+  }
+
 int main()
 {
   trace_insert();
@@ -48,21 +328,174 @@ int main()
   check_default_init<G>();
   check_add_vertices<G>();
   check_add_edges<G>();
+  check_assign_edges<G>();
+  check_reserve<G>();
   check_remove_specific_edge<G>();
   check_remove_first_simple_edge<G>();
   check_remove_first_multi_edge<G>();
   check_remove_multi_edge<G>();
   check_remove_vertex_edges<G>();
   check_remove_all_edges<G>();
+  check_ordered_removal<G>();
+  check_remove_vertices<G>();
+  check_compact<G>();
 
   using D = directed_adjacency_list<char, int>;
   check_default_init<D>();
   check_add_vertices<D>();
   check_add_edges<D>();
+  check_assign_edges<D>();
+  check_reserve<D>();
   check_remove_specific_edge<D>();
   check_remove_first_simple_edge<D>();
   check_remove_first_multi_edge<D>();
   check_remove_multi_edge<D>();
   check_remove_vertex_edges<D>();
   check_remove_all_edges<G>();
+  check_ordered_removal<D>();
+  check_remove_vertices<D>();
+  check_compact<D>();
+
+  // The same tests, using the SoA storage policy.
+  using SG = undirected_adjacency_list<char, int, adjacency_list_impl::soa_pool>;
+  check_default_init<SG>();
+  check_add_vertices<SG>();
+  check_add_edges<SG>();
+  check_assign_edges<SG>();
+  check_reserve<SG>();
+  check_remove_specific_edge<SG>();
+  check_remove_first_simple_edge<SG>();
+  check_remove_first_multi_edge<SG>();
+  check_remove_multi_edge<SG>();
+  check_remove_vertex_edges<SG>();
+  check_remove_all_edges<SG>();
+  check_ordered_removal<SG>();
+  check_remove_vertices<SG>();
+  check_compact<SG>();
+
+  using SD = directed_adjacency_list<char, int, adjacency_list_impl::soa_pool>;
+  check_default_init<SD>();
+  check_add_vertices<SD>();
+  check_add_edges<SD>();
+  check_assign_edges<SD>();
+  check_reserve<SD>();
+  check_remove_specific_edge<SD>();
+  check_remove_first_simple_edge<SD>();
+  check_remove_first_multi_edge<SD>();
+  check_remove_multi_edge<SD>();
+  check_remove_vertex_edges<SD>();
+  check_remove_all_edges<SD>();
+  check_ordered_removal<SD>();
+  check_remove_vertices<SD>();
+  check_compact<SD>();
+
+  // Generational handles, with both storage layouts.
+  using GG = undirected_adjacency_list<char, int, adjacency_list_impl::generational_pool>;
+  check_remove_vertex_edges<GG>();
+  check_compact<GG>();
+  check_stamped<GG>();
+
+  using GD = directed_adjacency_list<char, int, generational_soa_pool>;
+  check_remove_vertex_edges<GD>();
+  check_compact<GD>();
+  check_stamped<GD>();
+
+  // The same tests, using a hashed edge index.
+  using HG = undirected_adjacency_list<char, int, adjacency_list_impl::pool,
+                                       adjacency_list_impl::hash_edge_index>;
+  check_default_init<HG>();
+  check_add_vertices<HG>();
+  check_add_edges<HG>();
+  check_assign_edges<HG>();
+  check_reserve<HG>();
+  check_remove_specific_edge<HG>();
+  check_remove_first_simple_edge<HG>();
+  check_remove_first_multi_edge<HG>();
+  check_remove_multi_edge<HG>();
+  check_remove_vertex_edges<HG>();
+  check_remove_all_edges<HG>();
+  check_ordered_removal<HG>();
+  check_remove_vertices<HG>();
+  check_compact<HG>();
+  check_indexed_lookup<HG>();
+  check_indexed_lookup<G>();
+
+  using HD = directed_adjacency_list<char, int, adjacency_list_impl::pool,
+                                     adjacency_list_impl::hash_edge_index>;
+  check_default_init<HD>();
+  check_add_vertices<HD>();
+  check_add_edges<HD>();
+  check_assign_edges<HD>();
+  check_reserve<HD>();
+  check_remove_specific_edge<HD>();
+  check_remove_first_simple_edge<HD>();
+  check_remove_first_multi_edge<HD>();
+  check_remove_multi_edge<HD>();
+  check_remove_vertex_edges<HD>();
+  check_remove_all_edges<HD>();
+  check_ordered_removal<HD>();
+  check_remove_vertices<HD>();
+  check_compact<HD>();
+  check_indexed_lookup<HD>();
+  check_indexed_lookup<D>();
+
+  check_snapshot<G>();
+  check_snapshot<D>();
+  check_snapshot<SD>();
+  check_snapshot<GG>();
+  check_snapshot<HG>();
+
+  // Graphs with 32-bit handles.
+  using NG = undirected_adjacency_list<char, int, adjacency_list_impl::pool,
+                                       adjacency_list_impl::hash_edge_index,
+                                       std::uint32_t>;
+  check_default_init<NG>();
+  check_add_vertices<NG>();
+  check_add_edges<NG>();
+  check_assign_edges<NG>();
+  check_reserve<NG>();
+  check_remove_specific_edge<NG>();
+  check_remove_first_simple_edge<NG>();
+  check_remove_first_multi_edge<NG>();
+  check_remove_multi_edge<NG>();
+  check_remove_vertex_edges<NG>();
+  check_remove_all_edges<NG>();
+  check_ordered_removal<NG>();
+  check_remove_vertices<NG>();
+  check_compact<NG>();
+  check_indexed_lookup<NG>();
+  check_snapshot<NG>();
+
+  using ND = directed_adjacency_list<char, int, adjacency_list_impl::soa_pool,
+                                     adjacency_list_impl::linear_edge_index,
+                                     std::uint32_t>;
+  check_default_init<ND>();
+  check_add_vertices<ND>();
+  check_add_edges<ND>();
+  check_assign_edges<ND>();
+  check_reserve<ND>();
+  check_remove_specific_edge<ND>();
+  check_remove_first_simple_edge<ND>();
+  check_remove_first_multi_edge<ND>();
+  check_remove_multi_edge<ND>();
+  check_remove_vertex_edges<ND>();
+  check_remove_all_edges<ND>();
+  check_ordered_removal<ND>();
+  check_remove_vertices<ND>();
+  check_compact<ND>();
+  check_indexed_lookup<ND>();
+  check_snapshot<ND>();
+
+  using NGD = directed_adjacency_list<char, int, adjacency_list_impl::generational_pool,
+                                      adjacency_list_impl::linear_edge_index,
+                                      std::uint32_t>;
+  check_compact<NGD>();
+  check_stamped<NGD>();
+
+  // Narrow handles halve the incidence lists' handles, so twice as many
+  // edges are stored inline.
+  static_assert(sizeof(NG::edge) == 4, "");
+  static_assert(adjacency_list_impl::basic_edge_list<std::uint32_t>::inline_capacity == 6, "");
+  static_assert(sizeof(adjacency_list_impl::basic_edge_list<std::uint32_t>) ==
+                sizeof(adjacency_list_impl::edge_list), "");
 }
@@ -1,10 +1,6 @@
 // Copyright (c) 2009-2015 Andrew Sutton
 // All rights reserved
 
-int main() { }
-
-#if 0
-
 #include <cassert>
 #include <iostream>
 
@@ -15,30 +11,16 @@ using namespace origin;
 using namespace origin::adjacency_list_impl;
 
 
-template<typename Q>
-  struct hack_queue : Q
-  {
-    using Q::c;
-    using Q::comp;
-  };
-
-template<typename Q>
-  const hack_queue<Q>&
-  hack(const Q& q)
-  {
-    return reinterpret_cast<const hack_queue<Q>&>(q);
-  }
-
 template<typename P>
   void
-  print_queue(const P& p)
+  print_free(const P& p)
   {
-    using Hack = hack_queue<typename P::queue_type>;
-    const Hack& q = hack(p.free());
+    const free_index_set& f = p.free();
 
     cout << "free: ";
-    for (const auto& x : q.c)
-      cout << x << ' ';
+    for (size_t i = 0; i < p.data().size(); ++i)
+      if (f.contains(i))
+        cout << i << ' ';
     cout << '\n';
   }
 
@@ -73,7 +55,7 @@ template<typename P>
   void debug_pool(P&& p)
   {
     print_pool(p);
-    print_queue(p);
+    print_free(p);
     print_live(p);
     // print_live((const P&)p);
     cout << "-----\n";
@@ -191,6 +173,223 @@ check_pool_yoyo_rl()
   debug_pool(p);
 }
 
+void
+check_free_set()
+{
+  free_index_set s;
+  assert(s.empty());
+  assert(s.front() == free_index_set::npos);
+
+  s.insert(5);
+  s.insert(3);
+  s.insert(70);
+  assert(s.size() == 3);
+  assert(s.contains(3) && s.contains(5) && s.contains(70));
+  assert(!s.contains(4));
+  assert(s.take() == 3);
+  assert(s.take() == 5);
+  assert(s.take() == 70);
+  assert(s.empty());
+}
+
+// Exercise multiple levels of the bitmap by inserting indexes spread over
+// more than 64 * 64 slots.
+void
+check_free_set_large()
+{
+  free_index_set s;
+  for (size_t i = 0; i < 100000; i += 7)
+    s.insert(i);
+  s.insert(1 << 20);
+  assert(s.depth() == 4);
+  for (size_t i = 0; i < 100000; i += 7)
+    assert(s.take() == i);
+  assert(s.take() == (1 << 20));
+  assert(s.empty());
+}
+
+// Erased indexes are reused least first.
+void
+check_pool_least_reuse()
+{
+  pool<int> p;
+  for (int i = 0; i < 200; ++i)
+    p.insert(i);
+  p.erase(150);
+  p.erase(3);
+  p.erase(64);
+  assert(p.insert(0) == 3);
+  assert(p.insert(0) == 64);
+  assert(p.insert(0) == 150);
+  assert(p.insert(0) == 200);
+}
+
+// Compaction moves live objects to the front of the pool and reports
+// where they went.
+void
+check_pool_compact()
+{
+  pool<int> p;
+  for (int i = 0; i < 10; ++i)
+    p.insert(i);
+  p.erase(0);
+  p.erase(4);
+  p.erase(9);
+
+  vector<size_t> map = p.compact();
+  debug_pool(p);
+  assert(p.size() == 7);
+  assert(p.data().size() == 7);
+  assert(p.free().empty());
+  assert(map[0] == pool<int>::npos);
+  assert(map[1] == 0);
+  assert(map[5] == 3);
+  assert(map[8] == 6);
+  for (size_t i = 0; i < map.size(); ++i)
+    if (map[i] != pool<int>::npos)
+      assert(p[map[i]] == int(i));
+
+  // Subsequent insertions append.
+  assert(p.insert(42) == 7);
+}
+
+// The SoA pool has the same reuse and compaction behavior as the node
+// pool. Use strings to check that objects are relocated correctly.
+void
+check_soa_pool()
+{
+  soa_pool<string> p;
+  for (int i = 0; i < 100; ++i)
+    p.insert(string(32, 'a' + i % 26));
+  p.erase(0);
+  p.erase(50);
+  p.erase(99);
+  assert(p.size() == 97);
+  assert(p.insert("x") == 0);
+  assert(p.insert("y") == 50);
+  assert(p.insert("z") == 99);
+  assert(p[50] == "y");
+
+  soa_pool<string> q = p;
+  q.erase(1);
+  q.erase(2);
+  vector<size_t> map = q.compact();
+  assert(q.size() == 98);
+  assert(map[1] == soa_pool<string>::npos);
+  assert(q[map[50]] == "y");
+  assert(q[97] == "z");
+
+  size_t n = 0;
+  for (const string& s : q)
+    assert(&s == &q[n++]);
+  assert(n == 98);
+
+  // Iteration skips free indexes across word boundaries of the free set.
+  soa_pool<int> r;
+  for (int i = 0; i < 200; ++i)
+    r.insert(i);
+  for (int i : {0, 1, 63, 64, 65, 127, 128, 190, 199})
+    r.erase(i);
+  for (int i = 130; i < 190; ++i)
+    r.erase(i);
+  int last = -1;
+  n = 0;
+  for (int x : r) {
+    assert(x > last && x != 64 && !(x >= 130 && x <= 190) && x != 199);
+    last = x;
+    ++n;
+  }
+  assert(n == r.size() && last == 198);
+
+  // Inserting a copy of an element into a full pool copies the element
+  // before it is relocated.
+  soa_pool<string> s;
+  s.insert(string(100, 'a'));
+  for (int i = 0; i < 16; ++i) {
+    size_t k = s.insert(s[s.size() - 1]);
+    assert(s[k] == string(100, 'a'));
+  }
+  assert(s.size() == 17 && s.capacity() == 32);
+  for (const string& x : s)
+    assert(x == string(100, 'a'));
+}
+
+
+// The hash index finds every inserted edge, including parallel edges,
+// through growth and backward-shift erasure.
+void
+check_hash_index()
+{
+  hash_edge_index x;
+  assert(x.find(0, 1) == hash_edge_index::npos);
+  size_t e = 0;
+  for (size_t u = 0; u < 50; ++u)
+    for (size_t v = 0; v < 50; ++v)
+      x.insert(u, v, e++);
+  x.insert(3, 4, e++); // A parallel edge
+  assert(x.size() == 2501);
+
+  for (size_t u = 0; u < 50; ++u)
+    for (size_t v = 0; v < 50; ++v)
+      assert(x.find(u, v) == u * 50 + v || (u == 3 && v == 4));
+
+  // Erase every other edge, and one of the parallel edges.
+  for (size_t u = 0; u < 50; ++u)
+    for (size_t v = u % 2; v < 50; v += 2)
+      x.erase(u, v, u * 50 + v);
+  x.erase(3, 4, 2500);
+  assert(x.size() == 1250);
+  for (size_t u = 0; u < 50; ++u)
+    for (size_t v = 0; v < 50; ++v) {
+      if ((u + v) % 2 == 0)
+        assert(x.find(u, v) == hash_edge_index::npos);
+      else
+        assert(x.find(u, v) == u * 50 + v);
+    }
+
+  x.clear();
+  assert(x.empty());
+  assert(x.find(1, 0) == hash_edge_index::npos);
+}
+
+// Small vectors store elements inline until they outgrow their buffer, and
+// copy, move, and swap correctly in every combination of storage.
+void
+check_small_vector()
+{
+  using V = small_vector<size_t, 3>;
+  V a;
+  assert(a.empty() && a.is_inline());
+  for (size_t i = 0; i < 3; ++i)
+    a.push_back(i);
+  assert(a.is_inline());
+  a.push_back(3);
+  assert(!a.is_inline());
+  assert(a.size() == 4 && a.capacity() == 6);
+  for (size_t i = 0; i < 4; ++i)
+    assert(a[i] == i);
+
+  V b {7, 8};
+  a.swap(b);
+  assert(a.is_inline() && a.size() == 2 && a[1] == 8);
+  assert(!b.is_inline() && b.size() == 4 && b[3] == 3);
+
+  V c = b;
+  assert(c.size() == 4 && c[2] == 2);
+  V d = std::move(b);
+  assert(b.empty() && b.is_inline());
+  assert(d.size() == 4 && d[0] == 0);
+
+  d.erase(d.begin() + 1);
+  assert(d.size() == 3 && d[1] == 2 && d[2] == 3);
+  d.shrink_to_fit();
+  assert(d.is_inline() && d[2] == 3);
+
+  d.push_back(d[0]); // Growth when inserting an element of the vector
+  assert(d.size() == 4 && d[3] == 0);
+  c = a;
+  assert(c.size() == 2 && c[0] == 7 && c[1] == 8);
+}
 
 int main()
 {
@@ -201,6 +400,11 @@ int main()
   check_pool_reuse();
   check_pool_yoyo_lr();
   check_pool_yoyo_rl();
+  check_free_set();
+  check_free_set_large();
+  check_pool_least_reuse();
+  check_pool_compact();
+  check_soa_pool();
+  check_hash_index();
+  check_small_vector();
 }
-
-#endif
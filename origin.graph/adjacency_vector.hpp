@@ -23,68 +23,21 @@
 #include <origin.graph/io.hpp>
 
 #include <origin.graph/adjacency_list.impl/pool.hpp>
+#include <origin.graph/adjacency_list.impl/handle_range.hpp>
+#include <origin.graph/adjacency_list.impl/small_vector.hpp>
+#include <origin.graph/adjacency_list.impl/edge_input.hpp>
+#include <origin.graph/adjacency_list.impl/capacity.hpp>
 
 namespace origin
 {
 
   namespace adjacency_vector_impl
   {
-
-    // The handle iterator wraps a constant iterator of the container type C and
-    // returns handles of type H when dereferenced.
-    //
-    // TODO: Make this a random access iterator.
-    template<typename T, typename H>
-      struct handle_counter
-      {
-        using handle_type = H;
-        using counter_type = T;
-
-        handle_counter(counter_type n)
-          : count(n)
-        { }
-
-        handle_type operator*() const { H(count); }
-
-        handle_counter& operator++();
-        handle_counter  operator++(int);
-
-        T count;
-      };
-
-
-    template<typename C, typename H>
-      inline handle_counter<C, H>&
-      handle_counter<C, H>::operator++()
-      {
-        ++count;
-        return *this;
-      }
-
-    template<typename C, typename H>
-      inline handle_counter<C, H>
-      handle_counter<C, H>::operator++(int)
-      {
-        handle_counter tmp = *this;
-        ++count;
-        return tmp;
-      }
-
-    // Equality
-    template<typename C, typename H>
-      inline bool
-      operator==(const handle_counter<C, H>& a, const handle_counter<C, H>& b)
-      {
-        return a.count == b.count;
-      }
-
-    template<typename C, typename H>
-      inline bool
-      operator!=(const handle_counter<C, H>& a, const handle_counter<C, H>& b)
-      {
-        return a.count != b.count;
-      }
-
+    // Vertices and edges are stored in vectors, so their handles are the
+    // contiguous indexes [0, n). Vertex and edge ranges are handle ranges,
+    // which can be split in constant time.
+    using adjacency_list_impl::handle_counter;
+    using adjacency_list_impl::handle_range;
 
     // ---------------------------------------------------------------------- //
     //                            Edge Representation
@@ -95,57 +48,64 @@ namespace origin
     //
     // In an undirected adjacency list, the source and target vertices refer to
     // the vertices in the order they were specified on addition. There is no
-    // other meaning attributed to them.
-    template<typename E>
+    // other meaning attributed to them. The endpoints are stored as handles
+    // of width S.
+    template<typename E, typename S = std::size_t>
       struct edge
       {
         using value_type = E;
+        using index_type = S;
+        using vertex_type = basic_vertex_handle<S>;
 
         edge()
           : data(-1, -1, E{})
         { }
 
-        edge(vertex_handle s, vertex_handle t)
+        edge(vertex_type s, vertex_type t)
           : data(s, t, E{})
         { }
 
         template<typename... Args>
-          edge(vertex_handle s, vertex_handle t, Args&&... args)
+          edge(vertex_type s, vertex_type t, Args&&... args)
             : data(s, t, std::forward<Args>(args)...)
           { }
 
-        vertex_handle& source()       { return std::get<0>(data); }
-        vertex_handle  source() const { return std::get<0>(data); }
+        vertex_type& source()       { return std::get<0>(data); }
+        vertex_type  source() const { return std::get<0>(data); }
 
-        vertex_handle& target()       { return std::get<1>(data); }
-        vertex_handle  target() const { return std::get<1>(data); }
+        vertex_type& target()       { return std::get<1>(data); }
+        vertex_type  target() const { return std::get<1>(data); }
 
         E&       value()       { return std::get<2>(data); }
         const E& value() const { return std::get<2>(data); }
 
-        std::tuple<vertex_handle, vertex_handle,  E> data;
+        std::tuple<vertex_type, vertex_type,  E> data;
       };
 
-    // An (incident) edge list is a vector of indexes.
-    using edge_list = std::vector<edge_handle>;
+    // An (incident) edge list is a vector of indexes. See the adjacency
+    // list for the choice of inline capacity.
+    template<typename S>
+      using edge_list = adjacency_list_impl::small_vector<basic_edge_handle<S>, 24 / sizeof(S)>;
 
     // An alias for the edge pool.
-    template<typename E>
-      using edge_set = std::vector<edge<E>>;
+    template<typename E, typename S>
+      using edge_set = std::vector<edge<E, S>>;
 
     // An alias for the edge iterator.
-    template<typename E>
-      using edge_iterator = handle_counter<std::size_t, edge_handle>;
+    template<typename E, typename S>
+      using edge_iterator = handle_counter<std::size_t, basic_edge_handle<S>>;
 
     // An alias for the edge range.
-    template<typename E>
-      using edge_range = bounded_range<edge_iterator<E>>;
+    template<typename E, typename S>
+      using edge_range = handle_range<basic_edge_handle<S>>;
 
     // An alias for the incident edge iterator.
-    using incidence_iterator = typename edge_list::const_iterator;
+    template<typename S>
+      using incidence_iterator = typename edge_list<S>::const_iterator;
 
     // An alias for the icident edge range.
-    using incidence_range = bounded_range<incidence_iterator>;
+    template<typename S>
+      using incidence_range = bounded_range<incidence_iterator<S>>;
 
   } // namespace adjacency_vector_impl
 
@@ -166,7 +126,7 @@ namespace origin
   {
     // Imports
     using adjacency_vector_impl::handle_counter;
-    using adjacency_vector_impl::edge_list;
+    using adjacency_vector_impl::handle_range;
 
 
     // ---------------------------------------------------------------------- //
@@ -177,10 +137,13 @@ namespace origin
     // separate edge container.
     //
     // Note that the class will compress the value type if it is empty.
-    template<typename V>
+    template<typename V, typename S = std::size_t>
       struct vertex
       {
         using value_type = V;
+        using index_type = S;
+        using edge_list = adjacency_vector_impl::edge_list<S>;
+        using edge_handle = basic_edge_handle<S>;
         using iterator = typename edge_list::iterator;
         using const_iterator = typename edge_list::const_iterator;
 
@@ -233,24 +196,24 @@ namespace origin
         std::tuple<edge_list, edge_list, V> data;
       };
 
-    template<typename V>
+    template<typename V, typename S>
       inline void
-      vertex<V>::insert_edge(edge_list& l, edge_handle e)
+      vertex<V, S>::insert_edge(edge_list& l, edge_handle e)
       {
         l.push_back(e);
       }
 
     // A vertex set simply a vector of vertices.
-    template<typename V>
-      using vertex_set = std::vector<vertex<V>>;
+    template<typename V, typename S>
+      using vertex_set = std::vector<vertex<V, S>>;
 
     // An alias for the vertex iterator.
-    template<typename V>
-      using vertex_iterator = handle_counter<std::size_t, vertex_handle>;
+    template<typename V, typename S>
+      using vertex_iterator = handle_counter<std::size_t, basic_vertex_handle<S>>;
 
     // An alias for the vertex range.
-    template<typename V>
-      using vertex_range = bounded_range<vertex_iterator<V>>;
+    template<typename V, typename S>
+      using vertex_range = handle_range<basic_vertex_handle<S>>;
 
 
   } // namespace directed_adjacency_vector_impl
@@ -258,29 +221,43 @@ namespace origin
 
 
   // Implementation of a diretected adjacency list.
-  template<typename V = empty_t, typename E = empty_t>
+  template<typename V = empty_t, typename E = empty_t, typename Size = std::size_t>
     class directed_adjacency_vector
     {
-      using this_type = directed_adjacency_vector<V, E>;
+      using this_type = directed_adjacency_vector<V, E, Size>;
 
-      using vertex_node = directed_adjacency_vector_impl::vertex<V>;
-      using vertex_set = directed_adjacency_vector_impl::vertex_set<V>;
-      using vertex_iter = directed_adjacency_vector_impl::vertex_iterator<V>;
+      using vertex_node = directed_adjacency_vector_impl::vertex<V, Size>;
+      using vertex_set = directed_adjacency_vector_impl::vertex_set<V, Size>;
+      using vertex_iter = directed_adjacency_vector_impl::vertex_iterator<V, Size>;
 
-      using edge_node = adjacency_vector_impl::edge<E>;
-      using edge_set = adjacency_vector_impl::edge_set<E>;
-      using edge_iter = adjacency_vector_impl::edge_iterator<E>;
+      using edge_node = adjacency_vector_impl::edge<E, Size>;
+      using edge_set = adjacency_vector_impl::edge_set<E, Size>;
+      using edge_iter = adjacency_vector_impl::edge_iterator<E, Size>;
 
-      using incidence_iter = adjacency_vector_impl::incidence_iterator;
+      using edge_list = adjacency_vector_impl::edge_list<Size>;
+      using incidence_iter = adjacency_vector_impl::incidence_iterator<Size>;
     public:
-      using vertex = vertex_handle;
-      using vertex_range = directed_adjacency_vector_impl::vertex_range<V>;
+      using size_type = Size;
+
+      using vertex = basic_vertex_handle<Size>;
+      using vertex_range = directed_adjacency_vector_impl::vertex_range<V, Size>;
 
-      using edge = edge_handle;
-      using edge_range = adjacency_vector_impl::edge_range<E>;
+      using edge = basic_edge_handle<Size>;
+      using edge_range = adjacency_vector_impl::edge_range<E, Size>;
 
-      using incidence_range = adjacency_vector_impl::incidence_range;
+      using incidence_range = adjacency_vector_impl::incidence_range<Size>;
 
+      using capacity_type = adjacency_list_impl::graph_capacity;
+
+
+      // Construction
+      directed_adjacency_vector() = default;
+
+      template<typename I>
+        directed_adjacency_vector(I first, I last, std::size_t n = 0);
+
+      template<typename I>
+        void assign_edges(I first, I last, std::size_t n = 0);
 
       // Observers
       bool        null() const  { return verts_.empty(); }
@@ -289,6 +266,14 @@ namespace origin
       bool        empty() const { return edges_.empty(); }
       std::size_t size() const  { return edges_.size(); }
 
+      // Capacity
+      capacity_type capacity() const;
+      void reserve_vertices(std::size_t n);
+      void reserve_edges(std::size_t m);
+      void reserve_out(vertex v, std::size_t k);
+      void reserve_in(vertex v, std::size_t k);
+      void shrink_to_fit();
+
       // Vertex observers
       std::size_t out_degree(vertex v) const { return node(v).out_degree(); }
       std::size_t in_degree(vertex v) const  { return node(v).in_degree(); }
@@ -351,9 +336,9 @@ namespace origin
       edge_set   edges_;
     };
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename Size>
     inline auto
-    directed_adjacency_vector<V, E>::operator()(vertex u, vertex v) const -> edge
+    directed_adjacency_vector<V, E, Size>::operator()(vertex u, vertex v) const -> edge
     {
       if (out_degree(u) <= in_degree(v))
         return find_out_edge(u, v);
@@ -361,60 +346,98 @@ namespace origin
         return find_in_edge(u, v);
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename Size>
     inline auto
-    directed_adjacency_vector<V, E>::find_out_edge(vertex u, vertex v) const -> edge
+    directed_adjacency_vector<V, E, Size>::find_out_edge(vertex u, vertex v) const -> edge
     {
       using P = has_target<this_type>;
       const vertex_node& n = node(u);
       return find_edge(n.out(), P(*this, v));
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename Size>
     inline auto
-    directed_adjacency_vector<V, E>::find_in_edge(vertex u, vertex v) const -> edge
+    directed_adjacency_vector<V, E, Size>::find_in_edge(vertex u, vertex v) const -> edge
     {
       using P = has_source<this_type>;
       const vertex_node& n = node(v);
       return find_edge(n.in(), P(*this, u));
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename Size>
     template<typename S, typename P>
     inline auto
-    directed_adjacency_vector<V, E>::find_edge(const S& seq, P pred) const -> edge
+    directed_adjacency_vector<V, E, Size>::find_edge(const S& seq, P pred) const -> edge
     {
       auto i = find_if(seq, pred);
       return i == seq.end() ? edge() : *i;
     }
 
+  // Construct a graph from the input edges in [first, last), with at least
+  // n vertices. See assign_edges for details.
+  template<typename V, typename E, typename Size>
+    template<typename I>
+      inline
+      directed_adjacency_vector<V, E, Size>::directed_adjacency_vector(I first, I last, std::size_t n)
+      {
+        assign_edges(first, last, n);
+      }
+
+  // Replace the contents of the graph with the input edges in [first, last).
+  // Each input edge is a pair (u, v) or a tuple (u, v, x), where x is the
+  // value of the edge. The graph has at least n vertices, and at least one
+  // more than the greatest endpoint. Vertex values are default constructed.
+  //
+  // The range is traversed twice. The first pass counts the degree of each
+  // vertex, so that the vertex set, the edge set, and every incidence list
+  // are allocated exactly once. The second pass adds the edges.
+  template<typename V, typename E, typename Size>
+    template<typename I>
+      void
+      directed_adjacency_vector<V, E, Size>::assign_edges(I first, I last, std::size_t n)
+      {
+        adjacency_list_impl::degree_count c =
+          adjacency_list_impl::count_degrees(first, last, n);
+        verts_.clear();
+        edges_.clear();
+        verts_.reserve(c.order);
+        edges_.reserve(c.size);
+        for (std::size_t i = 0; i < c.order; ++i) {
+          vertex_node& vn = node(add_vertex());
+          vn.out().reserve(c.out[i]);
+          vn.in().reserve(c.in[i]);
+        }
+        for ( ; first != last; ++first)
+          adjacency_list_impl::emplace_input(*this, *first);
+      }
+
   // Add a vertex to the graph, returning a handle to the new object. If
   // V is a user-supplied type, its value is default constructed.
-  template<typename V, typename E>
+  template<typename V, typename E, typename Size>
     inline auto
-    directed_adjacency_vector<V, E>::add_vertex() -> vertex
+    directed_adjacency_vector<V, E, Size>::add_vertex() -> vertex
     {
       return emplace_vertex();
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename Size>
     inline auto
-    directed_adjacency_vector<V, E>::add_vertex(V&& x) -> vertex
+    directed_adjacency_vector<V, E, Size>::add_vertex(V&& x) -> vertex
     {
       return emplace_vertex(std::move(x));
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename Size>
     inline auto
-    directed_adjacency_vector<V, E>::add_vertex(const V& x) -> vertex
+    directed_adjacency_vector<V, E, Size>::add_vertex(const V& x) -> vertex
     {
       return emplace_vertex(x);
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename Size>
     template<typename... Args>
       inline auto
-      directed_adjacency_vector<V, E>::emplace_vertex(Args&&... args) -> vertex
+      directed_adjacency_vector<V, E, Size>::emplace_vertex(Args&&... args) -> vertex
       {
         vertex n = verts_.size();
         verts_.emplace_back(std::forward<Args>(args)...);
@@ -423,34 +446,34 @@ namespace origin
 
 
   // Add a defaul edge from u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename Size>
     inline auto
-    directed_adjacency_vector<V, E>::add_edge(vertex u, vertex v) -> edge
+    directed_adjacency_vector<V, E, Size>::add_edge(vertex u, vertex v) -> edge
     {
       return emplace_edge(u, v);
     }
 
   // Move x into an edge connecting u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename Size>
     inline auto
-    directed_adjacency_vector<V, E>::add_edge(vertex u, vertex v, E&& x) -> edge
+    directed_adjacency_vector<V, E, Size>::add_edge(vertex u, vertex v, E&& x) -> edge
     {
       return emplace_edge(u, v, std::move(x));
     }
 
   // Copy x into an edge connecting u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename Size>
     inline auto
-    directed_adjacency_vector<V, E>::
+    directed_adjacency_vector<V, E, Size>::
       add_edge(vertex u, vertex v, const E& x) -> edge
     {
       return emplace_edge(u, v, x);
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename Size>
     template<typename... Args>
       inline auto
-      directed_adjacency_vector<V, E>::
+      directed_adjacency_vector<V, E, Size>::
         emplace_edge(vertex u, vertex v, Args&&... args) -> edge
       {
         edge e = edges_.size();
@@ -459,9 +482,9 @@ namespace origin
         return e;
       }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename Size>
     inline void
-    directed_adjacency_vector<V, E>::link_edge(vertex u, vertex v, edge e)
+    directed_adjacency_vector<V, E, Size>::link_edge(vertex u, vertex v, edge e)
     {
       vertex_node& un = node(u);
       vertex_node& vn = node(v);
@@ -470,34 +493,93 @@ namespace origin
     }
 
 
+  // Returns the number of vertices, edges, and incident edges for which
+  // storage has been allocated.
+  template<typename V, typename E, typename Size>
+    auto
+    directed_adjacency_vector<V, E, Size>::capacity() const -> capacity_type
+    {
+      capacity_type c {verts_.capacity(), edges_.capacity(), 0};
+      for (const vertex_node& n : verts_)
+        c.incidence += n.out().capacity() + n.in().capacity();
+      return c;
+    }
+
+  // Ensure that n vertices can be stored without reallocating the vertex
+  // set.
+  template<typename V, typename E, typename Size>
+    inline void
+    directed_adjacency_vector<V, E, Size>::reserve_vertices(std::size_t n)
+    {
+      verts_.reserve(n);
+    }
+
+  // Ensure that m edges can be stored without reallocating the edge set.
+  template<typename V, typename E, typename Size>
+    inline void
+    directed_adjacency_vector<V, E, Size>::reserve_edges(std::size_t m)
+    {
+      edges_.reserve(m);
+    }
+
+  // Ensure that the vertex v can have k out (or in) edges without
+  // reallocating its incidence list.
+  template<typename V, typename E, typename Size>
+    inline void
+    directed_adjacency_vector<V, E, Size>::reserve_out(vertex v, std::size_t k)
+    {
+      node(v).out().reserve(k);
+    }
+
+  template<typename V, typename E, typename Size>
+    inline void
+    directed_adjacency_vector<V, E, Size>::reserve_in(vertex v, std::size_t k)
+    {
+      node(v).in().reserve(k);
+    }
+
+  // Release unused storage in the vertex set, the edge set, and every
+  // incidence list.
+  template<typename V, typename E, typename Size>
+    void
+    directed_adjacency_vector<V, E, Size>::shrink_to_fit()
+    {
+      for (vertex_node& n : verts_) {
+        n.out().shrink_to_fit();
+        n.in().shrink_to_fit();
+      }
+      verts_.shrink_to_fit();
+      edges_.shrink_to_fit();
+    }
+
   // Retrun a range over the vertex set.
-  template<typename V, typename E>
+  template<typename V, typename E, typename Size>
     inline auto
-    directed_adjacency_vector<V, E>::vertices() const -> vertex_range
+    directed_adjacency_vector<V, E, Size>::vertices() const -> vertex_range
     {
-      return {vertex_iter(verts_.begin()), vertex_iter(verts_.end())};
+      return {0, verts_.size()};
     }
 
   // Return a range over the edge set.
-  template<typename V, typename E>
+  template<typename V, typename E, typename Size>
     inline auto
-    directed_adjacency_vector<V, E>::edges() const -> edge_range
+    directed_adjacency_vector<V, E, Size>::edges() const -> edge_range
     {
-      return {edge_iter(edges_.begin()), edge_iter(edges_.end())};
+      return {0, edges_.size()};
     }
 
   // Return a range over the out edges of the vertex v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename Size>
     inline auto
-    directed_adjacency_vector<V, E>::out_edges(vertex v) const -> incidence_range
+    directed_adjacency_vector<V, E, Size>::out_edges(vertex v) const -> incidence_range
     {
       const vertex_node& vn = node(v);
       return {incidence_iter(vn.begin_out()), incidence_iter(vn.end_out())};
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename Size>
     inline auto
-    directed_adjacency_vector<V, E>::in_edges(vertex v) const -> incidence_range
+    directed_adjacency_vector<V, E, Size>::in_edges(vertex v) const -> incidence_range
     {
       const vertex_node& vn = node(v);
       return {incidence_iter(vn.begin_in()), incidence_iter(vn.end_in())};
@@ -514,17 +596,20 @@ namespace origin
   namespace undirected_adjacency_vector_impl
   {
     using origin::adjacency_vector_impl::handle_counter;
-    using origin::adjacency_vector_impl::edge_list;
+    using origin::adjacency_vector_impl::handle_range;
 
     // ---------------------------------------------------------------------- //
     //                        Vertex Representation
 
     // A vertex in an undirected adjacency list is simply a list of incident
     // edges. No distinction is made between in or out edges.
-    template<typename V>
+    template<typename V, typename S = std::size_t>
       struct vertex
       {
         using value_type = V;
+        using index_type = S;
+        using edge_list = adjacency_vector_impl::edge_list<S>;
+        using edge_handle = basic_edge_handle<S>;
         using iterator = typename edge_list::iterator;
         using const_iterator = typename edge_list::const_iterator;
 
@@ -559,52 +644,66 @@ namespace origin
         std::tuple<edge_list, V> data;
       };
 
-    template<typename V>
+    template<typename V, typename S>
       inline void
-      vertex<V>::insert(edge_handle e)
+      vertex<V, S>::insert(edge_handle e)
       {
         edges().push_back(e);
       }
 
     // A vertex set is a vector of vertices.
-    template<typename V>
-      using vertex_set = std::vector<vertex<V>>;
+    template<typename V, typename S>
+      using vertex_set = std::vector<vertex<V, S>>;
 
     // An alias for the vertex iterator.
-    template<typename V>
-      using vertex_iterator = handle_counter<vertex_set<V>, vertex_handle>;
+    template<typename V, typename S>
+      using vertex_iterator = handle_counter<std::size_t, basic_vertex_handle<S>>;
 
     // An alias for the vertex range.
-    template<typename V>
-      using vertex_range = bounded_range<vertex_iterator<V>>;
+    template<typename V, typename S>
+      using vertex_range = handle_range<basic_vertex_handle<S>>;
 
   } // namespace undirected_adjacency_vector_impl
 
 
   // Implementation of the undirected adjacency list.
-  template<typename V = empty_t, typename E = empty_t>
+  template<typename V = empty_t, typename E = empty_t, typename Size = std::size_t>
     class undirected_adjacency_vector
     {
-      using this_type = undirected_adjacency_vector<V, E>;
+      using this_type = undirected_adjacency_vector<V, E, Size>;
 
-      using vertex_node = undirected_adjacency_vector_impl::vertex<V>;
-      using vertex_set = undirected_adjacency_vector_impl::vertex_set<V>;
-      using vertex_iter = undirected_adjacency_vector_impl::vertex_iterator<V>;
+      using vertex_node = undirected_adjacency_vector_impl::vertex<V, Size>;
+      using vertex_set = undirected_adjacency_vector_impl::vertex_set<V, Size>;
+      using vertex_iter = undirected_adjacency_vector_impl::vertex_iterator<V, Size>;
 
-      using edge_node = adjacency_vector_impl::edge<E>;
-      using edge_set = adjacency_vector_impl::edge_set<E>;
-      using edge_iter = adjacency_vector_impl::edge_iterator<E>;
+      using edge_node = adjacency_vector_impl::edge<E, Size>;
+      using edge_set = adjacency_vector_impl::edge_set<E, Size>;
+      using edge_iter = adjacency_vector_impl::edge_iterator<E, Size>;
 
-      using incidence_iter = adjacency_vector_impl::incidence_iterator;
+      using edge_list = adjacency_vector_impl::edge_list<Size>;
+      using incidence_iter = adjacency_vector_impl::incidence_iterator<Size>;
     public:
-      using vertex = vertex_handle;
-      using vertex_range = undirected_adjacency_vector_impl::vertex_range<V>;
+      using size_type = Size;
+
+      using vertex = basic_vertex_handle<Size>;
+      using vertex_range = undirected_adjacency_vector_impl::vertex_range<V, Size>;
+
+      using edge = basic_edge_handle<Size>;
+      using edge_range = adjacency_vector_impl::edge_range<E, Size>;
+
+      using incidence_range = adjacency_vector_impl::incidence_range<Size>;
+
+      using capacity_type = adjacency_list_impl::graph_capacity;
+
 
-      using edge = edge_handle;
-      using edge_range = adjacency_vector_impl::edge_range<E>;
+      // Construction
+      undirected_adjacency_vector() = default;
 
-      using incidence_range = adjacency_vector_impl::incidence_range;
+      template<typename I>
+        undirected_adjacency_vector(I first, I last, std::size_t n = 0);
 
+      template<typename I>
+        void assign_edges(I first, I last, std::size_t n = 0);
 
       // Observers
       bool        null() const  { return verts_.empty(); }
@@ -613,6 +712,13 @@ namespace origin
       bool        empty() const { return edges_.empty(); }
       std::size_t size() const  { return edges_.size(); }
 
+      // Capacity
+      capacity_type capacity() const;
+      void reserve_vertices(std::size_t n);
+      void reserve_edges(std::size_t m);
+      void reserve_incident(vertex v, std::size_t k);
+      void shrink_to_fit();
+
       // Vertex observers
       std::size_t degree(vertex v) const { return node(v).degree(); }
 
@@ -676,9 +782,9 @@ namespace origin
     };
 
   // Returns true if the an edge {u, v} is in the graph.
-  template<typename V, typename E>
+  template<typename V, typename E, typename Size>
     inline auto
-    undirected_adjacency_vector<V, E>::operator()(vertex u, vertex v) const -> edge
+    undirected_adjacency_vector<V, E, Size>::operator()(vertex u, vertex v) const -> edge
     {
       if (degree(u) <= degree(v))
         return find_edge(u, v);
@@ -692,9 +798,9 @@ namespace origin
   // Note that, if u and v are connected, then the edge was added as either
   // (u, v) or (v, u). We prefer to search the vertex with the smaller degree
   // for evidence of either construction.
-  template<typename V, typename E>
+  template<typename V, typename E, typename Size>
     inline auto
-    undirected_adjacency_vector<V, E>::find_edge(vertex u, vertex v) const -> edge
+    undirected_adjacency_vector<V, E, Size>::find_edge(vertex u, vertex v) const -> edge
     {
       using P = has_endpoints<this_type>;
       const vertex_node& n = node(v);
@@ -703,10 +809,10 @@ namespace origin
 
   // Return an edge whose endpoints satisfy the given predicate. The primary
   // function of this operation is to find endpoints with source/target pairs.
-  template<typename V, typename E>
+  template<typename V, typename E, typename Size>
     template<typename S, typename P>
       inline auto
-      undirected_adjacency_vector<V, E>::
+      undirected_adjacency_vector<V, E, Size>::
         find_endpoints(const S& seq, P pred) const -> edge
         {
           auto i = find_if(seq, pred);
@@ -714,33 +820,70 @@ namespace origin
         }
 
 
+  // Construct a graph from the input edges in [first, last), with at least
+  // n vertices. See assign_edges for details.
+  template<typename V, typename E, typename Size>
+    template<typename I>
+      inline
+      undirected_adjacency_vector<V, E, Size>::undirected_adjacency_vector(I first, I last, std::size_t n)
+      {
+        assign_edges(first, last, n);
+      }
+
+  // Replace the contents of the graph with the input edges in [first, last).
+  // Each input edge is a pair (u, v) or a tuple (u, v, x), where x is the
+  // value of the edge. The graph has at least n vertices, and at least one
+  // more than the greatest endpoint. Vertex values are default constructed.
+  //
+  // The range is traversed twice. The first pass counts the degree of each
+  // vertex, so that the vertex set, the edge set, and every incidence list
+  // are allocated exactly once. The second pass adds the edges.
+  template<typename V, typename E, typename Size>
+    template<typename I>
+      void
+      undirected_adjacency_vector<V, E, Size>::assign_edges(I first, I last, std::size_t n)
+      {
+        adjacency_list_impl::degree_count c =
+          adjacency_list_impl::count_degrees(first, last, n);
+        verts_.clear();
+        edges_.clear();
+        verts_.reserve(c.order);
+        edges_.reserve(c.size);
+        for (std::size_t i = 0; i < c.order; ++i) {
+          vertex_node& vn = node(add_vertex());
+          vn.edges().reserve(c.out[i] + c.in[i]);
+        }
+        for ( ; first != last; ++first)
+          adjacency_list_impl::emplace_input(*this, *first);
+      }
+
   // Add a vertex to the graph, returning a handle to the new object. If
   // V is a user-supplied type, its value is default constructed.
-  template<typename V, typename E>
+  template<typename V, typename E, typename Size>
     inline auto
-    undirected_adjacency_vector<V, E>::add_vertex() -> vertex
+    undirected_adjacency_vector<V, E, Size>::add_vertex() -> vertex
     {
       return emplace_vertex();
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename Size>
     inline auto
-    undirected_adjacency_vector<V, E>::add_vertex(V&& x) -> vertex
+    undirected_adjacency_vector<V, E, Size>::add_vertex(V&& x) -> vertex
     {
       return emplace_vertex(std::move(x));
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename Size>
     inline auto
-    undirected_adjacency_vector<V, E>::add_vertex(const V& x) -> vertex
+    undirected_adjacency_vector<V, E, Size>::add_vertex(const V& x) -> vertex
     {
       return emplace_vertex(x);
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename Size>
     template<typename... Args>
       inline auto
-      undirected_adjacency_vector<V, E>::emplace_vertex(Args&&... args) -> vertex
+      undirected_adjacency_vector<V, E, Size>::emplace_vertex(Args&&... args) -> vertex
       {
         vertex v = verts_.size();
         verts_.emplace_back(std::forward<Args>(args)...);
@@ -748,33 +891,33 @@ namespace origin
       }
 
   // Add a defaul edge from u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename Size>
     inline auto
-    undirected_adjacency_vector<V, E>::add_edge(vertex u, vertex v) -> edge
+    undirected_adjacency_vector<V, E, Size>::add_edge(vertex u, vertex v) -> edge
     {
       return emplace_edge(u, v);
     }
 
   // Move x into an edge connecting u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename Size>
     inline auto
-    undirected_adjacency_vector<V, E>::add_edge(vertex u, vertex v, E&& x) -> edge
+    undirected_adjacency_vector<V, E, Size>::add_edge(vertex u, vertex v, E&& x) -> edge
     {
       return emplace_edge(u, v, std::move(x));
     }
 
   // Copy x into an edge connecting u to v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename Size>
     inline auto
-    undirected_adjacency_vector<V, E>::add_edge(vertex u, vertex v, const E& x) -> edge
+    undirected_adjacency_vector<V, E, Size>::add_edge(vertex u, vertex v, const E& x) -> edge
     {
       return emplace_edge(u, v, x);
     }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename Size>
     template<typename... Args>
       inline auto
-      undirected_adjacency_vector<V, E>::
+      undirected_adjacency_vector<V, E, Size>::
         emplace_edge(vertex u, vertex v, Args&&... args) -> edge
       {
         edge e = edges_.size();
@@ -783,9 +926,9 @@ namespace origin
         return e;
       }
 
-  template<typename V, typename E>
+  template<typename V, typename E, typename Size>
     inline void
-    undirected_adjacency_vector<V, E>::link_edge(vertex u, vertex v, edge e)
+    undirected_adjacency_vector<V, E, Size>::link_edge(vertex u, vertex v, edge e)
     {
       vertex_node& un = node(u);
       vertex_node& vn = node(v);
@@ -793,26 +936,77 @@ namespace origin
       vn.insert(e);
     }
 
+  // Returns the number of vertices, edges, and incident edges for which
+  // storage has been allocated.
+  template<typename V, typename E, typename Size>
+    auto
+    undirected_adjacency_vector<V, E, Size>::capacity() const -> capacity_type
+    {
+      capacity_type c {verts_.capacity(), edges_.capacity(), 0};
+      for (const vertex_node& n : verts_)
+        c.incidence += n.edges().capacity();
+      return c;
+    }
+
+  // Ensure that n vertices can be stored without reallocating the vertex
+  // set.
+  template<typename V, typename E, typename Size>
+    inline void
+    undirected_adjacency_vector<V, E, Size>::reserve_vertices(std::size_t n)
+    {
+      verts_.reserve(n);
+    }
+
+  // Ensure that m edges can be stored without reallocating the edge set.
+  template<typename V, typename E, typename Size>
+    inline void
+    undirected_adjacency_vector<V, E, Size>::reserve_edges(std::size_t m)
+    {
+      edges_.reserve(m);
+    }
+
+  // Ensure that the vertex v can have k incident edges without reallocating
+  // its incidence list. A loop counts twice.
+  template<typename V, typename E, typename Size>
+    inline void
+    undirected_adjacency_vector<V, E, Size>::reserve_incident(vertex v, std::size_t k)
+    {
+      node(v).edges().reserve(k);
+    }
+
+  // Release unused storage in the vertex set, the edge set, and every
+  // incidence list.
+  template<typename V, typename E, typename Size>
+    void
+    undirected_adjacency_vector<V, E, Size>::shrink_to_fit()
+    {
+      for (vertex_node& n : verts_) {
+        n.edges().shrink_to_fit();
+      }
+      verts_.shrink_to_fit();
+      edges_.shrink_to_fit();
+    }
+
   // Retrun a range over the vertex set.
-  template<typename V, typename E>
+  template<typename V, typename E, typename Size>
     inline auto
-    undirected_adjacency_vector<V, E>::vertices() const -> vertex_range
+    undirected_adjacency_vector<V, E, Size>::vertices() const -> vertex_range
     {
-      return {vertex_iter(verts_.begin()), vertex_iter(verts_.end())};
+      return {0, verts_.size()};
     }
 
   // Return a range over the edge set.
-  template<typename V, typename E>
+  template<typename V, typename E, typename Size>
     inline auto
-    undirected_adjacency_vector<V, E>::edges() const -> edge_range
+    undirected_adjacency_vector<V, E, Size>::edges() const -> edge_range
     {
-      return {edge_iter(edges_.begin()), edge_iter(edges_.end())};
+      return {0, edges_.size()};
     }
 
   // Return a range over the out edges of the vertex v.
-  template<typename V, typename E>
+  template<typename V, typename E, typename Size>
     inline auto
-    undirected_adjacency_vector<V, E>::edges(vertex v) const -> incidence_range
+    undirected_adjacency_vector<V, E, Size>::edges(vertex v) const -> incidence_range
     {
       const vertex_node& vn = node(v);
       return {incidence_iter(vn.begin()), incidence_iter(vn.end())};
@@ -2,6 +2,7 @@
 // All rights reserved
 
 #include <cassert>
+#include <cstdint>
 #include <iostream>
 
 #include <origin.graph/adjacency_vector.hpp>
@@ -12,15 +13,67 @@ using namespace std;
 using namespace origin;
 using namespace testing;
 
+// The vertex and edge ranges are random access, and can be divided into
+// blocks that cover them exactly.
+template<typename G>
+  void
+  check_handle_ranges()
+  {
+    cout << "*** handle ranges (" << typestr<G>() << ") ***\n";
+    G g = build_reflexive_bidi_clique<G>(5);
+    auto vs = g.vertices();
+    assert(vs.size() == 5);
+    assert(vs.end() - vs.begin() == 5);
+    assert(*(vs.begin() + 3) == vs[3]);
+    assert(vs.begin()[4] == Vertex<G>(4));
+    assert(vs.begin() < vs.end());
+
+    auto es = g.edges();
+    assert(es.size() == g.size());
+    auto halves = es.split();
+    assert(halves.first.size() + halves.second.size() == es.size());
+    assert(*halves.second.begin() == *(halves.first.end()));
+
+    size_t n = 0;
+    for (size_t b = 0; b < 4; ++b) {
+      for (auto e : es.block(b, 4)) {
+        assert(size_t(e) == n);
+        ++n;
+      }
+    }
+    assert(n == g.size());
+  }
+
 int main()
 {
   using G = undirected_adjacency_vector<char, int>;
   check_default_init<G>();
   check_add_vertices<G>();
   check_add_edges<G>();
+  check_assign_edges<G>();
+  check_reserve<G>();
+  check_handle_ranges<G>();
 
   using D = directed_adjacency_vector<char, int>;
   check_default_init<D>();
   check_add_vertices<D>();
   check_add_edges<D>();
+  check_assign_edges<D>();
+  check_reserve<D>();
+  check_handle_ranges<D>();
+
+  // 32-bit handles
+  using NG = undirected_adjacency_vector<char, int, std::uint32_t>;
+  static_assert(sizeof(Vertex<NG>) == 4, "");
+  check_add_edges<NG>();
+  check_assign_edges<NG>();
+  check_reserve<NG>();
+  check_handle_ranges<NG>();
+
+  using ND = directed_adjacency_vector<char, int, std::uint32_t>;
+  static_assert(sizeof(Edge<ND>) == 4, "");
+  check_add_edges<ND>();
+  check_assign_edges<ND>();
+  check_reserve<ND>();
+  check_handle_ranges<ND>();
 }
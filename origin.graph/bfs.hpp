@@ -0,0 +1,326 @@
+// Copyright (c) 2009-2015 Andrew Sutton
+// All rights reserved
+
+#ifndef ORIGIN_GRAPH_BFS_HPP
+#define ORIGIN_GRAPH_BFS_HPP
+
+#include <cassert>
+#include <cstdint>
+
+#include <algorithm>
+#include <atomic>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <origin.graph/handle.hpp>
+#include <origin.graph/graph.hpp>
+#include <origin.graph/parallel.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                                 [graph.bfs]
+  //                          Breadth-First Search
+  //
+  // A breadth-first search finds the vertices reachable from a source
+  // vertex, and a tree of shortest paths (in edges) from the source to each
+  // of them. The search proceeds level by level. The frontier is the set of
+  // vertices discovered in the previous level.
+  //
+  // The search is direction-optimizing. Each level is explored either
+  // top-down, by following the out edges of every frontier vertex, or
+  // bottom-up, by searching the in edges of every undiscovered vertex for a
+  // parent in the frontier. A bottom-up step stops at the first parent it
+  // finds, so when the frontier is large (as in the middle levels of
+  // low-diameter graphs), it examines far fewer edges than a top-down step.
+  // A top-down step uses a queue of frontier vertices; a bottom-up step
+  // uses a bitmap, which is tested for each in edge.
+  //
+  // The search switches to bottom-up when the number of edges leaving the
+  // frontier exceeds 1/alpha of the edges leaving undiscovered vertices. It
+  // switches back when the frontier shrinks to fewer than 1/beta of the
+  // vertices. Graphs that do not store in edges are searched top-down.
+  //
+  // See S. Beamer, K. Asanovic, D. Patterson, "Direction-Optimizing
+  // Breadth-First Search", SC 2012.
+
+  // The tuning parameters of a direction-optimizing search.
+  struct bfs_options
+  {
+    double alpha = 15;
+    double beta = 18;
+  };
+
+  // The result of a breadth-first search. The parent and depth of each
+  // vertex v are parent[v] and depth[v]. The parent of the source is the
+  // source, and its depth is 0. Vertices that were not reached have an
+  // invalid parent and a depth of npos.
+  template<typename G>
+    struct bfs_tree
+    {
+      static constexpr std::size_t npos = -1;
+
+      bool reached(Vertex<G> v) const { return bool(parent[v]); }
+
+      std::vector<Vertex<G>>   parent;
+      std::vector<std::size_t> depth;
+    };
+
+
+  namespace bfs_impl
+  {
+    // A set of vertices, represented as one bit per vertex index.
+    class bitmap
+    {
+    public:
+      explicit bitmap(std::size_t n)
+        : words((n + 63) / 64, 0)
+      { }
+
+      bool test(std::size_t i) const { return words[i / 64] & bit(i); }
+      void set(std::size_t i)        { words[i / 64] |= bit(i); }
+      void clear()                   { std::fill(words.begin(), words.end(), 0); }
+
+      void swap(bitmap& x) { words.swap(x.words); }
+
+    private:
+      static std::uint64_t bit(std::size_t i) { return std::uint64_t(1) << (i % 64); }
+
+      std::vector<std::uint64_t> words;
+    };
+
+    // Explore one level top-down. Each vertex in the frontier q is expanded,
+    // and newly discovered vertices are appended to next. Returns the number
+    // of edges leaving the discovered vertices.
+    template<typename G>
+      std::size_t
+      top_down_step(const G& g, bfs_tree<G>& t, const std::vector<Vertex<G>>& q,
+                    std::vector<Vertex<G>>& next, std::size_t d)
+      {
+        std::size_t scout = 0;
+        for (Vertex<G> u : q) {
+          for (auto e : out_edges(g, u)) {
+            Vertex<G> v = out_neighbor(g, e, u);
+            if (!t.parent[v]) {
+              t.parent[v] = u;
+              t.depth[v] = d;
+              next.push_back(v);
+              scout += out_degree(g, v);
+            }
+          }
+        }
+        return scout;
+      }
+
+    // Explore one level bottom-up. Each undiscovered vertex searches its in
+    // edges for a parent in the frontier, and is added to next if found.
+    // Returns the number of vertices discovered.
+    template<typename G>
+      std::size_t
+      bottom_up_step(const G& g, bfs_tree<G>& t, const bitmap& front,
+                     bitmap& next, std::size_t d, std::true_type)
+      {
+        std::size_t awake = 0;
+        next.clear();
+        for (Vertex<G> v : vertices(g)) {
+          if (t.parent[v])
+            continue;
+          for (auto e : in_edges(g, v)) {
+            Vertex<G> u = in_neighbor(g, e, v);
+            if (front.test(u)) {
+              t.parent[v] = u;
+              t.depth[v] = d;
+              next.set(v);
+              ++awake;
+              break;
+            }
+          }
+        }
+        return awake;
+      }
+
+    // Graphs that cannot store in edges are only searched top-down.
+    template<typename G>
+      inline std::size_t
+      bottom_up_step(const G&, bfs_tree<G>&, const bitmap&, bitmap&, std::size_t,
+                     std::false_type)
+      {
+        assert(false && "graph does not store in edges");
+        return 0;
+      }
+
+    // Returns the iterator n positions past i. Iterators that support
+    // addition are advanced in constant time.
+    template<typename I>
+      inline auto
+      skip(I i, std::size_t n, int) -> decltype(i + std::ptrdiff_t(n))
+      {
+        return i + std::ptrdiff_t(n);
+      }
+
+    template<typename I>
+      inline I
+      skip(I i, std::size_t n, long)
+      {
+        for ( ; n != 0; --n)
+          ++i;
+        return i;
+      }
+
+  } // namespace bfs_impl
+
+
+  // Search g from the source vertex s.
+  template<typename G>
+    bfs_tree<G>
+    breadth_first_search(const G& g, Vertex<G> s, bfs_options opt = {})
+    {
+      using bfs_impl::bitmap;
+
+      std::size_t n = vertex_bound(g);
+      assert(std::size_t(s) < n);
+
+      bfs_tree<G> t;
+      t.parent.assign(n, Vertex<G>());
+      t.depth.assign(n, std::size_t(-1));
+      t.parent[s] = s;
+      t.depth[s] = 0;
+
+      const bool bottom_up = stores_in_edges(g);
+      std::vector<Vertex<G>> q {s};
+      std::vector<Vertex<G>> next;
+      bitmap front(n);
+      bitmap back(n);
+
+      std::size_t unexplored = out_edge_count(g);
+      std::size_t scout = out_degree(g, s);
+      std::size_t d = 0;
+      while (!q.empty()) {
+        if (bottom_up && scout > unexplored / opt.alpha) {
+          // Explore bottom-up until the frontier is small and shrinking.
+          front.clear();
+          for (Vertex<G> v : q)
+            front.set(v);
+          std::size_t awake = q.size();
+          std::size_t prev;
+          do {
+            prev = awake;
+            awake = bfs_impl::bottom_up_step(g, t, front, back, ++d, in_edge_storage<G>{});
+            front.swap(back);
+          } while (awake != 0 && (awake >= prev || awake > n / opt.beta));
+
+          // Rebuild the queue from the last frontier.
+          q.clear();
+          for (Vertex<G> v : vertices(g))
+            if (t.depth[v] == d)
+              q.push_back(v);
+          scout = 1;
+        } else {
+          unexplored -= std::min(unexplored, scout);
+          next.clear();
+          scout = bfs_impl::top_down_step(g, t, q, next, ++d);
+          q.swap(next);
+        }
+      }
+      return t;
+    }
+
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                             [graph.bfs.par]
+  //                      Parallel Breadth-First Search
+  //
+  // A parallel breadth-first search explores each level top-down on many
+  // threads. The work of a level is the set of edges leaving the frontier.
+  // These are numbered consecutively (by a prefix sum of the out degrees of
+  // the frontier vertices), and the numbers are divided into blocks of
+  // nearly equal size, one per thread. A block may begin or end in the
+  // middle of the out edges of a vertex, so the edges of a high-degree
+  // vertex are shared by several threads, and skewed degree distributions
+  // do not unbalance the work.
+  //
+  // A vertex is discovered by the thread that claims it, by a compare and
+  // exchange on its entry in the parent array. Each thread collects the
+  // vertices it claims, and these are concatenated to form the next
+  // frontier. The grain is the minimum number of edges given to a thread.
+  //
+  // The result is the same as for breadth_first_search, except that the
+  // parent of a vertex may be any of its parents in the previous level.
+  // Starting the out edges of a vertex at an arbitrary position takes
+  // constant time for adjacency vectors and compressed graphs, and linear
+  // time for adjacency lists.
+
+  template<typename G>
+    bfs_tree<G>
+    parallel_breadth_first_search(const G& g, Vertex<G> s,
+                                  std::size_t grain = parallel_grain)
+    {
+      constexpr std::size_t npos = -1;
+      const std::size_t n = vertex_bound(g);
+      assert(std::size_t(s) < n);
+
+      bfs_tree<G> t;
+      std::vector<std::atomic<std::size_t>> parent(n);
+      t.depth.resize(n);
+      parallel_for(n, [&](std::size_t i) {
+        parent[i].store(npos, std::memory_order_relaxed);
+        t.depth[i] = npos;
+      });
+      parent[s].store(s, std::memory_order_relaxed);
+      t.depth[s] = 0;
+
+      std::vector<Vertex<G>> q {s};
+      std::vector<std::size_t> work;
+      for (std::size_t d = 1; !q.empty(); ++d) {
+        // Number the edges leaving the frontier.
+        work.resize(q.size() + 1);
+        parallel_for(q.size(), [&](std::size_t i) {
+          work[i + 1] = out_degree(g, q[i]);
+        });
+        work[0] = 0;
+        for (std::size_t i = 0; i < q.size(); ++i)
+          work[i + 1] += work[i];
+
+        // Claim the targets of each block of edges.
+        const std::size_t m = work.back();
+        std::vector<std::vector<Vertex<G>>> found(parallel_block_count(m, grain));
+        parallel_blocks(m, [&](std::size_t b, std::size_t first, std::size_t last) {
+          std::size_t i = std::upper_bound(work.begin(), work.end(), first) - work.begin() - 1;
+          for (std::size_t k = first; k < last; ++i) {
+            Vertex<G> u = q[i];
+            auto r = out_edges(g, u);
+            auto e = bfs_impl::skip(r.begin(), k - work[i], 0);
+            for (std::size_t end = std::min(last, work[i + 1]); k < end; ++k, ++e) {
+              Vertex<G> v = out_neighbor(g, *e, u);
+              std::size_t x = npos;
+              if (parent[v].load(std::memory_order_relaxed) == npos
+                  && parent[v].compare_exchange_strong(x, u, std::memory_order_relaxed)) {
+                t.depth[v] = d;
+                found[b].push_back(v);
+              }
+            }
+          }
+        }, grain);
+
+        // Concatenate the claimed vertices to form the next frontier.
+        std::vector<std::size_t> off(found.size() + 1, 0);
+        for (std::size_t b = 0; b < found.size(); ++b)
+          off[b + 1] = off[b] + found[b].size();
+        q.resize(off.back());
+        parallel_for(found.size(), [&](std::size_t b) {
+          std::copy(found[b].begin(), found[b].end(), q.begin() + off[b]);
+        }, 1);
+      }
+
+      t.parent.resize(n);
+      parallel_for(n, [&](std::size_t i) {
+        t.parent[i] = Vertex<G>(parent[i].load(std::memory_order_relaxed));
+      });
+      return t;
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,133 @@
+// Copyright (c) 2009-2015 Andrew Sutton
+// All rights reserved
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <queue>
+
+#include <origin.graph/adjacency_list.hpp>
+#include <origin.graph/adjacency_vector.hpp>
+#include <origin.graph/compressed_graph.hpp>
+#include <origin.graph/bfs.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+// Returns the depth of each vertex, computed by a plain queue-based search.
+template<typename G>
+  vector<size_t>
+  reference_depths(const G& g, Vertex<G> s)
+  {
+    vector<size_t> d(vertex_bound(g), size_t(-1));
+    queue<Vertex<G>> q;
+    d[s] = 0;
+    q.push(s);
+    while (!q.empty()) {
+      Vertex<G> u = q.front();
+      q.pop();
+      for (auto e : out_edges(g, u)) {
+        Vertex<G> v = out_neighbor(g, e, u);
+        if (d[v] == size_t(-1)) {
+          d[v] = d[u] + 1;
+          q.push(v);
+        }
+      }
+    }
+    return d;
+  }
+
+// Check that t is a shortest path tree of g from s: depths are those of
+// a plain search, and each parent is one level up, across an edge.
+template<typename G>
+  void
+  check_tree(const G& g, Vertex<G> s, const bfs_tree<G>& t)
+  {
+    assert(t.depth == reference_depths(g, s));
+    assert(t.parent[s] == s);
+    for (auto v : vertices(g)) {
+      if (!t.reached(v) || v == s)
+        continue;
+      Vertex<G> u = t.parent[v];
+      assert(t.depth[u] + 1 == t.depth[v]);
+      bool found = false;
+      for (auto e : out_edges(g, u))
+        found |= out_neighbor(g, e, u) == v;
+      assert(found);
+    }
+  }
+
+// Search from several sources, using the default tuning, searching only
+// top-down, and switching to bottom-up as soon as possible.
+template<typename G>
+  void
+  check_bfs(const G& g)
+  {
+    cout << "*** bfs (" << typestr<G>() << ") ***\n";
+    bfs_options top, bottom;
+    top.alpha = 1e-12;
+    bottom.alpha = 1e12;
+    bottom.beta = 1e12;
+    for (auto s : {0, 1, 17, 499}) {
+      Vertex<G> v(s);
+      check_tree(g, v, breadth_first_search(g, v));
+      check_tree(g, v, breadth_first_search(g, v, top));
+      check_tree(g, v, breadth_first_search(g, v, bottom));
+    }
+  }
+
+// Check the parallel search, with a small grain so that the out edges of
+// the hub vertices are divided among blocks.
+template<typename G>
+  void
+  check_parallel_bfs(const G& g)
+  {
+    cout << "*** parallel bfs (" << typestr<G>() << ") ***\n";
+    for (auto s : {0, 1, 17, 499}) {
+      Vertex<G> v(s);
+      check_tree(g, v, parallel_breadth_first_search(g, v));
+      check_tree(g, v, parallel_breadth_first_search(g, v, 7));
+    }
+  }
+
+int main()
+{
+  auto input = random_edges(2000, 8000);
+
+  check_bfs(directed_adjacency_vector<>(input.begin(), input.end()));
+  check_bfs(undirected_adjacency_vector<>(input.begin(), input.end()));
+  check_bfs(compressed_directed_graph<>(input.begin(), input.end()));
+  check_bfs(compressed_directed_graph<empty_t, empty_t, false>(input.begin(), input.end()));
+  check_bfs(compressed_undirected_graph<>(input.begin(), input.end()));
+
+  // A hub with an edge to every vertex.
+  auto hub = input;
+  for (size_t v = 0; v < 2000; ++v)
+    hub.emplace_back(3, v);
+  check_parallel_bfs(directed_adjacency_vector<>(hub.begin(), hub.end()));
+  check_parallel_bfs(directed_adjacency_vector<empty_t, empty_t, uint32_t>(hub.begin(), hub.end()));
+  check_parallel_bfs(compressed_directed_graph<empty_t, empty_t, false>(hub.begin(), hub.end()));
+  check_parallel_bfs(undirected_adjacency_vector<>(hub.begin(), hub.end()));
+
+  // Removed vertices leave gaps in the vertex indexes.
+  directed_adjacency_list<> g(input.begin(), input.end());
+  for (size_t v = 1000; v < 2000; v += 3)
+    g.remove_vertex(v);
+  check_bfs(g);
+  check_parallel_bfs(g);
+
+  // A path is searched top-down.
+  directed_adjacency_vector<> p;
+  for (int i = 0; i < 500; ++i)
+    p.add_vertex();
+  for (int i = 0; i < 499; ++i)
+    p.add_edge(i, i + 1);
+  auto t = breadth_first_search(p, vertex_handle(0));
+  assert(t.depth[499] == 499);
+  auto u = breadth_first_search(p, vertex_handle(499));
+  assert(!u.reached(vertex_handle(0)));
+  assert(u.depth[0] == size_t(-1));
+}
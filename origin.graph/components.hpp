@@ -0,0 +1,371 @@
+// Copyright (c) 2009-2015 Andrew Sutton
+// All rights reserved
+
+#ifndef ORIGIN_GRAPH_COMPONENTS_HPP
+#define ORIGIN_GRAPH_COMPONENTS_HPP
+
+#include <cassert>
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <origin.graph/handle.hpp>
+#include <origin.graph/graph.hpp>
+#include <origin.graph/parallel.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                         [graph.disjoint_sets]
+  //                             Disjoint Sets
+  //
+  // A disjoint set structure partitions the indexes [0, n) into sets, each
+  // named by one of its members (its representative). Sets are stored as
+  // trees of parent links. Finding the representative of an element
+  // compresses the path to the root, and the union of two sets links the
+  // root of the shallower tree to the root of the deeper one (union by
+  // rank). Together, these make each operation take nearly constant
+  // amortized time.
+
+  class disjoint_sets
+  {
+  public:
+    explicit disjoint_sets(std::size_t n);
+
+    std::size_t size() const { return parent.size(); }
+
+    std::size_t find(std::size_t x);
+    bool unite(std::size_t x, std::size_t y);
+
+  private:
+    std::vector<std::size_t>   parent;
+    std::vector<unsigned char> rank;
+  };
+
+  inline
+  disjoint_sets::disjoint_sets(std::size_t n)
+    : parent(n), rank(n, 0)
+  {
+    for (std::size_t i = 0; i < n; ++i)
+      parent[i] = i;
+  }
+
+  // Returns the representative of the set containing x.
+  inline std::size_t
+  disjoint_sets::find(std::size_t x)
+  {
+    assert(x < size());
+    std::size_t r = x;
+    while (parent[r] != r)
+      r = parent[r];
+    while (parent[x] != r) {
+      std::size_t p = parent[x];
+      parent[x] = r;
+      x = p;
+    }
+    return r;
+  }
+
+  // Merge the sets containing x and y. Returns false if they were already
+  // the same set.
+  inline bool
+  disjoint_sets::unite(std::size_t x, std::size_t y)
+  {
+    x = find(x);
+    y = find(y);
+    if (x == y)
+      return false;
+    if (rank[x] < rank[y])
+      std::swap(x, y);
+    parent[y] = x;
+    if (rank[x] == rank[y])
+      ++rank[x];
+    return true;
+  }
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                          [graph.components]
+  //                         Connected Components
+  //
+  // The connected components of an undirected graph are its maximal
+  // connected subgraphs. The weakly connected components of a directed
+  // graph are those of the graph with the direction of its edges ignored.
+  //
+  // Components are labeled by a dense array indexed by vertex. Components
+  // are numbered from 0 in order of their least vertex, so the labeling of
+  // a graph does not depend on the algorithm that computed it.
+
+  // The result of a component labeling. The component of each vertex v is
+  // component[v], and there are count components. Indexes that are not
+  // vertices (e.g., removed vertices of an adjacency list) have component
+  // npos.
+  struct component_map
+  {
+    static constexpr std::size_t npos = -1;
+
+    std::vector<std::size_t> component;
+    std::size_t              count = 0;
+  };
+
+
+  namespace components_impl
+  {
+    // Returns a mask of the indexes in [0, n) that are vertices of g, or an
+    // empty mask if all of them are.
+    template<typename G>
+      std::vector<char>
+      live_vertices(const G& g, std::size_t n)
+      {
+        std::vector<char> live;
+        if (g.order() != n) {
+          live.assign(n, 0);
+          for (auto v : vertices(g))
+            live[v] = 1;
+        }
+        return live;
+      }
+
+    inline bool
+    is_live(const std::vector<char>& live, std::size_t i)
+    {
+      return live.empty() || live[i];
+    }
+
+    // Number the components of a labeling in which root(i) is the least
+    // index in the component of i. Each block counts the roots it contains,
+    // and roots are numbered from the offsets of their blocks.
+    template<typename F>
+      component_map
+      number_components(std::size_t n, const std::vector<char>& live, F root,
+                        std::size_t grain)
+      {
+        component_map m;
+        m.component.resize(n);
+        std::vector<std::size_t> off(parallel_block_count(n, grain) + 1, 0);
+        parallel_blocks(n, [&](std::size_t b, std::size_t first, std::size_t last) {
+          for (std::size_t i = first; i != last; ++i)
+            off[b + 1] += is_live(live, i) && root(i) == i;
+        }, grain);
+        for (std::size_t b = 1; b < off.size(); ++b)
+          off[b] += off[b - 1];
+        m.count = off.back();
+
+        parallel_blocks(n, [&](std::size_t b, std::size_t first, std::size_t last) {
+          std::size_t k = off[b];
+          for (std::size_t i = first; i != last; ++i)
+            if (is_live(live, i) && root(i) == i)
+              m.component[i] = k++;
+        }, grain);
+        parallel_for(n, [&](std::size_t i) {
+          if (!is_live(live, i))
+            m.component[i] = component_map::npos;
+          else if (root(i) != i)
+            m.component[i] = m.component[root(i)];
+        }, grain);
+        return m;
+      }
+
+    template<typename G>
+      component_map
+      union_find_components(const G& g)
+      {
+        const std::size_t n = vertex_bound(g);
+        std::vector<char> live = live_vertices(g, n);
+
+        // Link each root to the least index in its set, so that roots are
+        // the least vertices of their components.
+        disjoint_sets s(n);
+        std::vector<std::size_t> least(n);
+        for (std::size_t i = 0; i < n; ++i)
+          least[i] = i;
+        for (auto e : edges(g)) {
+          std::size_t u = s.find(source(g, e));
+          std::size_t v = s.find(target(g, e));
+          if (s.unite(u, v))
+            least[s.find(u)] = std::min(least[u], least[v]);
+        }
+        for (std::size_t i = 0; i < n; ++i)
+          least[i] = least[s.find(i)];
+        return number_components(n, live, [&](std::size_t i) { return least[i]; }, n + 1);
+      }
+
+
+    // Afforest: lock-free linking of trees of parent links, in which every
+    // parent is less than its child.
+    using label_array = std::vector<std::atomic<std::size_t>>;
+
+    // Join the trees containing u and v by linking the greater root to the
+    // lesser. If another thread changes the greater root first, retry from
+    // the new roots.
+    inline void
+    link(label_array& c, std::size_t u, std::size_t v)
+    {
+      std::size_t p1 = c[u].load(std::memory_order_relaxed);
+      std::size_t p2 = c[v].load(std::memory_order_relaxed);
+      while (p1 != p2) {
+        std::size_t high = std::max(p1, p2);
+        std::size_t low = std::min(p1, p2);
+        std::size_t ph = c[high].load(std::memory_order_relaxed);
+        if (ph == low)
+          break;
+        if (ph == high && c[high].compare_exchange_strong(ph, low, std::memory_order_relaxed))
+          break;
+        p1 = c[c[high].load(std::memory_order_relaxed)].load(std::memory_order_relaxed);
+        p2 = c[low].load(std::memory_order_relaxed);
+      }
+    }
+
+    // Point every index directly at its root.
+    inline void
+    compress(label_array& c, std::size_t grain)
+    {
+      parallel_for(c.size(), [&](std::size_t i) {
+        std::size_t p = c[i].load(std::memory_order_relaxed);
+        std::size_t q = c[p].load(std::memory_order_relaxed);
+        while (p != q) {
+          c[i].store(q, std::memory_order_relaxed);
+          p = q;
+          q = c[p].load(std::memory_order_relaxed);
+        }
+      }, grain);
+    }
+
+    // Returns the most frequent label in a random sample of c.
+    inline std::size_t
+    sample_frequent_label(const label_array& c, std::size_t samples)
+    {
+      std::minstd_rand gen(27491095);
+      std::unordered_map<std::size_t, std::size_t> count;
+      std::size_t best = 0;
+      std::size_t most = 0;
+      for (std::size_t i = 0; i < samples; ++i) {
+        std::size_t x = c[gen() % c.size()].load(std::memory_order_relaxed);
+        std::size_t k = ++count[x];
+        if (k > most) {
+          best = x;
+          most = k;
+        }
+      }
+      return best;
+    }
+
+    template<typename G>
+      component_map
+      afforest_components(const G& g, std::size_t rounds, std::size_t grain)
+      {
+        const std::size_t n = vertex_bound(g);
+        std::vector<char> live = live_vertices(g, n);
+        label_array c(n);
+        parallel_for(n, [&](std::size_t i) {
+          c[i].store(i, std::memory_order_relaxed);
+        }, grain);
+        if (n == 0)
+          return component_map();
+
+        // Link each vertex across its first few edges.
+        for (std::size_t r = 0; r < rounds; ++r) {
+          parallel_for(n, [&](std::size_t i) {
+            if (!is_live(live, i))
+              return;
+            Vertex<G> u(i);
+            std::size_t k = 0;
+            for (auto e : out_edges(g, u)) {
+              if (k++ == r) {
+                link(c, u, out_neighbor(g, e, u));
+                break;
+              }
+            }
+          }, grain);
+          compress(c, grain);
+        }
+
+        // Link the remaining edges, except those of vertices already in the
+        // largest component. In an undirected graph, an edge leaving that
+        // component is also an edge of a vertex outside it. In a directed
+        // graph, only out edges are followed, so every vertex is finished.
+        const std::size_t big = sample_frequent_label(c, 1024);
+        const bool skip = Undirected_graph<G>();
+        parallel_for(n, [&](std::size_t i) {
+          if (!is_live(live, i))
+            return;
+          if (skip && c[i].load(std::memory_order_relaxed) == big)
+            return;
+          Vertex<G> u(i);
+          std::size_t k = 0;
+          for (auto e : out_edges(g, u))
+            if (k++ >= rounds)
+              link(c, u, out_neighbor(g, e, u));
+        }, grain);
+        compress(c, grain);
+
+        return number_components(n, live, [&](std::size_t i) {
+          return c[i].load(std::memory_order_relaxed);
+        }, grain);
+      }
+
+  } // namespace components_impl
+
+
+  // Label the connected components of g, using a disjoint set structure.
+  template<typename G>
+    inline Requires<Undirected_graph<G>(), component_map>
+    connected_components(const G& g)
+    {
+      return components_impl::union_find_components(g);
+    }
+
+  // Label the weakly connected components of g, using a disjoint set
+  // structure.
+  template<typename G>
+    inline Requires<Directed_graph<G>(), component_map>
+    weakly_connected_components(const G& g)
+    {
+      return components_impl::union_find_components(g);
+    }
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                      [graph.components.par]
+  //                    Parallel Connected Components
+  //
+  // The parallel algorithm is Afforest. Every vertex starts in its own tree.
+  // The trees are joined by linking the greater of two roots to the lesser,
+  // with a compare and exchange, so that threads need no locks. The search
+  // first links each vertex across only its first few edges (the neighbor
+  // rounds), which is usually enough to gather most vertices of a large
+  // graph into one component. That component is found by sampling, and its
+  // vertices skip their remaining edges. Only the vertices outside it link
+  // across all of their edges.
+  //
+  // See M. Sutton, T. Ben-Nun, A. Barak, "Optimizing Parallel Graph
+  // Connectivity Computation via Subgraph Sampling", IPDPS 2018.
+
+  // The tuning parameters of a parallel component labeling.
+  struct components_options
+  {
+    std::size_t neighbor_rounds = 2;
+    std::size_t grain = parallel_grain;
+  };
+
+  template<typename G>
+    inline Requires<Undirected_graph<G>(), component_map>
+    parallel_connected_components(const G& g, components_options opt = {})
+    {
+      return components_impl::afforest_components(g, opt.neighbor_rounds, opt.grain);
+    }
+
+  template<typename G>
+    inline Requires<Directed_graph<G>(), component_map>
+    parallel_weakly_connected_components(const G& g, components_options opt = {})
+    {
+      return components_impl::afforest_components(g, opt.neighbor_rounds, opt.grain);
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,135 @@
+// Copyright (c) 2009-2015 Andrew Sutton
+// All rights reserved
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <queue>
+
+#include <origin.graph/adjacency_list.hpp>
+#include <origin.graph/adjacency_vector.hpp>
+#include <origin.graph/compressed_graph.hpp>
+#include <origin.graph/components.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+// Returns the components of g, labeled by a search from each unlabeled
+// vertex in increasing order, following edges in both directions.
+template<typename G>
+  vector<size_t>
+  reference_components(const G& g)
+  {
+    size_t n = vertex_bound(g);
+    vector<vector<size_t>> adj(n);
+    for (auto e : edges(g)) {
+      adj[source(g, e)].push_back(target(g, e));
+      adj[target(g, e)].push_back(source(g, e));
+    }
+    vector<size_t> c(n, component_map::npos);
+    vector<char> live(n, 0);
+    for (auto v : vertices(g))
+      live[v] = 1;
+    size_t k = 0;
+    for (size_t s = 0; s < n; ++s) {
+      if (!live[s] || c[s] != component_map::npos)
+        continue;
+      queue<size_t> q;
+      c[s] = k;
+      q.push(s);
+      while (!q.empty()) {
+        size_t u = q.front();
+        q.pop();
+        for (size_t v : adj[u])
+          if (c[v] == component_map::npos) {
+            c[v] = k;
+            q.push(v);
+          }
+      }
+      ++k;
+    }
+    return c;
+  }
+
+template<typename G>
+  void
+  check(const G& g, const component_map& m)
+  {
+    auto r = reference_components(g);
+    assert(m.component == r);
+    size_t k = 0;
+    for (size_t x : r)
+      if (x != component_map::npos)
+        k = max(k, x + 1);
+    assert(m.count == k);
+  }
+
+template<typename G>
+  void
+  check_components(const G& g)
+  {
+    cout << "*** connected components (" << typestr<G>() << ") ***\n";
+    components_options small;
+    small.grain = 7;
+    check(g, connected_components(g));
+    check(g, parallel_connected_components(g));
+    check(g, parallel_connected_components(g, small));
+  }
+
+template<typename G>
+  void
+  check_weak_components(const G& g)
+  {
+    cout << "*** weakly connected components (" << typestr<G>() << ") ***\n";
+    components_options small;
+    small.grain = 7;
+    small.neighbor_rounds = 1;
+    check(g, weakly_connected_components(g));
+    check(g, parallel_weakly_connected_components(g));
+    check(g, parallel_weakly_connected_components(g, small));
+  }
+
+int main()
+{
+  // Sparse graphs have many components; denser ones have one large
+  // component and a few small ones.
+  for (size_t m : {800, 1500, 6000}) {
+    auto input = random_edges(2000, m, unsigned(m));
+    check_components(undirected_adjacency_vector<>(input.begin(), input.end()));
+    check_components(undirected_adjacency_vector<empty_t, empty_t, uint32_t>(input.begin(), input.end()));
+    check_components(compressed_undirected_graph<>(input.begin(), input.end()));
+    check_weak_components(directed_adjacency_vector<>(input.begin(), input.end()));
+    check_weak_components(compressed_directed_graph<empty_t, empty_t, false>(input.begin(), input.end()));
+
+    // Removed vertices leave gaps in the vertex indexes.
+    undirected_adjacency_list<> g(input.begin(), input.end());
+    directed_adjacency_list<> h(input.begin(), input.end());
+    for (size_t v = 1000; v < 2000; v += 3) {
+      g.remove_vertex(v);
+      h.remove_vertex(v);
+    }
+    check_components(g);
+    check_weak_components(h);
+    assert(connected_components(g).component[1000] == component_map::npos);
+  }
+
+  // Disjoint sets
+  disjoint_sets s(10);
+  assert(s.unite(1, 2));
+  assert(s.unite(3, 2));
+  assert(!s.unite(1, 3));
+  assert(s.find(1) == s.find(3));
+  assert(s.find(0) != s.find(1));
+
+  // A graph without edges
+  undirected_adjacency_vector<> e;
+  for (int i = 0; i < 5; ++i)
+    e.add_vertex();
+  auto m = parallel_connected_components(e);
+  assert(m.count == 5);
+  assert(m.component[4] == 4);
+  assert(connected_components(undirected_adjacency_vector<>()).count == 0);
+}
@@ -0,0 +1,609 @@
+// Copyright (c) 2009-2015 Andrew Sutton
+// All rights reserved
+
+#ifndef ORIGIN_GRAPH_COMPRESSED_GRAPH_HPP
+#define ORIGIN_GRAPH_COMPRESSED_GRAPH_HPP
+
+#include <cassert>
+
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <origin/type/concepts.hpp>
+#include <origin/type/empty.hpp>
+#include <origin/sequence/range.hpp>
+
+#include <origin.graph/handle.hpp>
+#include <origin.graph/graph.hpp>
+
+#include <origin.graph/adjacency_list.impl/handle_range.hpp>
+#include <origin.graph/adjacency_list.impl/edge_input.hpp>
+
+namespace origin
+{
+  namespace compressed_graph_impl
+  {
+    using adjacency_list_impl::handle_counter;
+    using adjacency_list_impl::handle_range;
+
+    // Vertex and edge ranges are handle ranges, which can be split in
+    // constant time.
+    using vertex_range = handle_range<vertex_handle>;
+    using edge_range = handle_range<edge_handle>;
+
+    // An alias for a range over an array of edge handles.
+    using edge_array_range = bounded_range<const edge_handle*>;
+
+
+    // An incident edge of a compressed undirected graph, and the vertex
+    // reached by following it. The incident edge converts to its edge
+    // handle.
+    struct incident_edge : edge_handle
+    {
+      incident_edge(edge_handle e, vertex_handle v)
+        : edge_handle(e), neighbor(v)
+      { }
+
+      vertex_handle neighbor;
+    };
+
+    // An iterator over the incident edges of a vertex. The edge and the
+    // neighbor of each incident edge are read from parallel arrays, so
+    // following an edge does not touch the endpoints of the edge.
+    struct incidence_iterator
+    {
+      using value_type = incident_edge;
+      using reference = incident_edge;
+      using pointer = const incident_edge*;
+      using difference_type = std::ptrdiff_t;
+      using iterator_category = std::forward_iterator_tag;
+
+      incidence_iterator()
+        : edge(), neighbor()
+      { }
+
+      incidence_iterator(const edge_handle* e, const vertex_handle* v)
+        : edge(e), neighbor(v)
+      { }
+
+      incident_edge operator*() const { return {*edge, *neighbor}; }
+
+      incidence_iterator& operator++();
+      incidence_iterator  operator++(int);
+
+      const edge_handle*   edge;
+      const vertex_handle* neighbor;
+    };
+
+    inline incidence_iterator&
+    incidence_iterator::operator++()
+    {
+      ++edge;
+      ++neighbor;
+      return *this;
+    }
+
+    inline incidence_iterator
+    incidence_iterator::operator++(int)
+    {
+      incidence_iterator tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    inline std::ptrdiff_t
+    operator-(const incidence_iterator& a, const incidence_iterator& b)
+    {
+      return a.edge - b.edge;
+    }
+
+    // Equality
+    inline bool
+    operator==(const incidence_iterator& a, const incidence_iterator& b)
+    {
+      return a.edge == b.edge;
+    }
+
+    inline bool
+    operator!=(const incidence_iterator& a, const incidence_iterator& b)
+    {
+      return a.edge != b.edge;
+    }
+
+    using incidence_range = bounded_range<incidence_iterator>;
+
+
+    // Convert the degree counts in d into offsets, so that d[v] is the
+    // position of the first entry for v, and d[n] is the total.
+    inline void
+    prefix_sum(std::vector<std::size_t>& d)
+    {
+      std::size_t sum = 0;
+      for (std::size_t& x : d) {
+        std::size_t k = x;
+        x = sum;
+        sum += k;
+      }
+    }
+
+  } // namespace compressed_graph_impl
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                        [graph.compressed.dir]
+  //                        Compressed Directed Graph
+  //
+  // A compressed directed graph is a static graph stored in compressed sparse
+  // row (CSR) format. The out edges of every vertex are stored contiguously,
+  // in order of their source vertex. An offsets array records where the out
+  // edges of each vertex begin, and a targets array records the target of
+  // each edge. The edge handle is the position of the edge in that order, so
+  // iterating over out edges is a linear scan over contiguous memory, and no
+  // per-vertex or per-edge allocation is made.
+  //
+  // If Bidirectional is true (the default), the in edges of every vertex are
+  // also stored, as a second offsets array and an array of edge handles in
+  // order of their target vertex. Otherwise, in_edges and in_degree are not
+  // available (see in_edge_storage), and the graph uses roughly half the
+  // memory.
+  //
+  // The structure of the graph cannot be modified once constructed. Vertex
+  // and edge values can be.
+  //
+  // Finding the source of an edge is a binary search over the offsets array.
+  //
+  // Performance properties:
+  //    - Out degree, in degree: O(1)
+  //    - Source: O(log n)
+  //    - Target: O(1)
+  //    - Construction: O(n + m)
+
+  template<typename V = empty_t, typename E = empty_t, bool Bidirectional = true>
+    class compressed_directed_graph
+    {
+      using this_type = compressed_directed_graph<V, E, Bidirectional>;
+    public:
+      using vertex = vertex_handle;
+      using vertex_range = compressed_graph_impl::vertex_range;
+
+      using edge = edge_handle;
+      using edge_range = compressed_graph_impl::edge_range;
+
+      using out_edge_range = compressed_graph_impl::edge_range;
+      using in_edge_range = compressed_graph_impl::edge_array_range;
+
+      static constexpr bool bidirectional = Bidirectional;
+
+      // The structural arrays of a compressed directed graph. The in edge
+      // arrays are empty unless the graph is bidirectional.
+      struct arrays
+      {
+        std::vector<std::size_t> out;     // Out edge offsets (n + 1)
+        std::vector<vertex>      targets; // Edge targets (m)
+        std::vector<std::size_t> in;      // In edge offsets (n + 1)
+        std::vector<edge>        ins;     // Edges in target order (m)
+      };
+
+      // Construction
+      compressed_directed_graph() = default;
+
+      template<typename I>
+        compressed_directed_graph(I first, I last, std::size_t n = 0);
+
+      explicit compressed_directed_graph(arrays a);
+
+      // Observers
+      bool        null() const  { return vvals_.empty(); }
+      std::size_t order() const { return vvals_.size(); }
+
+      bool        empty() const { return targets_.empty(); }
+      std::size_t size() const  { return targets_.size(); }
+
+      // Vertex observers
+      std::size_t out_degree(vertex v) const { return out_[v + 1] - out_[v]; }
+      std::size_t in_degree(vertex v) const;
+      std::size_t degree(vertex v) const { return out_degree(v) + in_degree(v); }
+
+      // Edge observers
+      vertex source(edge e) const;
+      vertex target(edge e) const { return targets_[e]; }
+
+      // Data access
+      V&       operator()(vertex v)       { return vvals_[v]; }
+      const V& operator()(vertex v) const { return vvals_[v]; }
+
+      E&       operator()(edge e)       { return evals_[e]; }
+      const E& operator()(edge e) const { return evals_[e]; }
+
+      // Edge relation
+      edge operator()(vertex u, vertex v) const;
+
+      // Iterators
+      vertex_range   vertices() const;
+      edge_range     edges() const;
+      out_edge_range out_edges(vertex v) const;
+      in_edge_range  in_edges(vertex v) const;
+
+      // Raw storage
+      // The out edges of v are the edges in [out_offsets()[v],
+      // out_offsets()[v + 1]). The target of the edge e is targets()[e].
+      const std::vector<std::size_t>& out_offsets() const { return out_; }
+      const std::vector<vertex>&      targets() const     { return targets_; }
+
+    private:
+      edge find_edge(vertex u, vertex v, std::false_type) const;
+      edge find_edge(vertex u, vertex v, std::true_type) const;
+
+    private:
+      std::vector<std::size_t> out_;     // Out edge offsets (n + 1)
+      std::vector<vertex>      targets_; // Edge targets (m)
+      std::vector<std::size_t> in_;      // In edge offsets (n + 1)
+      std::vector<edge>        ins_;     // Edges in target order (m)
+      std::vector<V>           vvals_;   // Vertex values (n)
+      std::vector<E>           evals_;   // Edge values (m)
+    };
+
+  // Construct a graph from the input edges in [first, last), with at least
+  // n vertices. Input edges are as for adjacency_list::assign_edges.
+  //
+  // The range is traversed twice. The first pass counts the degree of each
+  // vertex, and the second places each edge (a counting sort). Edges with
+  // the same source keep their relative input order, but edge handles are
+  // positions in the sorted order, not in the input.
+  template<typename V, typename E, bool B>
+    template<typename I>
+      compressed_directed_graph<V, E, B>::
+        compressed_directed_graph(I first, I last, std::size_t n)
+      {
+        adjacency_list_impl::degree_count c =
+          adjacency_list_impl::count_degrees(first, last, n);
+
+        out_ = std::move(c.out);
+        out_.push_back(0);
+        compressed_graph_impl::prefix_sum(out_);
+        targets_.resize(c.size);
+        evals_.resize(c.size);
+        vvals_.resize(c.order);
+
+        std::vector<std::size_t> next(out_.begin(), out_.end() - 1);
+        for (I i = first; i != last; ++i) {
+          std::size_t u = adjacency_list_impl::input_source(*i);
+          std::size_t k = next[u]++;
+          targets_[k] = adjacency_list_impl::input_target(*i);
+          evals_[k] = adjacency_list_impl::input_value<E>(*i);
+        }
+
+        if (B) {
+          in_ = std::move(c.in);
+          in_.push_back(0);
+          compressed_graph_impl::prefix_sum(in_);
+          ins_.resize(c.size);
+          next.assign(in_.begin(), in_.end() - 1);
+          for (std::size_t e = 0; e < targets_.size(); ++e)
+            ins_[next[targets_[e]]++] = e;
+        }
+      }
+
+  // Construct a graph that adopts the structural arrays a. Vertex and edge
+  // values are default initialized.
+  template<typename V, typename E, bool B>
+    compressed_directed_graph<V, E, B>::compressed_directed_graph(arrays a)
+      : out_(std::move(a.out)),
+        targets_(std::move(a.targets)),
+        in_(std::move(a.in)),
+        ins_(std::move(a.ins)),
+        vvals_(out_.empty() ? 0 : out_.size() - 1),
+        evals_(targets_.size())
+    {
+      assert(out_.empty() || out_.back() == targets_.size());
+      assert(!B || in_.size() == out_.size());
+      assert(!B || ins_.size() == targets_.size());
+    }
+
+  template<typename V, typename E, bool B>
+    inline std::size_t
+    compressed_directed_graph<V, E, B>::in_degree(vertex v) const
+    {
+      static_assert(B, "graph does not store in edges");
+      return in_[v + 1] - in_[v];
+    }
+
+  // Returns the source of e, the vertex whose out edges contain e. Vertices
+  // without out edges share an offset with their successor, so the last
+  // offset not greater than e is the source.
+  template<typename V, typename E, bool B>
+    inline auto
+    compressed_directed_graph<V, E, B>::source(edge e) const -> vertex
+    {
+      auto i = std::upper_bound(out_.begin(), out_.end(), std::size_t(e));
+      return vertex(i - out_.begin() - 1);
+    }
+
+  // Returns the first edge connecting u to v, or an invalid handle if there
+  // is no such edge. The out edges of u are searched, unless the graph is
+  // bidirectional and v has fewer in edges.
+  template<typename V, typename E, bool B>
+    inline auto
+    compressed_directed_graph<V, E, B>::operator()(vertex u, vertex v) const -> edge
+    {
+      return find_edge(u, v, std::integral_constant<bool, B>{});
+    }
+
+  template<typename V, typename E, bool B>
+    auto
+    compressed_directed_graph<V, E, B>::find_edge(vertex u, vertex v, std::false_type) const
+      -> edge
+    {
+      for (std::size_t e = out_[u]; e != out_[u + 1]; ++e)
+        if (targets_[e] == v)
+          return edge(e);
+      return edge();
+    }
+
+  template<typename V, typename E, bool B>
+    auto
+    compressed_directed_graph<V, E, B>::find_edge(vertex u, vertex v, std::true_type) const
+      -> edge
+    {
+      if (in_degree(v) < out_degree(u)) {
+        for (edge e : in_edges(v))
+          if (source(e) == u)
+            return e;
+        return edge();
+      }
+      return find_edge(u, v, std::false_type{});
+    }
+
+  template<typename V, typename E, bool B>
+    inline auto
+    compressed_directed_graph<V, E, B>::vertices() const -> vertex_range
+    {
+      return {0, order()};
+    }
+
+  template<typename V, typename E, bool B>
+    inline auto
+    compressed_directed_graph<V, E, B>::edges() const -> edge_range
+    {
+      return {0, size()};
+    }
+
+  // Return a range over the out edges of the vertex v.
+  template<typename V, typename E, bool B>
+    inline auto
+    compressed_directed_graph<V, E, B>::out_edges(vertex v) const -> out_edge_range
+    {
+      return {out_[v], out_[v + 1]};
+    }
+
+  // Return a range over the in edges of the vertex v.
+  template<typename V, typename E, bool B>
+    inline auto
+    compressed_directed_graph<V, E, B>::in_edges(vertex v) const -> in_edge_range
+    {
+      static_assert(B, "graph does not store in edges");
+      const edge* p = ins_.data();
+      return {p + in_[v], p + in_[v + 1]};
+    }
+
+  // A compressed directed graph stores in edges if it is bidirectional.
+  template<typename V, typename E, bool B>
+    struct in_edge_storage<compressed_directed_graph<V, E, B>>
+      : std::integral_constant<bool, B>
+    { };
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                      [graph.compressed.undir]
+  //                       Compressed Undirected Graph
+  //
+  // A compressed undirected graph is a static graph stored in CSR format.
+  // The incident edges of every vertex are stored contiguously in a single
+  // array of edge handles, indexed by an offsets array. As in the undirected
+  // adjacency list, a loop appears twice in the incidence list of its vertex.
+  //
+  // Edges are numbered in input order, and the endpoints of each edge are
+  // stored with it, so the source and target of an edge are found in
+  // constant time.
+  //
+  // The neighbor reached by each incident edge is stored in a second array,
+  // parallel to the incident edges. Iterating over the incident edges of a
+  // vertex yields incident_edge objects that carry the neighbor, so that
+  // out_neighbor and in_neighbor are sequential reads rather than a lookup
+  // of the endpoints of every edge.
+  //
+  // Performance properties:
+  //    - Degree: O(1)
+  //    - Source, target: O(1)
+  //    - Construction: O(n + m)
+
+  template<typename V = empty_t, typename E = empty_t>
+    class compressed_undirected_graph
+    {
+      using this_type = compressed_undirected_graph<V, E>;
+    public:
+      using vertex = vertex_handle;
+      using vertex_range = compressed_graph_impl::vertex_range;
+
+      using edge = edge_handle;
+      using edge_range = compressed_graph_impl::edge_range;
+
+      using incidence_range = compressed_graph_impl::incidence_range;
+
+      // The structural arrays of a compressed undirected graph. The neighbor
+      // array adj is parallel to inc.
+      struct arrays
+      {
+        std::vector<std::size_t>               off;  // Offsets (n + 1)
+        std::vector<edge>                      inc;  // Incident edges (2m)
+        std::vector<vertex>                    adj;  // Neighbors (2m)
+        std::vector<std::pair<vertex, vertex>> ends; // Endpoints (m)
+      };
+
+      // Construction
+      compressed_undirected_graph() = default;
+
+      template<typename I>
+        compressed_undirected_graph(I first, I last, std::size_t n = 0);
+
+      explicit compressed_undirected_graph(arrays a);
+
+      // Observers
+      bool        null() const  { return vvals_.empty(); }
+      std::size_t order() const { return vvals_.size(); }
+
+      bool        empty() const { return ends_.empty(); }
+      std::size_t size() const  { return ends_.size(); }
+
+      // Vertex observers
+      std::size_t degree(vertex v) const { return off_[v + 1] - off_[v]; }
+
+      // Edge observers
+      // Returns the first and second endpoints of the edge, e. See
+      // undirected_adjacency_list for details.
+      vertex source(edge e) const { return ends_[e].first; }
+      vertex target(edge e) const { return ends_[e].second; }
+
+      // Data access
+      V&       operator()(vertex v)       { return vvals_[v]; }
+      const V& operator()(vertex v) const { return vvals_[v]; }
+
+      E&       operator()(edge e)       { return evals_[e]; }
+      const E& operator()(edge e) const { return evals_[e]; }
+
+      // Relation
+      edge operator()(vertex u, vertex v) const;
+
+      // Iterators
+      vertex_range    vertices() const;
+      edge_range      edges() const;
+      incidence_range edges(vertex v) const;
+
+      // Raw storage
+      // The incident edges of v are incident()[i] for i in [offsets()[v],
+      // offsets()[v + 1]), and neighbors()[i] is the opposite endpoint.
+      const std::vector<std::size_t>& offsets() const   { return off_; }
+      const std::vector<edge>&        incident() const  { return inc_; }
+      const std::vector<vertex>&      neighbors() const { return adj_; }
+
+    private:
+      std::vector<std::size_t>              off_;   // Offsets (n + 1)
+      std::vector<edge>                     inc_;   // Incident edges (2m)
+      std::vector<vertex>                   adj_;   // Neighbors (2m)
+      std::vector<std::pair<vertex, vertex>> ends_; // Endpoints (m)
+      std::vector<V>                        vvals_; // Vertex values (n)
+      std::vector<E>                        evals_; // Edge values (m)
+    };
+
+  // Construct a graph from the input edges in [first, last), with at least
+  // n vertices. Edge handles are positions in the input.
+  template<typename V, typename E>
+    template<typename I>
+      compressed_undirected_graph<V, E>::
+        compressed_undirected_graph(I first, I last, std::size_t n)
+      {
+        adjacency_list_impl::degree_count c =
+          adjacency_list_impl::count_degrees(first, last, n);
+
+        off_.resize(c.order + 1, 0);
+        for (std::size_t v = 0; v < c.order; ++v)
+          off_[v] = c.out[v] + c.in[v];
+        compressed_graph_impl::prefix_sum(off_);
+        inc_.resize(2 * c.size);
+        adj_.resize(2 * c.size);
+        ends_.reserve(c.size);
+        evals_.reserve(c.size);
+        vvals_.resize(c.order);
+
+        std::vector<std::size_t> next(off_.begin(), off_.end() - 1);
+        for (I i = first; i != last; ++i) {
+          std::size_t u = adjacency_list_impl::input_source(*i);
+          std::size_t v = adjacency_list_impl::input_target(*i);
+          edge e = ends_.size();
+          ends_.emplace_back(u, v);
+          evals_.push_back(adjacency_list_impl::input_value<E>(*i));
+          adj_[next[u]] = v;
+          inc_[next[u]++] = e;
+          adj_[next[v]] = u;
+          inc_[next[v]++] = e;
+        }
+      }
+
+  // Construct a graph that adopts the structural arrays a. Vertex and edge
+  // values are default initialized.
+  template<typename V, typename E>
+    compressed_undirected_graph<V, E>::compressed_undirected_graph(arrays a)
+      : off_(std::move(a.off)),
+        inc_(std::move(a.inc)),
+        adj_(std::move(a.adj)),
+        ends_(std::move(a.ends)),
+        vvals_(off_.empty() ? 0 : off_.size() - 1),
+        evals_(ends_.size())
+    {
+      assert(off_.empty() || off_.back() == inc_.size());
+      assert(inc_.size() == 2 * ends_.size());
+      assert(adj_.size() == inc_.size());
+    }
+
+  // Returns the first edge connecting u to v, or an invalid handle if there
+  // is no such edge. The vertex with the smaller degree is searched.
+  template<typename V, typename E>
+    auto
+    compressed_undirected_graph<V, E>::operator()(vertex u, vertex v) const -> edge
+    {
+      if (degree(v) < degree(u))
+        std::swap(u, v);
+      for (edge e : edges(u))
+        if (are_endpoints(*this, e, u, v))
+          return e;
+      return edge();
+    }
+
+  template<typename V, typename E>
+    inline auto
+    compressed_undirected_graph<V, E>::vertices() const -> vertex_range
+    {
+      return {0, order()};
+    }
+
+  template<typename V, typename E>
+    inline auto
+    compressed_undirected_graph<V, E>::edges() const -> edge_range
+    {
+      return {0, size()};
+    }
+
+  // Return a range over the edges incident to v.
+  template<typename V, typename E>
+    inline auto
+    compressed_undirected_graph<V, E>::edges(vertex v) const -> incidence_range
+    {
+      const edge* p = inc_.data();
+      const vertex* q = adj_.data();
+      return {{p + off_[v], q + off_[v]}, {p + off_[v + 1], q + off_[v + 1]}};
+    }
+
+  // Returns the neighbor reached by the incident edge e, which is stored
+  // with the edge.
+  template<typename V, typename E>
+    inline vertex_handle
+    out_neighbor(const compressed_undirected_graph<V, E>&,
+                 compressed_graph_impl::incident_edge e, vertex_handle)
+    {
+      return e.neighbor;
+    }
+
+  template<typename V, typename E>
+    inline vertex_handle
+    in_neighbor(const compressed_undirected_graph<V, E>&,
+                compressed_graph_impl::incident_edge e, vertex_handle)
+    {
+      return e.neighbor;
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,135 @@
+// Copyright (c) 2009-2015 Andrew Sutton
+// All rights reserved
+
+#include <cassert>
+#include <iostream>
+
+#include <origin.graph/compressed_graph.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+// The input edges used by all checks. See check_assign_edges.
+vector<tuple<int, int, int>> input {
+  {0, 1, 10}, {1, 2, 11}, {2, 0, 12}, {2, 2, 13}, {4, 0, 14}
+};
+
+// Check the structure shared by all compressed graphs.
+template<typename G>
+  void
+  check_compressed()
+  {
+    cout << "*** compressed (" << typestr<G>() << ") ***\n";
+    G g0;
+    assert(g0.null());
+    assert(g0.empty());
+
+    G g(input.begin(), input.end(), 6);
+    assert(g.order() == 6);
+    assert(g.size() == 5);
+    assert(has_degrees(g, 0, {1, 2, 3})); // a--b | c--a, e--a
+    assert(has_degrees(g, 2, {2, 2, 4})); // c--a, c--c | b--c, c--c
+    assert(has_degrees(g, 3, {0, 0, 0}));
+    assert(has_degrees(g, 5, {0, 0, 0}));
+
+    // Every input edge is found by its endpoints, with its value.
+    for (const auto& x : input) {
+      auto e = g(get<0>(x), get<1>(x));
+      assert(e);
+      assert(source(g, e) == vertex_handle(get<0>(x)));
+      assert(target(g, e) == vertex_handle(get<1>(x)));
+      assert(g(e) == get<2>(x));
+    }
+    assert(!g(3, 4));
+
+    size_t n = 0;
+    for (auto v : vertices(g)) {
+      assert(size_t(v) == n);
+      ++n;
+    }
+    assert(n == 6);
+    assert(edges(g).end() - edges(g).begin() == 5);
+
+    g(g(2, 2)) = 20;
+    assert(g(g(2, 2)) == 20);
+  }
+
+// Check that the out edges of each vertex are contiguous, so that the
+// offsets and targets arrays describe the graph.
+template<typename G>
+  void
+  check_directed_layout()
+  {
+    cout << "*** directed layout (" << typestr<G>() << ") ***\n";
+    G g(input.begin(), input.end());
+    assert(g.order() == 5);
+    const auto& off = g.out_offsets();
+    assert(off.size() == 6);
+    assert(off.front() == 0 && off.back() == 5);
+    for (auto v : vertices(g)) {
+      assert(off[v + 1] - off[v] == g.out_degree(v));
+      for (auto e : g.out_edges(v)) {
+        assert(g.source(e) == v);
+        assert(g.targets()[e] == g.target(e));
+      }
+    }
+    assert(g.source(g(4, 0)) == vertex_handle(4));
+  }
+
+int main()
+{
+  using D = compressed_directed_graph<char, int>;
+  check_compressed<D>();
+  check_directed_layout<D>();
+
+  // In edges of the bidirectional graph.
+  {
+    D g(input.begin(), input.end());
+    size_t n = 0;
+    for (auto e : g.in_edges(0)) {
+      assert(g.target(e) == vertex_handle(0));
+      ++n;
+    }
+    assert(n == 2);
+  }
+
+  using S = compressed_directed_graph<char, int, false>;
+  check_directed_layout<S>();
+  {
+    S g(input.begin(), input.end());
+    assert(g(2, 0));
+    assert(!g(0, 2));
+  }
+
+  using U = compressed_undirected_graph<char, int>;
+  check_compressed<U>();
+  {
+    // Edges are found from either endpoint, and loops appear twice.
+    U g(input.begin(), input.end());
+    assert(g(1, 0) == g(0, 1));
+    assert(g.degree(2) == 4);
+    size_t loops = 0;
+    for (auto e : g.edges(2))
+      if (source(g, e) == target(g, e))
+        ++loops;
+    assert(loops == 2);
+
+    // The neighbor array is parallel to the incident edges, and is what
+    // out_neighbor reads.
+    const auto& off = g.offsets();
+    for (auto v : vertices(g)) {
+      size_t i = off[v];
+      for (auto e : g.edges(v)) {
+        assert(g.incident()[i] == e);
+        assert(g.neighbors()[i] == opposite(g, e, v));
+        assert(out_neighbor(g, e, v) == opposite(g, e, v));
+        assert(in_neighbor(g, e, v) == opposite(g, e, v));
+        ++i;
+      }
+      assert(i == off[v + 1]);
+    }
+  }
+}
@@ -0,0 +1,4 @@
+// Copyright (c) 2009-2015 Andrew Sutton
+// All rights reserved
+
+#include "edge_reader.hpp"
@@ -0,0 +1,422 @@
+// Copyright (c) 2009-2015 Andrew Sutton
+// All rights reserved
+
+#ifndef ORIGIN_GRAPH_EDGE_READER_HPP
+#define ORIGIN_GRAPH_EDGE_READER_HPP
+
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <origin/type/empty.hpp>
+
+#include <origin.graph/parallel.hpp>
+#include <origin.graph/io.impl/mapped_file.hpp>
+
+namespace origin
+{
+  namespace io
+  {
+    // ---------------------------------------------------------------------- //
+    //                                                           [graph.io.read]
+    //                              Edge Readers
+    //
+    // The edge readers parse text files of edges into a vector of input
+    // edges, which can be used to build any graph in bulk (see
+    // adjacency_list::assign_edges). Two formats are supported:
+    //
+    //    - Edge lists, where each line has the source and target of an edge,
+    //      separated by blanks, and optionally a value. Vertices are numbered
+    //      from 0. Lines starting with '#' or '%' are comments.
+    //    - Matrix Market coordinate files, where each entry is an edge. Rows
+    //      and columns are numbered from 1. Entries of symmetric matrices
+    //      are read as a pair of edges, one in each direction.
+    //
+    // Files are mapped into memory and divided into blocks at line
+    // boundaries. Each block is parsed on its own thread, and the results
+    // are concatenated, so edges appear in file order. Integers are parsed
+    // without locales or streams.
+    //
+    // If W is not empty, each edge has a value of type W, read from the
+    // field following its target. Fields following the last used field of
+    // a line are ignored. Malformed lines cause a std::runtime_error to be
+    // thrown, giving the offset of the line in the file.
+
+    // The minimum number of bytes parsed by each thread.
+    constexpr std::size_t read_grain = 1 << 20;
+
+    // An input edge is a pair of vertex indexes, or a tuple of vertex indexes
+    // and a value of type W.
+    template<typename W>
+      using input_edge = typename std::conditional<
+        std::is_empty<W>::value,
+        std::pair<std::size_t, std::size_t>,
+        std::tuple<std::size_t, std::size_t, W>
+      >::type;
+
+    // The edges read from a file. The order is the number of vertices of
+    // the graph, which is at least one more than the greatest vertex index.
+    template<typename W = empty_t>
+      struct input_edges
+      {
+        std::size_t order = 0;
+        std::vector<input_edge<W>> edges;
+      };
+
+
+    namespace reader_impl
+    {
+      inline bool
+      is_blank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+      inline bool
+      is_digit(char c) { return '0' <= c && c <= '9'; }
+
+      inline const char*
+      skip_blanks(const char* p, const char* l)
+      {
+        while (p != l && is_blank(*p))
+          ++p;
+        return p;
+      }
+
+      // Returns the end of the line starting at p, which is either the
+      // position of a newline or l.
+      inline const char*
+      end_of_line(const char* p, const char* l)
+      {
+        const void* q = std::memchr(p, '\n', l - p);
+        return q ? static_cast<const char*>(q) : l;
+      }
+
+      // Returns true if the field starting at p is terminated properly.
+      inline bool
+      ends_field(const char* p, const char* l) { return p == l || is_blank(*p); }
+
+      // Parse an unsigned integer at p, after skipping blanks. Returns the
+      // position following the integer, or nullptr if there is no integer
+      // or it does not fit in x.
+      inline const char*
+      parse_index(const char* p, const char* l, std::size_t& x)
+      {
+        p = skip_blanks(p, l);
+        const char* s = p;
+        std::size_t n = 0;
+        for ( ; p != l && is_digit(*p); ++p) {
+          std::size_t d = *p - '0';
+          if (n > (std::size_t(-1) - d) / 10)
+            return nullptr;
+          n = n * 10 + d;
+        }
+        if (p == s || !ends_field(p, l))
+          return nullptr;
+        x = n;
+        return p;
+      }
+
+      // Parse a value of type T at p, after skipping blanks. Integers are
+      // parsed directly, and must be in the range of T. Floating point
+      // values are parsed with strtod.
+      template<typename T>
+        const char*
+        parse_value(const char* p, const char* l, T& x, std::true_type)
+        {
+          p = skip_blanks(p, l);
+          bool neg = p != l && *p == '-';
+          if (neg || (p != l && *p == '+'))
+            ++p;
+          std::size_t n;
+          p = parse_index(p, l, n);
+          if (!p || (neg && !std::is_signed<T>::value))
+            return nullptr;
+          // The magnitude of the least value of a signed type is one more
+          // than its greatest value.
+          if (n > std::size_t(std::numeric_limits<T>::max()) + neg)
+            return nullptr;
+          x = neg && n != 0 ? T(-T(n - 1) - 1) : T(n);
+          return p;
+        }
+
+      template<typename T>
+        const char*
+        parse_value(const char* p, const char* l, T& x, std::false_type)
+        {
+          // The mapped file is not null terminated, so copy the field.
+          p = skip_blanks(p, l);
+          char buf[64];
+          std::size_t n = 0;
+          while (p + n != l && !is_blank(p[n]) && n < sizeof(buf) - 1) {
+            buf[n] = p[n];
+            ++n;
+          }
+          if (p + n != l && !is_blank(p[n]))
+            return nullptr;
+          buf[n] = 0;
+          char* e;
+          x = T(std::strtod(buf, &e));
+          if (n == 0 || e != buf + n)
+            return nullptr;
+          return p + n;
+        }
+
+      // Empty values are not read.
+      struct no_value { };
+
+      template<typename T>
+        inline const char*
+        parse_value(const char* p, const char*, T&, no_value) { return p; }
+
+      template<typename T>
+        inline const char*
+        parse_value(const char* p, const char* l, T& x)
+        {
+          using Kind = typename std::conditional<
+            std::is_empty<T>::value, no_value, std::is_integral<T>
+          >::type;
+          return parse_value(p, l, x, Kind{});
+        }
+
+      // Construct an input edge.
+      template<typename W>
+        inline input_edge<W>
+        make_edge(std::size_t u, std::size_t v, const W&, std::true_type)
+        {
+          return {u, v};
+        }
+
+      template<typename W>
+        inline input_edge<W>
+        make_edge(std::size_t u, std::size_t v, const W& w, std::false_type)
+        {
+          return input_edge<W>(u, v, w);
+        }
+
+      template<typename W>
+        inline input_edge<W>
+        make_edge(std::size_t u, std::size_t v, const W& w)
+        {
+          return make_edge<W>(u, v, w, std::is_empty<W>{});
+        }
+
+      // Returns the value of the mirror of a skew-symmetric entry.
+      template<typename W>
+        inline W
+        mirror_value(const W& w, std::true_type) { return -w; }
+
+      template<typename W>
+        inline W
+        mirror_value(const W& w, std::false_type) { return w; }
+
+      template<typename W>
+        inline W
+        mirror_value(const W& w) { return mirror_value(w, std::is_arithmetic<W>{}); }
+
+      [[noreturn]] inline void
+      bad_line(const char* what, std::size_t offset)
+      {
+        throw std::runtime_error(std::string(what) + ": malformed line at byte "
+                                 + std::to_string(offset));
+      }
+
+      // The edges parsed from one block of a file.
+      template<typename W>
+        struct block
+        {
+          std::vector<input_edge<W>> edges;
+          std::size_t order = 0;
+          std::size_t entries = 0;
+        };
+
+      // Divide the text [first, last) into blocks at line boundaries and
+      // call f(p, eol, b) on each line [p, eol) of each block, in parallel,
+      // where b is the block. The blocks are concatenated in order, and the
+      // number of entries counted by f is stored in entries.
+      template<typename W, typename F>
+        input_edges<W>
+        parse_lines(const char* first, const char* last, F f, std::size_t& entries)
+        {
+          std::size_t n = last - first;
+          std::vector<block<W>> blocks(parallel_block_count(n, read_grain));
+          parallel_blocks(n, [&](std::size_t b, std::size_t i, std::size_t j) {
+            // A block owns the lines that start in [i, j).
+            const char* p = first + i;
+            if (i != 0 && p[-1] != '\n') {
+              p = end_of_line(p, last);
+              if (p != last)
+                ++p;
+            }
+            const char* l = first + j;
+            while (p < l) {
+              const char* eol = end_of_line(p, last);
+              f(p, eol, blocks[b]);
+              p = eol == last ? last : eol + 1;
+            }
+          }, read_grain);
+
+          // Concatenate the blocks.
+          input_edges<W> r;
+          std::vector<std::size_t> off(blocks.size() + 1, 0);
+          entries = 0;
+          for (std::size_t b = 0; b < blocks.size(); ++b) {
+            off[b + 1] = off[b] + blocks[b].edges.size();
+            r.order = std::max(r.order, blocks[b].order);
+            entries += blocks[b].entries;
+          }
+          r.edges.resize(off.back());
+          parallel_for(blocks.size(), [&](std::size_t b) {
+            std::copy(blocks[b].edges.begin(), blocks[b].edges.end(),
+                      r.edges.begin() + off[b]);
+            blocks[b].edges = {};
+          }, 1);
+          return r;
+        }
+
+    } // namespace reader_impl
+
+
+    // Parse the edge list in the text [first, last).
+    template<typename W = empty_t>
+      input_edges<W>
+      parse_edge_list(const char* first, const char* last)
+      {
+        using namespace reader_impl;
+        std::size_t entries;
+        return parse_lines<W>(first, last, [first](const char* p, const char* l, block<W>& b) {
+          p = skip_blanks(p, l);
+          if (p == l || *p == '#' || *p == '%')
+            return;
+          std::size_t u, v;
+          W w{};
+          const char* q = p;
+          // The greatest index is not a vertex: it is the invalid handle,
+          // and the order of the graph would not be representable.
+          if (!(q = parse_index(q, l, u)) || !(q = parse_index(q, l, v))
+              || u == std::size_t(-1) || v == std::size_t(-1))
+            bad_line("edge list", p - first);
+          if (!parse_value(q, l, w))
+            bad_line("edge list", p - first);
+          b.edges.push_back(make_edge<W>(u, v, w));
+          b.order = std::max(b.order, std::max(u, v) + 1);
+        }, entries);
+      }
+
+    // Read the edge list in the file at path.
+    template<typename W = empty_t>
+      input_edges<W>
+      read_edge_list(const std::string& path)
+      {
+        mapped_file f(path);
+        return parse_edge_list<W>(f.begin(), f.end());
+      }
+
+
+    // Parse the Matrix Market coordinate matrix in the text [first, last).
+    // The order of the graph is the greater of the number of rows and
+    // columns. Pattern matrices have no values, so edges have the default
+    // value of W. Throws std::runtime_error if the banner is not that of a
+    // general, symmetric or skew-symmetric coordinate matrix, or if the
+    // number of entries does not match the size line.
+    template<typename W = empty_t>
+      input_edges<W>
+      parse_matrix_market(const char* first, const char* last)
+      {
+        using namespace reader_impl;
+        auto fail = [](const std::string& msg) {
+          throw std::runtime_error("matrix market: " + msg);
+        };
+
+        // Banner
+        const char* eol = end_of_line(first, last);
+        std::string banner(first, eol);
+        for (char& c : banner)
+          c = std::tolower(static_cast<unsigned char>(c));
+        if (banner.compare(0, 14, "%%matrixmarket") != 0)
+          fail("missing banner");
+        if (banner.find(" matrix ") == std::string::npos
+            || banner.find(" coordinate ") == std::string::npos)
+          fail("not a coordinate matrix");
+        if (banner.find(" complex") != std::string::npos)
+          fail("complex matrices are not supported");
+        bool pattern = banner.find(" pattern") != std::string::npos;
+        bool skew = banner.find(" skew-symmetric") != std::string::npos;
+        bool symmetric = skew || banner.find(" symmetric") != std::string::npos;
+        if (!symmetric && banner.find(" general") == std::string::npos)
+          fail("unsupported symmetry");
+
+        // Comments and the size line.
+        std::size_t rows, cols, nnz;
+        for (;;) {
+          if (eol == last)
+            fail("missing size line");
+          const char* p = skip_blanks(eol + 1, last);
+          eol = end_of_line(p, last);
+          if (p == eol || *p == '%')
+            continue;
+          const char* q = p;
+          if (!(q = parse_index(q, eol, rows))
+              || !(q = parse_index(q, eol, cols))
+              || !(q = parse_index(q, eol, nnz)))
+            bad_line("matrix market", p - first);
+          break;
+        }
+        const char* body = eol == last ? last : eol + 1;
+
+        // Entries
+        std::size_t entries;
+        input_edges<W> r = parse_lines<W>(body, last,
+          [=](const char* p, const char* l, block<W>& b) {
+            p = skip_blanks(p, l);
+            if (p == l || *p == '%')
+              return;
+            std::size_t u, v;
+            W w{};
+            const char* q = p;
+            if (!(q = parse_index(q, l, u)) || !(q = parse_index(q, l, v))
+                || u == 0 || u > rows || v == 0 || v > cols)
+              bad_line("matrix market", p - first);
+            if (!pattern && !parse_value(q, l, w))
+              bad_line("matrix market", p - first);
+            b.edges.push_back(make_edge<W>(u - 1, v - 1, w));
+            if (symmetric && u != v)
+              b.edges.push_back(make_edge<W>(v - 1, u - 1, skew ? mirror_value(w) : w));
+            ++b.entries;
+          }, entries);
+
+        if (entries != nnz)
+          fail("expected " + std::to_string(nnz) + " entries");
+        r.order = std::max(rows, cols);
+        return r;
+      }
+
+    // Read the Matrix Market coordinate matrix in the file at path.
+    template<typename W = empty_t>
+      input_edges<W>
+      read_matrix_market(const std::string& path)
+      {
+        mapped_file f(path);
+        return parse_matrix_market<W>(f.begin(), f.end());
+      }
+
+
+    // Build a graph of type G from the input edges x.
+    template<typename G, typename W>
+      inline G
+      make_graph(const input_edges<W>& x)
+      {
+        return G(x.edges.begin(), x.edges.end(), x.order);
+      }
+
+  } // namespace io
+} // namespace origin
+
+#endif
@@ -0,0 +1,212 @@
+// Copyright (c) 2009-2015 Andrew Sutton
+// All rights reserved
+
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+#include <origin.graph/adjacency_list.hpp>
+#include <origin.graph/adjacency_vector.hpp>
+#include <origin.graph/edge_reader.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+// The file written and read by each check.
+const char* path = "edge_reader.test.txt";
+
+template<typename W>
+  io::input_edges<W>
+  parse_edge_list(const string& s)
+  {
+    return io::parse_edge_list<W>(s.data(), s.data() + s.size());
+  }
+
+template<typename W>
+  io::input_edges<W>
+  parse_matrix_market(const string& s)
+  {
+    return io::parse_matrix_market<W>(s.data(), s.data() + s.size());
+  }
+
+// Returns true if f throws a runtime error.
+template<typename F>
+  bool
+  rejects(F f)
+  {
+    try {
+      f();
+    } catch (std::runtime_error&) {
+      return true;
+    }
+    return false;
+  }
+
+void
+check_edge_list()
+{
+  cout << "*** edge list ***\n";
+  string text =
+    "# a comment\n"
+    "0 1\n"
+    "\n"
+    "  1\t2  \r\n"
+    "% another comment\n"
+    "4 0 99\n"
+    "2 2";
+  auto x = parse_edge_list<empty_t>(text);
+  assert(x.order == 5);
+  assert(x.edges.size() == 4);
+  assert(x.edges[0] == make_pair(size_t(0), size_t(1)));
+  assert(x.edges[1] == make_pair(size_t(1), size_t(2)));
+  assert(x.edges[2] == make_pair(size_t(4), size_t(0)));
+  assert(x.edges[3] == make_pair(size_t(2), size_t(2)));
+
+  auto y = parse_edge_list<int>("0 1 -5\n1 2 7\n");
+  assert(y.edges.size() == 2);
+  assert(get<2>(y.edges[0]) == -5);
+  assert(get<2>(y.edges[1]) == 7);
+
+  auto z = parse_edge_list<double>("0 1 0.25\n1 2 1e3");
+  assert(get<2>(z.edges[0]) == 0.25);
+  assert(get<2>(z.edges[1]) == 1000);
+
+  assert(parse_edge_list<empty_t>("").edges.empty());
+  assert(rejects([] { parse_edge_list<empty_t>("0 1\n0 x\n"); }));
+  assert(rejects([] { parse_edge_list<empty_t>("0 1\n2\n"); }));
+  assert(rejects([] { parse_edge_list<empty_t>("0 -1\n"); }));
+  assert(rejects([] { parse_edge_list<int>("0 1\n"); }));
+  assert(rejects([] { parse_edge_list<unsigned>("0 1 -2\n"); }));
+  assert(rejects([] { parse_edge_list<empty_t>("99999999999999999999999 1\n"); }));
+
+  // Values must be in the range of their type.
+  auto m = parse_edge_list<int>("0 1 2147483647\n1 2 -2147483648\n2 3 -0\n");
+  assert(get<2>(m.edges[0]) == 2147483647);
+  assert(get<2>(m.edges[1]) == -2147483647 - 1);
+  assert(get<2>(m.edges[2]) == 0);
+  assert(rejects([] { parse_edge_list<int>("0 1 5000000000\n"); }));
+  assert(rejects([] { parse_edge_list<int>("0 1 -3000000000\n"); }));
+  assert(rejects([] { parse_edge_list<int>("0 1 2147483648\n"); }));
+  assert(rejects([] { parse_edge_list<int>("0 1 -2147483649\n"); }));
+  assert(rejects([] { parse_edge_list<unsigned char>("0 1 256\n"); }));
+
+  // The greatest index would wrap the order of the graph.
+  string top = to_string(size_t(-1));
+  assert(rejects([&] { parse_edge_list<empty_t>(top + " 0\n"); }));
+  assert(rejects([&] { parse_edge_list<empty_t>("0 " + top + "\n"); }));
+}
+
+void
+check_matrix_market()
+{
+  cout << "*** matrix market ***\n";
+  string general =
+    "%%MatrixMarket matrix coordinate real general\n"
+    "% comment\n"
+    "3 4 3\n"
+    "1 2 0.5\n"
+    "3 4 1.5\n"
+    "2 2 2.5\n";
+  auto x = parse_matrix_market<double>(general);
+  assert(x.order == 4);
+  assert(x.edges.size() == 3);
+  assert(x.edges[0] == make_tuple(size_t(0), size_t(1), 0.5));
+  assert(x.edges[1] == make_tuple(size_t(2), size_t(3), 1.5));
+
+  string symmetric =
+    "%%MatrixMarket matrix coordinate integer skew-symmetric\n"
+    "3 3 2\n"
+    "2 1 5\n"
+    "3 3 1\n";
+  auto y = parse_matrix_market<int>(symmetric);
+  assert(y.edges.size() == 3);
+  assert(y.edges[0] == make_tuple(size_t(1), size_t(0), 5));
+  assert(y.edges[1] == make_tuple(size_t(0), size_t(1), -5));
+
+  string pattern =
+    "%%MatrixMarket matrix coordinate pattern symmetric\n"
+    "2 2 1\n"
+    "2 1\n";
+  auto z = parse_matrix_market<empty_t>(pattern);
+  assert(z.edges.size() == 2);
+  auto w = parse_matrix_market<int>(pattern);
+  assert(get<2>(w.edges[0]) == 0);
+
+  assert(rejects([] { parse_matrix_market<empty_t>("1 2\n"); }));
+  assert(rejects([] {
+    parse_matrix_market<empty_t>("%%MatrixMarket matrix array real general\n2 2\n");
+  }));
+  assert(rejects([] {
+    parse_matrix_market<empty_t>("%%MatrixMarket matrix coordinate real general\n2 2 2\n1 1 1\n");
+  }));
+  assert(rejects([] {
+    parse_matrix_market<empty_t>("%%MatrixMarket matrix coordinate real general\n2 2 1\n3 1 1\n");
+  }));
+}
+
+// Check that a large file, parsed in many blocks, is read in order and
+// builds the same graphs as the input.
+void
+check_large()
+{
+  cout << "*** large edge list ***\n";
+  minstd_rand gen(7);
+  vector<tuple<size_t, size_t, int>> input;
+  ostringstream ss;
+  for (int i = 0; i < 200000; ++i) {
+    size_t u = gen() % 5000, v = gen() % 5000;
+    int w = int(gen() % 1000) - 500;
+    input.emplace_back(u, v, w);
+    ss << u << ' ' << v << ' ' << w << '\n';
+  }
+  {
+    ofstream os(path);
+    os << ss.str();
+  }
+
+  auto x = io::read_edge_list<int>(path);
+  assert(x.edges == input);
+
+  using G = directed_adjacency_vector<empty_t, int>;
+  G g = io::make_graph<G>(x);
+  assert(g.size() == input.size());
+  for (auto e : edges(g)) {
+    assert(size_t(g.source(e)) == get<0>(input[e]));
+    assert(g(e) == get<2>(input[e]));
+  }
+
+  using H = directed_adjacency_list<empty_t, int>;
+  H h = io::make_graph<H>(x);
+  assert(h.size() == input.size());
+  assert(h.order() == g.order());
+
+  // The same edges as a Matrix Market file, without values.
+  {
+    ofstream os(path);
+    os << "%%MatrixMarket matrix coordinate pattern general\n";
+    os << "5000 5000 " << input.size() << '\n';
+    for (const auto& e : input)
+      os << get<0>(e) + 1 << ' ' << get<1>(e) + 1 << '\n';
+  }
+  auto y = io::read_matrix_market(path);
+  assert(y.order == 5000);
+  assert(y.edges.size() == input.size());
+  for (size_t i = 0; i < input.size(); ++i)
+    assert(y.edges[i] == make_pair(get<0>(input[i]), get<1>(input[i])));
+
+  std::remove(path);
+}
+
+int main()
+{
+  check_edge_list();
+  check_matrix_market();
+  check_large();
+}
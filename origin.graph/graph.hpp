@@ -4,6 +4,11 @@
 #ifndef GRAPH_HPP
 #define GRAPH_HPP
 
+#include <cassert>
+
+#include <algorithm>
+#include <type_traits>
+
 #include <origin.graph/concepts.hpp>
 
 namespace origin
@@ -93,6 +98,111 @@ namespace origin
 
 
 
+  // ------------------------------------------------------------------------ //
+  //                                                           [graph.adjacency]
+  //                              Adjacency
+  //
+  // Traversal algorithms follow the edges leaving (or entering) a vertex to
+  // its neighbors. In a directed graph, these are the out (or in) edges. In
+  // an undirected graph, both are the incident edges of the vertex, and the
+  // neighbor is the opposite endpoint. The following operations let these
+  // algorithms be written once for both kinds of graph.
+
+  // Returns the edges leaving v.
+  template<typename G>
+    inline auto
+    out_edges(const G& g, Vertex<G> v) -> decltype(g.out_edges(v)) { return g.out_edges(v); }
+
+  template<typename G>
+    inline auto
+    out_edges(const G& g, Vertex<G> v) -> decltype(g.edges(v)) { return g.edges(v); }
+
+  // Returns the edges entering v.
+  template<typename G>
+    inline auto
+    in_edges(const G& g, Vertex<G> v) -> decltype(g.in_edges(v)) { return g.in_edges(v); }
+
+  template<typename G>
+    inline auto
+    in_edges(const G& g, Vertex<G> v) -> decltype(g.edges(v)) { return g.edges(v); }
+
+  // Returns the number of edges leaving v.
+  template<typename G>
+    inline Requires<Directed_graph<G>(), std::size_t>
+    out_degree(const G& g, Vertex<G> v) { return g.out_degree(v); }
+
+  template<typename G>
+    inline Requires<Undirected_graph<G>(), std::size_t>
+    out_degree(const G& g, Vertex<G> v) { return g.degree(v); }
+
+  // Returns the number of edges entering v.
+  template<typename G>
+    inline Requires<Directed_graph<G>(), std::size_t>
+    in_degree(const G& g, Vertex<G> v) { return g.in_degree(v); }
+
+  template<typename G>
+    inline Requires<Undirected_graph<G>(), std::size_t>
+    in_degree(const G& g, Vertex<G> v) { return g.degree(v); }
+
+  // Returns the vertex reached by following the edge e, which leaves v.
+  template<typename G>
+    inline Requires<Directed_graph<G>(), Vertex<G>>
+    out_neighbor(const G& g, Edge<G> e, Vertex<G>) { return target(g, e); }
+
+  template<typename G>
+    inline Requires<Undirected_graph<G>(), Vertex<G>>
+    out_neighbor(const G& g, Edge<G> e, Vertex<G> v) { return opposite(g, e, v); }
+
+  // Returns the vertex from which the edge e enters v.
+  template<typename G>
+    inline Requires<Directed_graph<G>(), Vertex<G>>
+    in_neighbor(const G& g, Edge<G> e, Vertex<G>) { return source(g, e); }
+
+  template<typename G>
+    inline Requires<Undirected_graph<G>(), Vertex<G>>
+    in_neighbor(const G& g, Edge<G> e, Vertex<G> v) { return opposite(g, e, v); }
+
+  // Returns the number of edges leaving all vertices. In an undirected
+  // graph, each edge leaves both of its endpoints.
+  template<typename G>
+    inline Requires<Directed_graph<G>(), std::size_t>
+    out_edge_count(const G& g) { return g.size(); }
+
+  template<typename G>
+    inline Requires<Undirected_graph<G>(), std::size_t>
+    out_edge_count(const G& g) { return 2 * g.size(); }
+
+  // True if graphs of type G can store the edges entering each vertex, so
+  // that in_edges and in_degree may be instantiated. This is true unless
+  // the trait is specialized otherwise (e.g., for compressed graphs that
+  // are not bidirectional). Algorithms that need in edges dispatch on the
+  // trait, so they are not instantiated for graphs that lack them.
+  template<typename G>
+    struct in_edge_storage : std::true_type
+    { };
+
+  // Returns true if the edges entering each vertex of g are stored. This is
+  // in_edge_storage<G>::value, unless a graph decides at run time (e.g.,
+  // mapped graphs, where it depends on the file).
+  template<typename G>
+    constexpr bool
+    stores_in_edges(const G&) { return in_edge_storage<G>::value; }
+
+  // Returns one more than the greatest vertex index of g. Algorithms use the
+  // bound to size arrays indexed by vertex. For graphs whose vertices are
+  // numbered [0, n), the bound is the order of the graph.
+  template<typename G>
+    std::size_t
+    vertex_bound(const G& g)
+    {
+      std::size_t n = 0;
+      for (auto v : vertices(g))
+        n = std::max<std::size_t>(n, std::size_t(v) + 1);
+      return n;
+    }
+
+
+
   // ------------------------------------------------------------------------ //
   //                                                                [graph.pred]
   //                          Common Graph Predicates
@@ -6,6 +6,9 @@
 
 #include <cassert>
 #include <iostream>
+#include <random>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 #include <origin.graph/graph.hpp>
@@ -37,6 +40,23 @@ namespace testing
       return g.degree(v) == a[2];
     }
 
+  // Reserve storage for k incident edges of v. In a directed graph, this
+  // reserves k out edges and k in edges.
+  template<typename G>
+    origin::Requires<origin::Directed_graph<G>(), void>
+    reserve_incidence(G& g, Vertex<G> v, size_t k)
+    {
+      g.reserve_out(v, k);
+      g.reserve_in(v, k);
+    }
+
+  template<typename G>
+    origin::Requires<origin::Undirected_graph<G>(), void>
+    reserve_incidence(G& g, Vertex<G> v, size_t k)
+    {
+      g.reserve_incident(v, k);
+    }
+
 
   // -------------------------------------------------------------------------- //
   //                              Graph Construction
@@ -328,6 +348,94 @@ namespace testing
       assert(g.empty());
     }
 
+  // Check bulk construction from a range of input edges.
+  template<typename G>
+    void
+    check_assign_edges()
+    {
+      cout << "*** assign edges (" << typestr<G>() << ") ***\n";
+      vector<tuple<int, int, int>> in {
+        {0, 1, 10}, {1, 2, 11}, {2, 0, 12}, {2, 2, 13}, {4, 0, 14}
+      };
+      G g(in.begin(), in.end(), 6);
+      assert(g.order() == 6);
+      assert(g.size() == 5);
+      assert(has_degrees(g, 0, {1, 2, 3})); // a--b | c--a, e--a
+      assert(has_degrees(g, 2, {2, 2, 4})); // c--a, c--c | b--c, c--c
+      assert(has_degrees(g, 3, {0, 0, 0}));
+      assert(g(g(1, 2)) == 11);
+      assert(g(g(4, 0)) == 14);
+
+      // Assignment replaces the graph. Without a hint, the order is
+      // determined by the greatest endpoint.
+      vector<pair<int, int>> pairs {{0, 1}, {1, 0}};
+      g.assign_edges(pairs.begin(), pairs.end());
+      assert(g.order() == 2);
+      assert(g.size() == 2);
+      assert(has_degrees(g, 0, {1, 1, 2}));
+      assert(g(0, 1));
+
+      g.assign_edges(pairs.begin(), pairs.begin());
+      assert(g.null());
+    }
+
+  // Check that reserved storage is reported, is not reallocated as the
+  // graph grows, and is released by shrinking.
+  template<typename G>
+    void
+    check_reserve()
+    {
+      cout << "*** reserve (" << typestr<G>() << ") ***\n";
+      G g;
+      g.reserve_vertices(100);
+      g.reserve_edges(200);
+      auto c = g.capacity();
+      assert(c.vertices >= 100);
+      assert(c.edges >= 200);
+      assert(c.incidence == 0);
+
+      for (int i = 0; i < 3; ++i)
+        g.add_vertex('a' + i);
+      reserve_incidence(g, 0, 50);
+      assert(g.capacity().incidence >= 50);
+      for (int i = 0; i < 20; ++i)
+        g.add_edge(0, 1 + i % 2, i);
+      assert(g.capacity().vertices == c.vertices);
+      assert(g.capacity().edges == c.edges);
+
+      // Shrinking releases the unused part of the reserved incidence list,
+      // though inline storage remains.
+      std::size_t k = g.capacity().incidence;
+      g.shrink_to_fit();
+      c = g.capacity();
+      assert(c.vertices == 3);
+      assert(c.edges == 20);
+      assert(c.incidence < k);
+      assert(c.incidence >= 2 * 20);
+      assert(g.size() == 20);
+      assert(g(g(0, 2)) % 2 == 1);
+    }
+
+
+  // -------------------------------------------------------------------------- //
+  //                              Random Graphs
+
+  // Returns m random edges over n vertices. Endpoints are skewed toward
+  // low-numbered vertices, so that degrees follow a rough power law, as in
+  // the graphs that traversal algorithms are tuned for.
+  inline vector<pair<size_t, size_t>>
+  random_edges(size_t n, size_t m, unsigned seed = 1)
+  {
+    minstd_rand gen(seed);
+    uniform_real_distribution<double> unit(0, 1);
+    auto pick = [&]() { return size_t(n * unit(gen) * unit(gen)) % n; };
+    vector<pair<size_t, size_t>> r;
+    r.reserve(m);
+    for (size_t i = 0; i < m; ++i)
+      r.emplace_back(pick(), size_t(gen() % n));
+    return r;
+  }
+
 } // namespace testing
 
 #endif
@@ -4,8 +4,10 @@
 #ifndef ORIGIN_GRAPH_HANDLE_HPP
 #define ORIGIN_GRAPH_HANDLE_HPP
 
+#include <cassert>
 #include <cstdint>
 #include <functional>
+#include <type_traits>
 
 namespace origin  {
 // ------------------------------------------------------------------------ //
@@ -17,59 +19,88 @@ namespace origin  {
 // (size_t) values, and have the special property that unsigned -1 indicates
 // an invalid object.
 //
+// The handle stores its value as an unsigned integer of type T. Narrower
+// types reduce the size of data structures that store many handles (e.g.,
+// incidence lists), but limit the number of objects that can be represented
+// to the range of T, less one. The invalid value is all ones in every
+// width, and it converts to and from npos.
+//
 // TODO: Disable arithmetic operations?
-struct handle
-{
-  static constexpr std::size_t npos = -1;
+template<typename T>
+  struct basic_handle
+  {
+    static_assert(std::is_unsigned<T>::value, "handle values must be unsigned");
+
+    using value_type = T;
+
+    static constexpr std::size_t npos = -1;
 
-  handle(std::size_t n = npos);
+    basic_handle(std::size_t n = npos);
 
-  // Boolean
-  explicit operator bool() const;
+    // Boolean
+    explicit operator bool() const;
+
+    // Integral
+    operator std::size_t() const { return value == T(-1) ? npos : value; }
+
+    // Hashable
+    std::size_t hash() const;
 
-  // Integral
-  operator std::size_t() const { return value; }
-  
-  // Hashable
-  std::size_t hash() const;
-  
-  std::size_t value;
-};
+    T value;
+  };
 
-inline
-handle::handle(std::size_t n) : value(n) { }
+// Construct a handle with the value n. Values that do not fit in T, other
+// than npos, are not representable.
+template<typename T>
+  inline
+  basic_handle<T>::basic_handle(std::size_t n)
+    : value(n)
+  {
+    assert(n == npos || n < std::size_t(T(-1)));
+  }
 
-inline 
-handle::operator bool() const { return value != npos; }
+template<typename T>
+  inline
+  basic_handle<T>::operator bool() const { return value != T(-1); }
 
-inline std::size_t 
-handle::hash() const { return std::hash<std::size_t>{}(value); }
+template<typename T>
+  inline std::size_t
+  basic_handle<T>::hash() const { return std::hash<T>{}(value); }
 
 // Equality
-inline bool 
-operator==(handle a, handle b) { return a.value == b.value; }
+template<typename T>
+  inline bool
+  operator==(basic_handle<T> a, basic_handle<T> b) { return a.value == b.value; }
 
-inline bool 
-operator!=(handle a, handle b) { return !(a == b); }
+template<typename T>
+  inline bool
+  operator!=(basic_handle<T> a, basic_handle<T> b) { return !(a == b); }
 
 // Ordering
-inline bool 
-operator<(handle a, handle b)
-{ 
-  if (!a)
-    return bool(b);
-  else 
-    return b ? a.value < b.value : false; 
-}
-  
-inline bool 
-operator>(handle a, handle b) { return b < a; }
+template<typename T>
+  inline bool
+  operator<(basic_handle<T> a, basic_handle<T> b)
+  {
+    if (!a)
+      return bool(b);
+    else
+      return b ? a.value < b.value : false;
+  }
+
+template<typename T>
+  inline bool
+  operator>(basic_handle<T> a, basic_handle<T> b) { return b < a; }
+
+template<typename T>
+  inline bool
+  operator<=(basic_handle<T> a, basic_handle<T> b) { return !(b < a); }
 
-inline bool 
-operator<=(handle a, handle b) { return !(b < a); }
+template<typename T>
+  inline bool
+  operator>=(basic_handle<T> a, basic_handle<T> b) { return !(a < b); }
 
-inline bool 
-operator>=(handle a, handle b) { return !(a < b); }
+// The default handle is as wide as size_t.
+using handle = basic_handle<std::size_t>;
 
 
 // ------------------------------------------------------------------------ //
@@ -78,10 +109,20 @@ operator>=(handle a, handle b) { return !(a < b); }
 //
 // A vertex handle is a handle specifically for graph vertices. It is
 // the same as a normal handle in every way except its type.
-struct vertex_handle : handle
-{
-  using handle::handle;
-};
+//
+// Vertex handles of different widths are interconvertible.
+template<typename T>
+  struct basic_vertex_handle : basic_handle<T>
+  {
+    using basic_handle<T>::basic_handle;
+
+    template<typename U>
+      basic_vertex_handle(basic_vertex_handle<U> v)
+        : basic_handle<T>(std::size_t(v))
+      { }
+  };
+
+using vertex_handle = basic_vertex_handle<std::size_t>;
 
 
 // ------------------------------------------------------------------------ //
@@ -93,10 +134,91 @@ struct vertex_handle : handle
 // data structures. More frequently, edge handles are source/target pairs
 // or source/target/edge triples. See simple_edge_handle and multi_edge_handle
 // for details.
-struct edge_handle : handle
-{
-  using handle::handle;
-};
+//
+// Edge handles of different widths are interconvertible.
+template<typename T>
+  struct basic_edge_handle : basic_handle<T>
+  {
+    using basic_handle<T>::basic_handle;
+
+    template<typename U>
+      basic_edge_handle(basic_edge_handle<U> e)
+        : basic_handle<T>(std::size_t(e))
+      { }
+  };
+
+using edge_handle = basic_edge_handle<std::size_t>;
+
+
+// ------------------------------------------------------------------------ //
+//                                                             [graph.ghandle]
+//                          Generational Handle
+//
+// A generational handle pairs a handle H (an index) with the generation of
+// the slot it refers to. Data structures that count the number of times
+// each slot has been erased can use the generation to detect handles that
+// have outlived their object, even when the slot has since been reused.
+//
+// The index and generation are packed into a single 64-bit word. The low
+// 40 bits store the index, and the high 24 bits store the generation, which
+// wraps around. An index of all ones denotes the invalid handle, so the
+// indexes of valid handles must be less than 2^40 - 1.
+template<typename H>
+  struct generational_handle
+  {
+    using handle_type = H;
+
+    static constexpr int index_bits = 40;
+    static constexpr int generation_bits = 64 - index_bits;
+    static constexpr std::uint64_t index_mask = (std::uint64_t(1) << index_bits) - 1;
+    static constexpr std::uint64_t generation_mask = (std::uint64_t(1) << generation_bits) - 1;
+
+    generational_handle()
+      : value(index_mask)
+    { }
+
+    generational_handle(H h, std::uint32_t g)
+      : value(index_part(h) | (std::uint64_t(g & generation_mask) << index_bits))
+    { }
+
+    // Boolean
+    explicit operator bool() const { return (value & index_mask) != index_mask; }
+
+    // Returns the handle of the object.
+    H handle() const { return bool(*this) ? H(value & index_mask) : H(); }
+
+    // Returns the generation of the handle.
+    std::uint32_t generation() const { return value >> index_bits; }
+
+    // Hashable
+    std::size_t hash() const { return std::hash<std::uint64_t>{}(value); }
+
+    std::uint64_t value;
+
+  private:
+    static std::uint64_t index_part(H h)
+    {
+      if (!h)
+        return index_mask;
+      assert(std::uint64_t(h.value) < index_mask && "index does not fit in 40 bits");
+      return std::uint64_t(h.value);
+    }
+  };
+
+// Equality
+template<typename H>
+  inline bool
+  operator==(generational_handle<H> a, generational_handle<H> b)
+  {
+    return a.value == b.value;
+  }
+
+template<typename H>
+  inline bool
+  operator!=(generational_handle<H> a, generational_handle<H> b)
+  {
+    return !(a == b);
+  }
 
 
 // ------------------------------------------------------------------------ //
@@ -220,11 +342,18 @@ template<typename E>
 
 // Natively support the standard hashing protocol for vertex handles.
 namespace std  {
-template<>
-  struct hash<origin::vertex_handle>
+template<typename T>
+  struct hash<origin::basic_vertex_handle<T>>
   {
-    std::size_t 
-    operator()(origin::vertex_handle x) const { return x.hash(); }
+    std::size_t
+    operator()(origin::basic_vertex_handle<T> x) const { return x.hash(); }
+  };
+
+template<typename H>
+  struct hash<origin::generational_handle<H>>
+  {
+    std::size_t
+    operator()(origin::generational_handle<H> h) const { return h.hash(); }
   };
 
 template<typename E>
@@ -61,6 +61,29 @@ template<typename H>
 void fv(vertex_handle v) { }
 void fe(edge_handle e) { }
 
+// Generational handles pack an index and a generation.
+void check_generational()
+{
+  using H = generational_handle<vertex_handle>;
+  H a;
+  assert(!a);
+  assert(!a.handle());
+
+  H b(vertex_handle(5), 3);
+  assert(b);
+  assert(b.handle() == vertex_handle(5));
+  assert(b.generation() == 3);
+  assert(b != H(vertex_handle(5), 4));
+  assert(b == H(vertex_handle(5), 3));
+
+  // Generations wrap around.
+  H c(vertex_handle(7), 1u << H::generation_bits);
+  assert(c.generation() == 0);
+
+  H d(vertex_handle(), 2);
+  assert(!d);
+}
+
 int main()
 {
   check_eq<handle>();
@@ -87,4 +110,6 @@ int main()
 
   // FIXME: This should not work.
   assert(v == e);
+
+  check_generational();
 }
@@ -5,9 +5,13 @@
 #define ORIGIN_GRAPH_IO_HPP
 
 #include <iosfwd>
+#include <type_traits>
 
+#include <origin.graph/handle.hpp>
 #include <origin.graph/graph.hpp>
 
+#include <origin.graph/io.impl/text_writer.hpp>
+
 namespace origin
 {
   namespace io
@@ -18,9 +22,6 @@ namespace origin
     //
     // Support for various forms of graph I/O.
     //
-    // TODO: Rewrite the operations used by this module in terms of the generic
-    // graph interface.
-    //
     // TODO: Develop type constraints for these operations. Also, what should
     // we print when no value types have been given.
 
@@ -75,7 +76,7 @@ namespace origin
       operator<<(std::basic_ostream<C, T>& os, vertex_list_printer<G> p)
       {
         const G& g = p.g;
-        for (auto v : g.vertices())
+        for (auto v : vertices(g))
           os << g(v) << '\n';
         return os;
       }
@@ -86,7 +87,7 @@ namespace origin
       operator<<(std::basic_ostream<C, T>& os, edge_list_printer<G> p)
       {
         const G& g = p.g;
-        for (auto e : g.edges())
+        for (auto e : edges(g))
           os << edge(g, e) << '\n';
         return os;
       }
@@ -97,11 +98,109 @@ namespace origin
       {
         const G& g = p.g;
         Edge<G> e = p.e;
-        Vertex<G> u = g.source(e);
-        Vertex<G> v = g.target(e);
+        Vertex<G> u = source(g, e);
+        Vertex<G> v = target(g, e);
         return os << g(u) << ' ' << g(v) << ' ' << g(e);
       }
 
+
+
+    // ---------------------------------------------------------------------- //
+    //                                                           [graph.io.write]
+    //                              Graph Writers
+    //
+    // The graph writers format the vertices or edges of a graph through a
+    // text writer (see io.impl/text_writer.hpp), which avoids the cost of
+    // formatted stream output. Each vertex or edge is written on its own
+    // line, as its index (or the indexes of its endpoints) followed by its
+    // value, separated by spaces. Empty values are omitted, so that the
+    // edge list of a graph can be read by read_edge_list.
+    //
+    // Each writer can be given a text writer, so that one buffer is used for
+    // many writes, or a file descriptor or stream, for which a buffer is
+    // allocated.
+
+    // Write the index of a handle. Invalid handles are written as npos.
+    template<typename T>
+      inline text_writer&
+      operator<<(text_writer& w, basic_handle<T> h)
+      {
+        w.put_unsigned(std::size_t(h));
+        return w;
+      }
+
+    namespace io_impl
+    {
+      // Write a space and the value x, unless x is empty.
+      template<typename T>
+        inline void
+        put_value(text_writer& w, const T& x)
+        {
+          if (!std::is_empty<T>::value)
+            w << ' ' << x;
+        }
+    } // namespace io_impl
+
+    // Write each vertex of g and its value.
+    template<typename G>
+      void
+      write_vertex_list(text_writer& w, const G& g)
+      {
+        for (auto v : vertices(g)) {
+          w << v;
+          io_impl::put_value(w, g(v));
+          w << '\n';
+        }
+      }
+
+    template<typename G>
+      inline void
+      write_vertex_list(int fd, const G& g)
+      {
+        text_writer w(fd);
+        write_vertex_list(w, g);
+        w.flush();
+      }
+
+    template<typename G>
+      inline void
+      write_vertex_list(std::ostream& os, const G& g)
+      {
+        text_writer w(os);
+        write_vertex_list(w, g);
+        w.flush();
+      }
+
+    // Write the endpoints and value of each edge of g.
+    template<typename G>
+      void
+      write_edge_list(text_writer& w, const G& g)
+      {
+        for (auto e : edges(g)) {
+          w << source(g, e) << ' ' << target(g, e);
+          io_impl::put_value(w, g(e));
+          w << '\n';
+        }
+      }
+
+    template<typename G>
+      inline void
+      write_edge_list(int fd, const G& g)
+      {
+        text_writer w(fd);
+        write_edge_list(w, g);
+        w.flush();
+      }
+
+    template<typename G>
+      inline void
+      write_edge_list(std::ostream& os, const G& g)
+      {
+        text_writer w(os);
+        write_edge_list(w, g);
+        w.flush();
+      }
+
   } // namespace io
 } // namespace origin
 
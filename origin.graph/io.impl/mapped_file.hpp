@@ -0,0 +1,123 @@
+// Copyright (c) 2009-2015 Andrew Sutton
+// All rights reserved
+
+#ifndef ORIGIN_GRAPH_IO_IMPL_MAPPED_FILE_HPP
+#define ORIGIN_GRAPH_IO_IMPL_MAPPED_FILE_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace origin
+{
+  namespace io
+  {
+    // ---------------------------------------------------------------------- //
+    //                              Mapped File
+    //
+    // A mapped file is a read-only view of the contents of a file, mapped
+    // into memory. The mapping is shared, so processes that map the same
+    // file share the pages of the page cache. The file is unmapped when the
+    // object is destroyed.
+    //
+    // Opening a file throws a std::system_error if the file cannot be opened
+    // or mapped. An empty file has no mapping, and its data is null.
+    class mapped_file
+    {
+    public:
+      mapped_file() = default;
+      explicit mapped_file(const std::string& path);
+
+      mapped_file(mapped_file&& x) noexcept;
+      mapped_file& operator=(mapped_file&& x) noexcept;
+
+      mapped_file(const mapped_file&) = delete;
+      mapped_file& operator=(const mapped_file&) = delete;
+
+      ~mapped_file();
+
+      // Observers
+      bool        empty() const { return size_ == 0; }
+      std::size_t size() const  { return size_; }
+      const char* data() const  { return data_; }
+
+      const char* begin() const { return data_; }
+      const char* end() const   { return data_ + size_; }
+
+      void swap(mapped_file& x) noexcept;
+
+    private:
+      const char* data_ = nullptr;
+      std::size_t size_ = 0;
+    };
+
+    inline
+    mapped_file::mapped_file(const std::string& path)
+    {
+      int fd = ::open(path.c_str(), O_RDONLY);
+      if (fd < 0)
+        throw std::system_error(errno, std::generic_category(), path);
+
+      struct stat st;
+      if (::fstat(fd, &st) != 0) {
+        int err = errno;
+        ::close(fd);
+        throw std::system_error(err, std::generic_category(), path);
+      }
+
+      size_ = st.st_size;
+      if (size_ != 0) {
+        void* p = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) {
+          int err = errno;
+          ::close(fd);
+          throw std::system_error(err, std::generic_category(), path);
+        }
+        data_ = static_cast<const char*>(p);
+      }
+
+      // The mapping remains valid after the descriptor is closed.
+      ::close(fd);
+    }
+
+    inline
+    mapped_file::mapped_file(mapped_file&& x) noexcept
+      : data_(x.data_), size_(x.size_)
+    {
+      x.data_ = nullptr;
+      x.size_ = 0;
+    }
+
+    inline mapped_file&
+    mapped_file::operator=(mapped_file&& x) noexcept
+    {
+      mapped_file tmp(std::move(x));
+      swap(tmp);
+      return *this;
+    }
+
+    inline
+    mapped_file::~mapped_file()
+    {
+      if (data_)
+        ::munmap(const_cast<char*>(data_), size_);
+    }
+
+    inline void
+    mapped_file::swap(mapped_file& x) noexcept
+    {
+      std::swap(data_, x.data_);
+      std::swap(size_, x.size_);
+    }
+
+  } // namespace io
+} // namespace origin
+
+#endif
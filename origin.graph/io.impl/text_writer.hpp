@@ -0,0 +1,269 @@
+// Copyright (c) 2009-2015 Andrew Sutton
+// All rights reserved
+
+#ifndef ORIGIN_GRAPH_IO_IMPL_TEXT_WRITER_HPP
+#define ORIGIN_GRAPH_IO_IMPL_TEXT_WRITER_HPP
+
+#include <cassert>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include <algorithm>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#include <unistd.h>
+
+namespace origin
+{
+  namespace io
+  {
+    // ---------------------------------------------------------------------- //
+    //                              Text Writer
+    //
+    // A text writer formats values into a buffer and writes the buffer to
+    // a file descriptor or an output stream when it fills. The buffer is
+    // allocated once, when the writer is constructed, so writing does not
+    // allocate, and the sink is written in large blocks.
+    //
+    // Values are written with operator<<. Integers are formatted without
+    // locales, and characters and strings are copied. Floating point values
+    // are formatted with snprintf, with enough digits to be read back
+    // exactly. Empty values write nothing. Other types can be written by
+    // overloading operator<< for text_writer.
+    //
+    // The writer is flushed when it is destroyed. Errors writing to a file
+    // descriptor throw std::system_error; errors writing to a stream are
+    // reported by the state of the stream.
+    class text_writer
+    {
+    public:
+      static constexpr std::size_t default_capacity = 1 << 20;
+
+      explicit text_writer(int fd, std::size_t n = default_capacity);
+      explicit text_writer(std::ostream& os, std::size_t n = default_capacity);
+
+      text_writer(const text_writer&) = delete;
+      text_writer& operator=(const text_writer&) = delete;
+
+      ~text_writer();
+
+      // Writing
+      void put(char c);
+      void put(const char* s, std::size_t n);
+
+      template<typename T>
+        void put_unsigned(T x);
+
+      template<typename T>
+        void put_signed(T x);
+
+      void flush();
+
+    private:
+      // Ensure that k bytes can be written to the buffer.
+      void reserve(std::size_t k)
+      {
+        if (buf.size() - len < k)
+          flush();
+      }
+
+      std::vector<char> buf;
+      std::size_t len;
+      int fd;
+      std::ostream* os;
+    };
+
+    inline
+    text_writer::text_writer(int fd, std::size_t n)
+      : buf(n), len(0), fd(fd), os(nullptr)
+    {
+      assert(n >= 64);
+    }
+
+    inline
+    text_writer::text_writer(std::ostream& os, std::size_t n)
+      : buf(n), len(0), fd(-1), os(&os)
+    {
+      assert(n >= 64);
+    }
+
+    inline
+    text_writer::~text_writer()
+    {
+      // Do not throw from the destructor; callers that need to know about
+      // errors should flush explicitly.
+      try {
+        flush();
+      } catch (...) { }
+    }
+
+    inline void
+    text_writer::put(char c)
+    {
+      reserve(1);
+      buf[len++] = c;
+    }
+
+    inline void
+    text_writer::put(const char* s, std::size_t n)
+    {
+      while (n) {
+        reserve(1);
+        std::size_t k = std::min(n, buf.size() - len);
+        std::memcpy(buf.data() + len, s, k);
+        len += k;
+        s += k;
+        n -= k;
+      }
+    }
+
+    // Write the digits of x. Pairs of digits are taken from a table, and
+    // the digits are written backwards into a local buffer.
+    template<typename T>
+      void
+      text_writer::put_unsigned(T x)
+      {
+        static_assert(std::is_unsigned<T>::value, "");
+        static const char digits[] =
+          "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+          "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+          "8081828384858687888990919293949596979899";
+        constexpr std::size_t n = std::numeric_limits<T>::digits10 + 1;
+        reserve(n);
+        char tmp[n];
+        char* p = tmp + n;
+        while (x >= 100) {
+          std::size_t i = (x % 100) * 2;
+          x /= 100;
+          *--p = digits[i + 1];
+          *--p = digits[i];
+        }
+        if (x >= 10) {
+          std::size_t i = x * 2;
+          *--p = digits[i + 1];
+          *--p = digits[i];
+        } else {
+          *--p = char('0' + x);
+        }
+        std::size_t k = tmp + n - p;
+        std::memcpy(buf.data() + len, p, k);
+        len += k;
+      }
+
+    template<typename T>
+      inline void
+      text_writer::put_signed(T x)
+      {
+        using U = typename std::make_unsigned<T>::type;
+        if (x < 0) {
+          put('-');
+          put_unsigned(U(U(0) - U(x)));
+        } else {
+          put_unsigned(U(x));
+        }
+      }
+
+    inline void
+    text_writer::flush()
+    {
+      if (os) {
+        os->write(buf.data(), len);
+        len = 0;
+        return;
+      }
+      const char* p = buf.data();
+      std::size_t n = len;
+      len = 0;
+      while (n) {
+        ssize_t k = ::write(fd, p, n);
+        if (k < 0) {
+          if (errno == EINTR)
+            continue;
+          throw std::system_error(errno, std::generic_category(), "text_writer");
+        }
+        p += k;
+        n -= k;
+      }
+    }
+
+
+    // Formatting
+    inline text_writer&
+    operator<<(text_writer& w, char c)
+    {
+      w.put(c);
+      return w;
+    }
+
+    inline text_writer&
+    operator<<(text_writer& w, const char* s)
+    {
+      w.put(s, std::strlen(s));
+      return w;
+    }
+
+    inline text_writer&
+    operator<<(text_writer& w, const std::string& s)
+    {
+      w.put(s.data(), s.size());
+      return w;
+    }
+
+    inline text_writer&
+    operator<<(text_writer& w, bool b)
+    {
+      w.put(b ? '1' : '0');
+      return w;
+    }
+
+    // Integers
+    template<typename T>
+      inline typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value
+                                     && !std::is_same<T, char>::value, text_writer&>::type
+      operator<<(text_writer& w, T x)
+      {
+        w.put_signed(x);
+        return w;
+      }
+
+    template<typename T>
+      inline typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value
+                                     && !std::is_same<T, char>::value
+                                     && !std::is_same<T, bool>::value, text_writer&>::type
+      operator<<(text_writer& w, T x)
+      {
+        w.put_unsigned(x);
+        return w;
+      }
+
+    // Floating point values
+    template<typename T>
+      inline typename std::enable_if<std::is_floating_point<T>::value, text_writer&>::type
+      operator<<(text_writer& w, T x)
+      {
+        char tmp[64];
+        int n = std::snprintf(tmp, sizeof(tmp), "%.*Lg",
+                              std::numeric_limits<T>::max_digits10, (long double)x);
+        w.put(tmp, n);
+        return w;
+      }
+
+    // Empty values
+    template<typename T>
+      inline typename std::enable_if<std::is_empty<T>::value, text_writer&>::type
+      operator<<(text_writer& w, const T&)
+      {
+        return w;
+      }
+
+  } // namespace io
+} // namespace origin
+
+#endif
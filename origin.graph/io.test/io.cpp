@@ -0,0 +1,122 @@
+// Copyright (c) 2009-2015 Andrew Sutton
+// All rights reserved
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <origin.graph/adjacency_vector.hpp>
+#include <origin.graph/edge_reader.hpp>
+#include <origin.graph/io.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+// Returns the text written by f to a text writer with a small buffer, so
+// that the buffer is flushed many times.
+template<typename F>
+  string
+  written(F f)
+  {
+    ostringstream ss;
+    {
+      io::text_writer w(ss, 64);
+      f(w);
+    }
+    return ss.str();
+  }
+
+void
+check_text_writer()
+{
+  cout << "*** text writer ***\n";
+  assert(written([](io::text_writer& w) { w << 0; }) == "0");
+  assert(written([](io::text_writer& w) { w << 7 << ' ' << 42 << ' ' << 100; }) == "7 42 100");
+  assert(written([](io::text_writer& w) { w << -1 << ' ' << 'x'; }) == "-1 x");
+  assert(written([](io::text_writer& w) {
+    w << numeric_limits<uint64_t>::max();
+  }) == "18446744073709551615");
+  assert(written([](io::text_writer& w) {
+    w << numeric_limits<int64_t>::min();
+  }) == "-9223372036854775808");
+  assert(written([](io::text_writer& w) { w << 0.5 << ' ' << "ab" << string("cd"); }) == "0.5 abcd");
+  assert(written([](io::text_writer& w) { w << empty_t{} << true; }) == "1");
+  assert(written([](io::text_writer& w) { w << vertex_handle(3) << edge_handle(); })
+         == "318446744073709551615");
+
+  // Every integer in a range is written as by streams.
+  string s = written([](io::text_writer& w) {
+    for (int i = -2000; i <= 200000; i += 7)
+      w << i << '\n';
+  });
+  ostringstream ss;
+  for (int i = -2000; i <= 200000; i += 7)
+    ss << i << '\n';
+  assert(s == ss.str());
+}
+
+void
+check_graph_writers()
+{
+  cout << "*** graph writers ***\n";
+  vector<tuple<int, int, int>> input {
+    {0, 1, 10}, {1, 2, -11}, {2, 0, 12}, {2, 2, 13}
+  };
+  using G = directed_adjacency_vector<char, int>;
+  G g(input.begin(), input.end());
+  for (auto v : vertices(g))
+    g(v) = 'a' + v;
+
+  ostringstream vs;
+  io::write_vertex_list(vs, g);
+  assert(vs.str() == "0 a\n1 b\n2 c\n");
+
+  ostringstream es;
+  io::write_edge_list(es, g);
+  assert(es.str() == "0 1 10\n1 2 -11\n2 0 12\n2 2 13\n");
+
+  // The printer agrees with the writer on the edges of the graph.
+  ostringstream ps;
+  ps << io::edge_list(g);
+  assert(ps.str() == "a b 10\nb c -11\nc a 12\nc c 13\n");
+
+  // Empty values are omitted, so the output can be read back.
+  using H = directed_adjacency_vector<>;
+  vector<pair<int, int>> pairs {{0, 1}, {1, 2}, {2, 0}, {2, 2}};
+  H h(pairs.begin(), pairs.end());
+  ostringstream hs;
+  io::write_edge_list(hs, h);
+  string text = hs.str();
+  assert(text == "0 1\n1 2\n2 0\n2 2\n");
+  auto x = io::parse_edge_list(text.data(), text.data() + text.size());
+  assert(x.edges.size() == 4);
+  assert(x.edges[1] == make_pair(size_t(1), size_t(2)));
+
+  // Writing to a file descriptor, reusing one writer.
+  char path[] = "/tmp/origin_io_XXXXXX";
+  int fd = ::mkstemp(path);
+  assert(fd >= 0);
+  {
+    io::text_writer w(fd);
+    io::write_edge_list(w, g);
+    io::write_edge_list(w, h);
+  }
+  ::close(fd);
+  io::mapped_file f(path);
+  assert(string(f.begin(), f.end()) == es.str() + text);
+  ::unlink(path);
+}
+
+int main()
+{
+  check_text_writer();
+  check_graph_writers();
+}
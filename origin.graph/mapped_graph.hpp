@@ -0,0 +1,564 @@
+// Copyright (c) 2009-2015 Andrew Sutton
+// All rights reserved
+
+#ifndef ORIGIN_GRAPH_MAPPED_GRAPH_HPP
+#define ORIGIN_GRAPH_MAPPED_GRAPH_HPP
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <origin/type/concepts.hpp>
+#include <origin/type/empty.hpp>
+#include <origin/sequence/range.hpp>
+
+#include <origin.graph/handle.hpp>
+#include <origin.graph/graph.hpp>
+#include <origin.graph/compressed_graph.hpp>
+
+#include <origin.graph/adjacency_list.impl/handle_range.hpp>
+#include <origin.graph/io.impl/mapped_file.hpp>
+
+namespace origin
+{
+  namespace io
+  {
+    // ---------------------------------------------------------------------- //
+    //                                                         [graph.io.binary]
+    //                          Binary Graph Format
+    //
+    // The binary graph format stores a directed graph in compressed sparse
+    // row (CSR) form, so that it can be mapped into memory and traversed
+    // without parsing. A file is a header followed by up to six sections:
+    //
+    //    - out offsets: n + 1 64-bit offsets into the targets section
+    //    - targets: m vertex indexes, in order of source vertex
+    //    - in offsets: n + 1 64-bit offsets into the in edges section
+    //    - in edges: m edge indexes, in order of target vertex
+    //    - vertex values: n vertex values
+    //    - edge values: m edge values, in order of source vertex
+    //
+    // Vertex and edge indexes are stored with the width of the handles of
+    // the graph (index_size). The in offsets and in edges are present only
+    // if the in_edges flag is set, and values are present only if their
+    // type is not empty. Each section begins on a 64-byte boundary, so the
+    // elements of a mapped section are suitably aligned.
+    //
+    // Values are stored as their object representation, so they must be
+    // trivially copyable, and a file can only be read on a machine with the
+    // same byte order. The byte_order field records the byte order of the
+    // writer, and the version field is incremented whenever the layout of
+    // the file changes.
+
+    constexpr char          binary_magic[8] = {'O', 'R', 'I', 'G', 'R', 'A', 'P', 'H'};
+    constexpr std::uint32_t binary_version = 1;
+    constexpr std::uint32_t binary_byte_order = 0x01020304;
+    constexpr std::size_t   binary_alignment = 64;
+
+    // Kinds of graph
+    constexpr std::uint32_t binary_directed = 0;
+
+    // Flags
+    constexpr std::uint32_t binary_in_edges = 1;
+
+    // The sections of a binary graph.
+    enum binary_section
+    {
+      binary_out_offsets,
+      binary_targets,
+      binary_in_offsets,
+      binary_in_edges_section,
+      binary_vertex_values,
+      binary_edge_values,
+      binary_section_count
+    };
+
+    // The header of a binary graph file. The offset of an absent section
+    // is 0.
+    struct binary_header
+    {
+      char          magic[8];
+      std::uint32_t version;
+      std::uint32_t byte_order;
+      std::uint32_t kind;
+      std::uint32_t flags;
+      std::uint32_t index_size;
+      std::uint32_t vertex_value_size;
+      std::uint32_t edge_value_size;
+      std::uint32_t reserved;
+      std::uint64_t order;
+      std::uint64_t size;
+      std::uint64_t sections[binary_section_count];
+    };
+
+    static_assert(std::is_trivially_copyable<binary_header>::value, "");
+
+
+    namespace binary_impl
+    {
+      // Returns the number of bytes used to store a value of type T. Empty
+      // values are not stored.
+      template<typename T>
+        constexpr std::uint32_t
+        value_size()
+        {
+          return std::is_empty<T>::value ? 0 : sizeof(T);
+        }
+
+      // Round n up to the next section boundary.
+      inline std::uint64_t
+      align(std::uint64_t n)
+      {
+        return (n + binary_alignment - 1) / binary_alignment * binary_alignment;
+      }
+
+      // A section writer copies values into a buffer and writes the buffer
+      // to a stream in large blocks. It keeps track of the number of bytes
+      // written, so that sections can be padded to their offsets.
+      class section_writer
+      {
+      public:
+        static constexpr std::size_t block = 1 << 16;
+
+        explicit section_writer(std::ostream& os)
+          : os(os), pos(0)
+        {
+          buf.reserve(block);
+        }
+
+        ~section_writer() { flush(); }
+
+        template<typename T>
+          void put(const T& x);
+
+        void put_bytes(const void* p, std::size_t n);
+        void pad_to(std::uint64_t n);
+        void flush();
+
+      private:
+        std::ostream& os;
+        std::vector<char> buf;
+        std::uint64_t pos;
+      };
+
+      template<typename T>
+        inline void
+        section_writer::put(const T& x)
+        {
+          static_assert(std::is_trivially_copyable<T>::value,
+                        "binary values must be trivially copyable");
+          if (!std::is_empty<T>::value)
+            put_bytes(&x, sizeof(T));
+        }
+
+      inline void
+      section_writer::put_bytes(const void* p, std::size_t n)
+      {
+        if (buf.size() + n > block)
+          flush();
+        const char* s = static_cast<const char*>(p);
+        buf.insert(buf.end(), s, s + n);
+        pos += n;
+      }
+
+      inline void
+      section_writer::pad_to(std::uint64_t n)
+      {
+        assert(pos <= n);
+        while (pos < n) {
+          buf.push_back(0);
+          ++pos;
+        }
+      }
+
+      inline void
+      section_writer::flush()
+      {
+        os.write(buf.data(), buf.size());
+        buf.clear();
+      }
+
+      // Write the in offsets and in edges of g. In edges refer to the
+      // position of each edge in source order.
+      template<typename G>
+        void
+        put_in_edges(section_writer& w, const G& g, const binary_header& h, std::true_type)
+        {
+          using Size = typename Vertex<G>::value_type;
+          std::vector<Size> pos(g.size());
+          Size p = 0;
+          for (auto v : g.vertices())
+            for (auto e : g.out_edges(v))
+              pos[e] = p++;
+
+          w.pad_to(h.sections[binary_in_offsets]);
+          std::uint64_t k = 0;
+          w.put(k);
+          for (auto v : g.vertices()) {
+            k += g.in_degree(v);
+            w.put(k);
+          }
+          w.pad_to(h.sections[binary_in_edges_section]);
+          for (auto v : g.vertices())
+            for (auto e : g.in_edges(v))
+              w.put(pos[e]);
+        }
+
+      template<typename G>
+        inline void
+        put_in_edges(section_writer&, const G&, const binary_header&, std::false_type)
+        { }
+
+      inline void
+      check(bool ok, const char* msg)
+      {
+        if (!ok)
+          throw std::runtime_error(std::string("invalid binary graph: ") + msg);
+      }
+
+    } // namespace binary_impl
+
+
+    // Write the directed graph g to os in the binary graph format. The
+    // vertices and edges of g must be numbered [0, n) and [0, m), as in
+    // adjacency vectors and compressed graphs. Take a snapshot of other
+    // graphs to number them.
+    //
+    // Edges are written in order of their source vertex, and the edges of
+    // the loaded graph are numbered in that order. For compressed graphs,
+    // this is the original numbering.
+    template<typename G>
+      void
+      write_binary(std::ostream& os, const G& g)
+      {
+        using Size = typename Vertex<G>::value_type;
+        using V = typename std::decay<decltype(g(Vertex<G>()))>::type;
+        using E = typename std::decay<decltype(g(Edge<G>()))>::type;
+        const bool in = stores_in_edges(g);
+
+        const std::uint64_t n = g.order();
+        const std::uint64_t m = g.size();
+
+        binary_header h;
+        std::memset(&h, 0, sizeof(h));
+        std::memcpy(h.magic, binary_magic, sizeof(h.magic));
+        h.version = binary_version;
+        h.byte_order = binary_byte_order;
+        h.kind = binary_directed;
+        h.flags = in ? binary_in_edges : 0;
+        h.index_size = sizeof(Size);
+        h.vertex_value_size = binary_impl::value_size<V>();
+        h.edge_value_size = binary_impl::value_size<E>();
+        h.order = n;
+        h.size = m;
+
+        // Lay out the sections.
+        const bool present[binary_section_count] = {
+          true, true, in, in, h.vertex_value_size != 0, h.edge_value_size != 0
+        };
+        const std::uint64_t bytes[binary_section_count] = {
+          (n + 1) * 8,
+          m * sizeof(Size),
+          (n + 1) * 8,
+          m * sizeof(Size),
+          n * h.vertex_value_size,
+          m * h.edge_value_size
+        };
+        std::uint64_t end = sizeof(h);
+        for (int s = 0; s < binary_section_count; ++s) {
+          if (present[s]) {
+            h.sections[s] = binary_impl::align(end);
+            end = h.sections[s] + bytes[s];
+          }
+        }
+
+        binary_impl::section_writer w(os);
+        w.put(h);
+
+        // Out offsets and targets.
+        w.pad_to(h.sections[binary_out_offsets]);
+        std::uint64_t k = 0;
+        w.put(k);
+        for (auto v : g.vertices()) {
+          k += g.out_degree(v);
+          w.put(k);
+        }
+        w.pad_to(h.sections[binary_targets]);
+        for (auto v : g.vertices())
+          for (auto e : g.out_edges(v))
+            w.put(Size(g.target(e)));
+
+        // In offsets and in edges.
+        if (in)
+          binary_impl::put_in_edges(w, g, h, in_edge_storage<G>{});
+
+        // Values.
+        if (h.vertex_value_size) {
+          w.pad_to(h.sections[binary_vertex_values]);
+          for (auto v : g.vertices())
+            w.put(g(v));
+        }
+        if (h.edge_value_size) {
+          w.pad_to(h.sections[binary_edge_values]);
+          for (auto v : g.vertices())
+            for (auto e : g.out_edges(v))
+              w.put(g(e));
+        }
+      }
+
+    // Write the graph g to the file at path. Throws std::runtime_error if
+    // the file cannot be written.
+    template<typename G>
+      void
+      save_binary(const std::string& path, const G& g)
+      {
+        std::ofstream os(path, std::ios::binary | std::ios::trunc);
+        if (!os)
+          throw std::runtime_error("cannot open " + path);
+        write_binary(os, g);
+        os.flush();
+        if (!os)
+          throw std::runtime_error("cannot write " + path);
+      }
+
+  } // namespace io
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                            [graph.mapped]
+  //                          Mapped Directed Graph
+  //
+  // A mapped directed graph is a compressed directed graph whose arrays are
+  // the sections of a memory-mapped binary graph file (see [graph.io.binary]).
+  // Opening the graph only validates the header, so startup time does not
+  // depend on the size of the graph, and pages are read on first use. Every
+  // process that maps the same file shares its pages.
+  //
+  // The mapping is read-only, so the structure and values of the graph
+  // cannot be modified. Vertex and edge values are returned by reference
+  // into the mapping. The types V and E, and the handle width Size, must
+  // match those of the graph that was written.
+  //
+  // Performance properties are those of compressed_directed_graph. In edges
+  // are available only if they were written; see bidirectional().
+
+  template<typename V = empty_t, typename E = empty_t, typename Size = std::size_t>
+    class mapped_directed_graph
+    {
+      static_assert(std::is_trivially_copyable<V>::value, "");
+      static_assert(std::is_trivially_copyable<E>::value, "");
+    public:
+      using size_type = Size;
+
+      using vertex = basic_vertex_handle<Size>;
+      using vertex_range = adjacency_list_impl::handle_range<vertex>;
+
+      using edge = basic_edge_handle<Size>;
+      using edge_range = adjacency_list_impl::handle_range<edge>;
+
+      using out_edge_range = adjacency_list_impl::handle_range<edge>;
+      using in_edge_range = bounded_range<const edge*>;
+
+      static_assert(sizeof(vertex) == sizeof(Size), "");
+      static_assert(sizeof(edge) == sizeof(Size), "");
+
+      // Construction
+      mapped_directed_graph() = default;
+
+      explicit mapped_directed_graph(const std::string& path);
+      explicit mapped_directed_graph(io::mapped_file f);
+
+      // Observers
+      bool        null() const  { return n_ == 0; }
+      std::size_t order() const { return n_; }
+
+      bool        empty() const { return m_ == 0; }
+      std::size_t size() const  { return m_; }
+
+      // True if the file stores the in edges of each vertex.
+      bool bidirectional() const { return in_ != nullptr; }
+
+      // Vertex observers
+      std::size_t out_degree(vertex v) const { return out_[v + 1] - out_[v]; }
+      std::size_t in_degree(vertex v) const;
+      std::size_t degree(vertex v) const { return out_degree(v) + in_degree(v); }
+
+      // Edge observers
+      vertex source(edge e) const;
+      vertex target(edge e) const { return targets_[e]; }
+
+      // Data access
+      const V& operator()(vertex v) const;
+      const E& operator()(edge e) const;
+
+      // Edge relation
+      edge operator()(vertex u, vertex v) const;
+
+      // Iterators
+      vertex_range   vertices() const { return {0, order()}; }
+      edge_range     edges() const    { return {0, size()}; }
+      out_edge_range out_edges(vertex v) const { return {out_[v], out_[v + 1]}; }
+      in_edge_range  in_edges(vertex v) const;
+
+      // Raw storage
+      // The out edges of v are the edges in [out_offsets()[v],
+      // out_offsets()[v + 1]). The target of the edge e is targets()[e].
+      const std::uint64_t* out_offsets() const { return out_; }
+      const vertex*        targets() const     { return targets_; }
+
+    private:
+      template<typename T>
+        const T* section(const io::binary_header& h, int s, std::uint64_t k) const;
+
+    private:
+      io::mapped_file      file_;
+      std::size_t          n_ = 0;
+      std::size_t          m_ = 0;
+      const std::uint64_t* out_ = nullptr;     // Out edge offsets (n + 1)
+      const vertex*        targets_ = nullptr; // Edge targets (m)
+      const std::uint64_t* in_ = nullptr;      // In edge offsets (n + 1)
+      const edge*          ins_ = nullptr;     // Edges in target order (m)
+      const V*             vvals_ = nullptr;   // Vertex values (n)
+      const E*             evals_ = nullptr;   // Edge values (m)
+    };
+
+  // Map the binary graph file at path.
+  template<typename V, typename E, typename S>
+    inline
+    mapped_directed_graph<V, E, S>::mapped_directed_graph(const std::string& path)
+      : mapped_directed_graph(io::mapped_file(path))
+    { }
+
+  // Adopt the mapped binary graph file f. Throws std::runtime_error if the
+  // file is not a binary graph whose types match those of this graph.
+  template<typename V, typename E, typename S>
+    mapped_directed_graph<V, E, S>::mapped_directed_graph(io::mapped_file f)
+      : file_(std::move(f))
+    {
+      using io::binary_impl::check;
+      using io::binary_impl::value_size;
+
+      check(file_.size() >= sizeof(io::binary_header), "truncated header");
+      io::binary_header h;
+      std::memcpy(&h, file_.data(), sizeof(h));
+      check(std::memcmp(h.magic, io::binary_magic, sizeof(h.magic)) == 0, "bad magic");
+      check(h.version == io::binary_version, "unsupported version");
+      check(h.byte_order == io::binary_byte_order, "wrong byte order");
+      check(h.kind == io::binary_directed, "not a directed graph");
+      check(h.index_size == sizeof(S), "wrong handle width");
+      check(h.vertex_value_size == value_size<V>(), "wrong vertex value type");
+      check(h.edge_value_size == value_size<E>(), "wrong edge value type");
+      check(h.order < std::uint64_t(S(-1)) && h.size < std::uint64_t(S(-1)),
+            "graph too large for handle width");
+
+      n_ = h.order;
+      m_ = h.size;
+      out_ = section<std::uint64_t>(h, io::binary_out_offsets, n_ + 1);
+      targets_ = section<vertex>(h, io::binary_targets, m_);
+      check(out_[0] == 0 && out_[n_] == m_, "inconsistent offsets");
+      if (h.flags & io::binary_in_edges) {
+        in_ = section<std::uint64_t>(h, io::binary_in_offsets, n_ + 1);
+        ins_ = section<edge>(h, io::binary_in_edges_section, m_);
+        check(in_[0] == 0 && in_[n_] == m_, "inconsistent offsets");
+      }
+      if (value_size<V>())
+        vvals_ = section<V>(h, io::binary_vertex_values, n_);
+      if (value_size<E>())
+        evals_ = section<E>(h, io::binary_edge_values, m_);
+    }
+
+  // Returns a pointer to the k objects of the section s, after checking that
+  // the section lies within the file.
+  template<typename V, typename E, typename S>
+    template<typename T>
+      inline const T*
+      mapped_directed_graph<V, E, S>::section(const io::binary_header& h,
+                                              int s, std::uint64_t k) const
+      {
+        using io::binary_impl::check;
+        std::uint64_t off = h.sections[s];
+        check(off >= sizeof(h) && off % io::binary_alignment == 0, "bad section offset");
+        check(off <= file_.size() && k <= (file_.size() - off) / sizeof(T), "truncated section");
+        return reinterpret_cast<const T*>(file_.data() + off);
+      }
+
+  template<typename V, typename E, typename S>
+    inline std::size_t
+    mapped_directed_graph<V, E, S>::in_degree(vertex v) const
+    {
+      assert(bidirectional());
+      return in_[v + 1] - in_[v];
+    }
+
+  // Returns true if the file stores in edges.
+  template<typename V, typename E, typename S>
+    inline bool
+    stores_in_edges(const mapped_directed_graph<V, E, S>& g) { return g.bidirectional(); }
+
+  // Returns the source of e. See compressed_directed_graph::source.
+  template<typename V, typename E, typename S>
+    inline auto
+    mapped_directed_graph<V, E, S>::source(edge e) const -> vertex
+    {
+      const std::uint64_t* i = std::upper_bound(out_, out_ + n_ + 1, std::uint64_t(e));
+      return vertex(i - out_ - 1);
+    }
+
+  // Returns the value of v. If V is empty, no values are stored, and every
+  // vertex refers to the same value.
+  template<typename V, typename E, typename S>
+    inline const V&
+    mapped_directed_graph<V, E, S>::operator()(vertex v) const
+    {
+      static const V none{};
+      return vvals_ ? vvals_[v] : none;
+    }
+
+  template<typename V, typename E, typename S>
+    inline const E&
+    mapped_directed_graph<V, E, S>::operator()(edge e) const
+    {
+      static const E none{};
+      return evals_ ? evals_[e] : none;
+    }
+
+  // Returns the first edge connecting u to v, or an invalid handle if there
+  // is no such edge. As with compressed graphs, the shorter of the out
+  // edges of u and the in edges of v is searched.
+  template<typename V, typename E, typename S>
+    auto
+    mapped_directed_graph<V, E, S>::operator()(vertex u, vertex v) const -> edge
+    {
+      if (bidirectional() && in_degree(v) < out_degree(u)) {
+        for (edge e : in_edges(v))
+          if (source(e) == u)
+            return e;
+        return edge();
+      }
+      for (std::uint64_t e = out_[u]; e != out_[u + 1]; ++e)
+        if (targets_[e] == v)
+          return edge(e);
+      return edge();
+    }
+
+  // Return a range over the in edges of the vertex v.
+  template<typename V, typename E, typename S>
+    inline auto
+    mapped_directed_graph<V, E, S>::in_edges(vertex v) const -> in_edge_range
+    {
+      assert(bidirectional());
+      return {ins_ + in_[v], ins_ + in_[v + 1]};
+    }
+
+} // namespace origin
+
+#endif
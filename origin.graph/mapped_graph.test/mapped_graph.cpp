@@ -0,0 +1,168 @@
+// Copyright (c) 2009-2015 Andrew Sutton
+// All rights reserved
+
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+#include <origin.graph/adjacency_vector.hpp>
+#include <origin.graph/mapped_graph.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+// The file written and mapped by each check.
+const char* path = "mapped_graph.test.bin";
+
+// The input edges used by all checks.
+vector<tuple<int, int, int>> input {
+  {0, 1, 10}, {1, 2, 11}, {2, 0, 12}, {2, 2, 13}, {4, 0, 14}, {0, 3, 15}
+};
+
+// Check that the mapped graph M has the structure and values of g. Edges
+// are matched by their endpoints, since writing a graph renumbers its
+// edges in source order.
+template<typename M, typename G>
+  void
+  check_same(const M& m, const G& g, bool in)
+  {
+    assert(m.order() == g.order());
+    assert(m.size() == g.size());
+    assert(m.bidirectional() == in);
+    for (auto v : vertices(g)) {
+      Vertex<M> u(v);
+      assert(m(u) == g(v));
+      assert(m.out_degree(u) == g.out_degree(v));
+      if (in)
+        assert(m.in_degree(u) == g.in_degree(v));
+    }
+
+    const auto* off = m.out_offsets();
+    assert(off[0] == 0 && off[m.order()] == m.size());
+    for (auto v : vertices(m)) {
+      for (auto e : m.out_edges(v)) {
+        assert(m.source(e) == v);
+        assert(m.targets()[e] == m.target(e));
+        auto f = g(Vertex<G>(v), Vertex<G>(m.target(e)));
+        assert(f);
+        assert(m(e) == g(f));
+      }
+      if (in) {
+        for (auto e : m.in_edges(v))
+          assert(m.target(e) == v);
+      }
+    }
+    for (const auto& x : input) {
+      auto e = m(Vertex<M>(get<0>(x)), Vertex<M>(get<1>(x)));
+      assert(e);
+      assert(m(e) == get<2>(x));
+    }
+    assert(!m(Vertex<M>(3), Vertex<M>(4)));
+  }
+
+// Check that a compressed graph is mapped with its original numbering.
+void
+check_compressed()
+{
+  cout << "*** mapped compressed graph ***\n";
+  using G = compressed_directed_graph<char, int>;
+  G g(input.begin(), input.end(), 6);
+  for (auto v : vertices(g))
+    g(v) = 'a' + v;
+  io::save_binary(path, g);
+
+  using M = mapped_directed_graph<char, int>;
+  M m(path);
+  check_same(m, g, true);
+  for (auto e : edges(g)) {
+    assert(m.source(e) == g.source(e));
+    assert(m.target(e) == g.target(e));
+  }
+
+  // The mapping remains valid after the graph is moved.
+  M m2 = std::move(m);
+  check_same(m2, g, true);
+
+  // Without in edges.
+  using H = compressed_directed_graph<empty_t, empty_t, false>;
+  vector<pair<int, int>> pairs;
+  for (const auto& x : input)
+    pairs.emplace_back(get<0>(x), get<1>(x));
+  H h(pairs.begin(), pairs.end());
+  io::save_binary(path, h);
+  mapped_directed_graph<> mh(path);
+  assert(!mh.bidirectional());
+  assert(mh.order() == 5);
+  assert(mh.size() == 6);
+  assert(mh(vertex_handle(4), vertex_handle(0)));
+}
+
+// Check that an adjacency vector with 32-bit handles is mapped.
+void
+check_adjacency_vector()
+{
+  cout << "*** mapped adjacency vector ***\n";
+  using G = directed_adjacency_vector<char, int, std::uint32_t>;
+  G g(input.begin(), input.end(), 6);
+  for (auto v : vertices(g))
+    g(v) = 'a' + v;
+  io::save_binary(path, g);
+
+  using M = mapped_directed_graph<char, int, std::uint32_t>;
+  M m(path);
+  check_same(m, g, true);
+}
+
+// Check that files of the wrong type, or that are not graphs, are rejected.
+void
+check_invalid()
+{
+  cout << "*** invalid binary graphs ***\n";
+  compressed_directed_graph<char, int> g(input.begin(), input.end());
+  io::save_binary(path, g);
+
+  auto rejects = [](auto f) {
+    try {
+      f();
+    } catch (std::runtime_error&) {
+      return true;
+    }
+    return false;
+  };
+  assert(rejects([] { mapped_directed_graph<char, long>{path}; }));
+  assert(rejects([] { mapped_directed_graph<char, int, std::uint32_t>{path}; }));
+  assert(!rejects([] { mapped_directed_graph<char, int>{path}; }));
+
+  // Truncate the file.
+  {
+    std::ifstream is(path, std::ios::binary);
+    std::string s((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+    std::ofstream os(path, std::ios::binary | std::ios::trunc);
+    os.write(s.data(), s.size() - 8);
+  }
+  assert(rejects([] { mapped_directed_graph<char, int>{path}; }));
+
+  {
+    std::ofstream os(path, std::ios::binary | std::ios::trunc);
+    os << "0 1\n1 2\n";
+  }
+  assert(rejects([] { mapped_directed_graph<char, int>{path}; }));
+
+  // Missing files are system errors, which are runtime errors.
+  std::remove(path);
+  assert(rejects([] { mapped_directed_graph<char, int>{path}; }));
+}
+
+int main()
+{
+  check_compressed();
+  check_adjacency_vector();
+  check_invalid();
+  std::remove(path);
+}
@@ -0,0 +1,271 @@
+// Copyright (c) 2009-2015 Andrew Sutton
+// All rights reserved
+
+#ifndef ORIGIN_GRAPH_PAGERANK_HPP
+#define ORIGIN_GRAPH_PAGERANK_HPP
+
+#include <cassert>
+#include <cmath>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <origin.graph/handle.hpp>
+#include <origin.graph/graph.hpp>
+#include <origin.graph/parallel.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                           [graph.pagerank]
+  //                               PageRank
+  //
+  // The PageRank of a vertex is the probability that a random walk is at
+  // that vertex. At each step, the walk follows a random out edge with
+  // probability d (the damping factor), and otherwise jumps to a vertex
+  // chosen from the teleport distribution: uniform for PageRank, or a given
+  // distribution for personalized PageRank. A walk at a vertex with no out
+  // edges always jumps.
+  //
+  // Ranks are computed by power iteration in pull style. Each vertex sums
+  // the contributions (rank divided by out degree) of its in neighbors, so
+  // each new rank is written by exactly one thread, and the vertices can be
+  // divided among threads without atomics. The iteration stops when the L1
+  // distance between successive rank vectors falls below the tolerance, or
+  // after the maximum number of iterations.
+  //
+  // The in neighbors are read from a pull adjacency: the in edges of the
+  // graph in CSR form, as contiguous arrays of offsets and source indexes.
+  // Summing the contributions of a vertex is then a gather from the
+  // contribution array over a contiguous run of indexes, with no edge
+  // handles or graph calls in the inner loop. The pull adjacency of a graph
+  // is built once, in O(n + m) time, and can be reused for any number of
+  // rankings.
+
+  // The tuning parameters of PageRank.
+  struct pagerank_options
+  {
+    double      damping = 0.85;
+    double      tolerance = 1e-6;
+    std::size_t max_iterations = 100;
+    std::size_t grain = parallel_grain;
+  };
+
+  // The result of PageRank. The rank of each vertex v is rank[v]; the ranks
+  // of all vertices sum to 1. Indexes that are not vertices have rank 0.
+  struct pagerank_result
+  {
+    std::vector<double> rank;
+    std::size_t         iterations = 0;
+    double              error = 0;
+  };
+
+
+  // The in edges of a graph, in CSR form. The sources of the edges entering
+  // v are sources[i] for i in [offsets[v], offsets[v + 1]), in increasing
+  // order. Indexes are stored as T, which is the index type of the graph's
+  // vertex handles. Indexes that are not vertices of the graph (e.g.,
+  // removed vertices of an adjacency list) are excluded by the live mask,
+  // which is empty if every index is a vertex.
+  template<typename T = std::size_t>
+    struct pull_adjacency
+    {
+      std::size_t bound() const { return out_degree.size(); }
+      bool is_live(std::size_t v) const { return live.empty() || live[v]; }
+
+      std::vector<std::size_t> offsets;
+      std::vector<T>           sources;
+      std::vector<T>           out_degree;
+      std::vector<char>        live;
+      std::size_t              order = 0;
+    };
+
+  // Build the pull adjacency of g. Undirected edges are followed in both
+  // directions.
+  template<typename G>
+    pull_adjacency<typename Vertex<G>::value_type>
+    make_pull_adjacency(const G& g)
+    {
+      using T = typename Vertex<G>::value_type;
+      const std::size_t n = vertex_bound(g);
+
+      pull_adjacency<T> a;
+      a.order = g.order();
+      a.offsets.assign(n + 1, 0);
+      a.out_degree.assign(n, 0);
+      if (a.order != n)
+        a.live.assign(n, 0);
+      for (auto u : vertices(g)) {
+        if (!a.live.empty())
+          a.live[u] = 1;
+        for (auto e : out_edges(g, u)) {
+          ++a.out_degree[u];
+          ++a.offsets[std::size_t(out_neighbor(g, e, u)) + 1];
+        }
+      }
+      for (std::size_t v = 0; v < n; ++v)
+        a.offsets[v + 1] += a.offsets[v];
+
+      a.sources.resize(a.offsets[n]);
+      std::vector<std::size_t> next(a.offsets.begin(), a.offsets.end() - 1);
+      for (auto u : vertices(g))
+        for (auto e : out_edges(g, u))
+          a.sources[next[out_neighbor(g, e, u)]++] = T(u);
+      return a;
+    }
+
+
+  namespace pagerank_impl
+  {
+    // Returns the sum of x[i] for i in [first, last). The sum is split
+    // across four accumulators, so that the loads are independent and the
+    // loop can be unrolled and vectorized as a gather.
+    template<typename T>
+      inline double
+      gather_sum(const double* x, const T* first, const T* last)
+      {
+        double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+        for ( ; last - first >= 4; first += 4) {
+          s0 += x[first[0]];
+          s1 += x[first[1]];
+          s2 += x[first[2]];
+          s3 += x[first[3]];
+        }
+        for ( ; first != last; ++first)
+          s0 += x[*first];
+        return (s0 + s1) + (s2 + s3);
+      }
+
+    // Compute the ranks of a, with the teleport distribution t, or the
+    // uniform distribution if t is empty. The distribution must sum to 1.
+    template<typename T>
+      pagerank_result
+      iterate(const pull_adjacency<T>& a, const std::vector<double>& t,
+              const pagerank_options& opt)
+      {
+        const std::size_t n = a.bound();
+        const double d = opt.damping;
+        const double uniform = a.order ? 1.0 / a.order : 0.0;
+        auto teleport = [&](std::size_t v) -> double {
+          return !a.is_live(v) ? 0.0 : t.empty() ? uniform : t[v];
+        };
+
+        pagerank_result r;
+        r.rank.resize(n);
+        std::vector<double> contrib(n);
+        std::vector<double> next(n);
+        parallel_for(n, [&](std::size_t v) {
+          r.rank[v] = teleport(v);
+        }, opt.grain);
+
+        const std::size_t k = parallel_block_count(n, opt.grain);
+        std::vector<double> partial(k);
+        auto reduce = [&]() {
+          double s = 0;
+          for (double x : partial)
+            s += x;
+          return s;
+        };
+
+        while (r.iterations < opt.max_iterations) {
+          // Divide each rank among the out edges of its vertex, and sum the
+          // ranks of vertices without out edges.
+          parallel_blocks(n, [&](std::size_t b, std::size_t first, std::size_t last) {
+            double s = 0;
+            for (std::size_t u = first; u != last; ++u) {
+              if (a.out_degree[u]) {
+                contrib[u] = r.rank[u] / a.out_degree[u];
+              } else {
+                contrib[u] = 0;
+                s += r.rank[u];
+              }
+            }
+            partial[b] = s;
+          }, opt.grain);
+          const double dangling = reduce();
+
+          // Pull the contributions of in neighbors.
+          const double* x = contrib.data();
+          const T* src = a.sources.data();
+          parallel_blocks(n, [&](std::size_t b, std::size_t first, std::size_t last) {
+            double err = 0;
+            for (std::size_t v = first; v != last; ++v) {
+              double s = gather_sum(x, src + a.offsets[v], src + a.offsets[v + 1]);
+              double p = teleport(v);
+              next[v] = (1 - d) * p + d * (s + dangling * p);
+              err += std::fabs(next[v] - r.rank[v]);
+            }
+            partial[b] = err;
+          }, opt.grain);
+          r.error = reduce();
+          r.rank.swap(next);
+          ++r.iterations;
+          if (r.error < opt.tolerance)
+            break;
+        }
+        return r;
+      }
+
+  } // namespace pagerank_impl
+
+
+  // Compute the PageRank of the vertices of a.
+  template<typename T>
+    inline pagerank_result
+    pagerank(const pull_adjacency<T>& a, pagerank_options opt = {})
+    {
+      return pagerank_impl::iterate(a, {}, opt);
+    }
+
+  template<typename G>
+    inline pagerank_result
+    pagerank(const G& g, pagerank_options opt = {})
+    {
+      return pagerank(make_pull_adjacency(g), opt);
+    }
+
+  // Compute the personalized PageRank of the vertices of a, where the walk
+  // jumps to each vertex v in proportion to p[v]. The weights must be
+  // non-negative, and at least one must be positive.
+  template<typename T>
+    pagerank_result
+    personalized_pagerank(const pull_adjacency<T>& a, const std::vector<double>& p,
+                          pagerank_options opt = {})
+    {
+      assert(p.size() == a.bound());
+      double sum = 0;
+      for (std::size_t v = 0; v < p.size(); ++v) {
+        assert(p[v] >= 0);
+        if (a.is_live(v))
+          sum += p[v];
+      }
+      assert(sum > 0);
+      std::vector<double> t(p.size());
+      for (std::size_t v = 0; v < p.size(); ++v)
+        t[v] = p[v] / sum;
+      return pagerank_impl::iterate(a, t, opt);
+    }
+
+  template<typename G>
+    inline pagerank_result
+    personalized_pagerank(const G& g, const std::vector<double>& p,
+                          pagerank_options opt = {})
+    {
+      return personalized_pagerank(make_pull_adjacency(g), p, opt);
+    }
+
+  // Compute the personalized PageRank of the vertices of g, where the walk
+  // always jumps to s.
+  template<typename G>
+    inline pagerank_result
+    personalized_pagerank(const G& g, Vertex<G> s, pagerank_options opt = {})
+    {
+      std::vector<double> p(vertex_bound(g), 0.0);
+      p[s] = 1;
+      return personalized_pagerank(make_pull_adjacency(g), p, opt);
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,120 @@
+// Copyright (c) 2009-2015 Andrew Sutton
+// All rights reserved
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+
+#include <origin.graph/adjacency_list.hpp>
+#include <origin.graph/adjacency_vector.hpp>
+#include <origin.graph/compressed_graph.hpp>
+#include <origin.graph/pagerank.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+// Returns the ranks of g after a fixed number of push-style iterations,
+// with the teleport distribution t.
+template<typename G>
+  vector<double>
+  reference_ranks(const G& g, vector<double> t, size_t iterations, double d = 0.85)
+  {
+    size_t n = vertex_bound(g);
+    vector<double> r = t;
+    for (size_t i = 0; i < iterations; ++i) {
+      vector<double> next(n, 0.0);
+      double dangling = 0;
+      for (auto u : vertices(g)) {
+        size_t k = out_degree(g, u);
+        if (k == 0)
+          dangling += r[u];
+        for (auto e : out_edges(g, u))
+          next[out_neighbor(g, e, u)] += d * r[u] / k;
+      }
+      for (auto v : vertices(g))
+        next[v] += (1 - d) * t[v] + d * dangling * t[v];
+      r = next;
+    }
+    return r;
+  }
+
+void
+check_close(const vector<double>& x, const vector<double>& y)
+{
+  assert(x.size() == y.size());
+  double sum = 0;
+  for (size_t i = 0; i < x.size(); ++i) {
+    assert(fabs(x[i] - y[i]) < 1e-12);
+    sum += x[i];
+  }
+  assert(fabs(sum - 1) < 1e-9);
+}
+
+template<typename G>
+  void
+  check_pagerank(const G& g)
+  {
+    cout << "*** pagerank (" << typestr<G>() << ") ***\n";
+    size_t n = vertex_bound(g);
+    vector<double> uniform(n, 0.0);
+    for (auto v : vertices(g))
+      uniform[v] = 1.0 / g.order();
+
+    // A fixed number of iterations, divided among many blocks.
+    pagerank_options opt;
+    opt.tolerance = 0;
+    opt.max_iterations = 15;
+    opt.grain = 7;
+    auto r = pagerank(g, opt);
+    assert(r.iterations == 15);
+    check_close(r.rank, reference_ranks(g, uniform, 15));
+
+    // The default tolerance is reached before the iteration limit.
+    auto a = make_pull_adjacency(g);
+    auto c = pagerank(a);
+    assert(c.iterations < pagerank_options().max_iterations);
+    assert(c.error < pagerank_options().tolerance);
+    check_close(c.rank, reference_ranks(g, uniform, c.iterations));
+
+    // Personalized ranks, teleporting to one vertex or to two.
+    Vertex<G> s(1);
+    vector<double> p(n, 0.0);
+    p[s] = 1;
+    auto q = personalized_pagerank(g, s, opt);
+    check_close(q.rank, reference_ranks(g, p, 15));
+    p[17] = 3;
+    vector<double> t = p;
+    for (double& x : t)
+      x /= 4;
+    check_close(personalized_pagerank(a, p, opt).rank, reference_ranks(g, t, 15));
+  }
+
+int main()
+{
+  auto input = random_edges(2000, 8000);
+
+  check_pagerank(directed_adjacency_vector<>(input.begin(), input.end()));
+  check_pagerank(directed_adjacency_vector<empty_t, empty_t, uint32_t>(input.begin(), input.end()));
+  check_pagerank(undirected_adjacency_vector<>(input.begin(), input.end()));
+  check_pagerank(compressed_directed_graph<>(input.begin(), input.end()));
+  check_pagerank(compressed_directed_graph<empty_t, empty_t, false>(input.begin(), input.end()));
+
+  // Removed vertices leave gaps in the vertex indexes, and have no rank.
+  directed_adjacency_list<> g(input.begin(), input.end());
+  for (size_t v = 1000; v < 2000; v += 3)
+    g.remove_vertex(v);
+  check_pagerank(g);
+  auto a = make_pull_adjacency(g);
+  assert(!a.is_live(1000));
+  assert(pagerank(a).rank[1000] == 0);
+
+  // The pull adjacency of a 32-bit graph stores 32-bit sources.
+  directed_adjacency_vector<empty_t, empty_t, uint32_t> h(input.begin(), input.end());
+  pull_adjacency<uint32_t> b = make_pull_adjacency(h);
+  assert(b.sources.size() == h.size());
+  assert(is_sorted(b.sources.begin() + b.offsets[3], b.sources.begin() + b.offsets[4]));
+}
@@ -0,0 +1,248 @@
+// Copyright (c) 2009-2015 Andrew Sutton
+// All rights reserved
+
+#ifndef ORIGIN_GRAPH_PARALLEL_HPP
+#define ORIGIN_GRAPH_PARALLEL_HPP
+
+#include <cassert>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                              Parallel Loops
+  //
+  // The parallel algorithms of this library divide a range of indexes into
+  // contiguous blocks and process each block on its own thread. Ranges that
+  // are too small to be worth dividing are processed on the calling thread.
+  //
+  // Blocks are run by a pool of worker threads that is started by the first
+  // parallel loop and reused by every later one, so that algorithms that
+  // run a loop per step (e.g., per level of a search) do not pay for thread
+  // startup at each step. The calling thread runs blocks too. One loop runs
+  // on the pool at a time; a parallel loop called from within the body of
+  // another runs on the calling thread.
+  //
+  // The grain is the approximate minimum number of indexes given to each
+  // thread. If the body of a loop throws an exception, the first such
+  // exception is rethrown on the calling thread after all blocks finish.
+
+  // The default grain of parallel loops.
+  constexpr std::size_t parallel_grain = 4096;
+
+  // Returns the number of threads used by parallel loops. This is the
+  // number of hardware threads, and at least 1.
+  inline std::size_t
+  parallel_workers()
+  {
+    static const std::size_t n = std::max(std::thread::hardware_concurrency(), 1u);
+    return n;
+  }
+
+  // Returns the number of blocks into which n indexes are divided.
+  inline std::size_t
+  parallel_block_count(std::size_t n, std::size_t grain = parallel_grain)
+  {
+    assert(grain > 0);
+    std::size_t k = n / grain + (n % grain != 0);
+    return std::max<std::size_t>(std::min(k, parallel_workers()), 1);
+  }
+
+  namespace parallel_impl
+  {
+    // True on a thread that is running a block of a parallel loop.
+    inline bool&
+    in_parallel_loop()
+    {
+      static thread_local bool x = false;
+      return x;
+    }
+
+    // A pool of worker threads. A job is a number of blocks and a function
+    // to call for each. The blocks are claimed by the workers and the
+    // submitting thread through an atomic counter.
+    class thread_pool
+    {
+    public:
+      explicit thread_pool(std::size_t n);
+      ~thread_pool();
+
+      thread_pool(const thread_pool&) = delete;
+      thread_pool& operator=(const thread_pool&) = delete;
+
+      // Call f(b) for each b in [0, k), and return when all calls finish.
+      template<typename F>
+        void run(std::size_t k, F& f);
+
+    private:
+      template<typename F>
+        static void invoke(void* f, std::size_t b) { (*static_cast<F*>(f))(b); }
+
+      void work();
+      std::size_t drain();
+
+      std::mutex               submit_;    // Held while a job runs
+      std::mutex               m_;         // Guards the job state below
+      std::condition_variable  start_;     // Signals a new job, or stop
+      std::condition_variable  idle_;      // Signals finished blocks
+      void                   (*call_)(void*, std::size_t);
+      void*                    ctx_;
+      std::size_t              blocks_;    // Blocks in the current job
+      std::atomic<std::size_t> next_;      // The next unclaimed block
+      std::size_t              remaining_; // Blocks not yet finished
+      std::size_t              active_;    // Workers in the current job
+      std::uint64_t            epoch_;     // The number of jobs started
+      bool                     stop_;
+      std::vector<std::thread> threads_;
+    };
+
+    // Start n - 1 workers; the submitting thread is the nth.
+    inline
+    thread_pool::thread_pool(std::size_t n)
+      : call_(nullptr), ctx_(nullptr), blocks_(0), next_(0), remaining_(0),
+        active_(0), epoch_(0), stop_(false)
+    {
+      threads_.reserve(n - 1);
+      for (std::size_t i = 1; i < n; ++i)
+        threads_.emplace_back([this] { work(); });
+    }
+
+    inline
+    thread_pool::~thread_pool()
+    {
+      {
+        std::lock_guard<std::mutex> l(m_);
+        stop_ = true;
+      }
+      start_.notify_all();
+      for (std::thread& t : threads_)
+        t.join();
+    }
+
+    // Run the blocks of the current job until none remain. Returns the
+    // number of blocks run.
+    inline std::size_t
+    thread_pool::drain()
+    {
+      bool& inside = in_parallel_loop();
+      inside = true;
+      std::size_t n = 0;
+      for (std::size_t b; (b = next_.fetch_add(1, std::memory_order_relaxed)) < blocks_; ++n)
+        call_(ctx_, b);
+      inside = false;
+      return n;
+    }
+
+    // Join each job as it starts. A worker that joins a job after its
+    // blocks are claimed finds nothing to do. The next job is not started
+    // until every worker has left the last one.
+    inline void
+    thread_pool::work()
+    {
+      std::uint64_t seen = 0;
+      std::unique_lock<std::mutex> l(m_);
+      for (;;) {
+        start_.wait(l, [&] { return stop_ || epoch_ != seen; });
+        if (stop_)
+          return;
+        seen = epoch_;
+        ++active_;
+        l.unlock();
+        std::size_t n = drain();
+        l.lock();
+        remaining_ -= n;
+        --active_;
+        if (remaining_ == 0 || active_ == 0)
+          idle_.notify_all();
+      }
+    }
+
+    template<typename F>
+      void
+      thread_pool::run(std::size_t k, F& f)
+      {
+        std::lock_guard<std::mutex> s(submit_);
+        {
+          std::unique_lock<std::mutex> l(m_);
+          idle_.wait(l, [&] { return active_ == 0; });
+          call_ = &invoke<F>;
+          ctx_ = &f;
+          blocks_ = k;
+          next_.store(0, std::memory_order_relaxed);
+          remaining_ = k;
+          ++epoch_;
+        }
+        start_.notify_all();
+        std::size_t n = drain();
+        std::unique_lock<std::mutex> l(m_);
+        remaining_ -= n;
+        idle_.wait(l, [&] { return remaining_ == 0; });
+      }
+
+    // Returns the pool used by parallel loops.
+    inline thread_pool&
+    workers()
+    {
+      static thread_pool pool(parallel_workers());
+      return pool;
+    }
+
+  } // namespace parallel_impl
+
+  // Divide the indexes [0, n) into blocks and call f(b, first, last) for
+  // each block, where b is the block number and [first, last) are its
+  // indexes. Blocks are numbered from 0 to parallel_block_count(n, grain),
+  // so callers can allocate per-block state in advance.
+  template<typename F>
+    void
+    parallel_blocks(std::size_t n, F f, std::size_t grain = parallel_grain)
+    {
+      std::size_t k = parallel_block_count(n, grain);
+      if (k == 1) {
+        f(std::size_t(0), std::size_t(0), n);
+        return;
+      }
+
+      std::vector<std::exception_ptr> errors(k);
+      auto run = [&](std::size_t b) {
+        try {
+          f(b, n * b / k, n * (b + 1) / k);
+        } catch (...) {
+          errors[b] = std::current_exception();
+        }
+      };
+
+      if (parallel_impl::in_parallel_loop()) {
+        for (std::size_t b = 0; b < k; ++b)
+          run(b);
+      } else {
+        parallel_impl::workers().run(k, run);
+      }
+
+      for (std::exception_ptr& e : errors)
+        if (e)
+          std::rethrow_exception(e);
+    }
+
+  // Call f(i) for each index in [0, n), in parallel.
+  template<typename F>
+    void
+    parallel_for(std::size_t n, F f, std::size_t grain = parallel_grain)
+    {
+      parallel_blocks(n, [&f](std::size_t, std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i != last; ++i)
+          f(i);
+      }, grain);
+    }
+
+} // namespace origin
+
+#endif
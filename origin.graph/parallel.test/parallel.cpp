@@ -0,0 +1,99 @@
+// Copyright (c) 2009-2015 Andrew Sutton
+// All rights reserved
+
+#include <cassert>
+#include <atomic>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <origin.graph/parallel.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Every index is visited exactly once, in every one of many loops run on
+// the same workers.
+void
+check_loops()
+{
+  cout << "*** parallel loops ***\n";
+  vector<int> x(10000, 0);
+  for (int i = 0; i < 1000; ++i)
+    parallel_for(x.size(), [&](size_t j) { ++x[j]; }, 64);
+  for (int k : x)
+    assert(k == 1000);
+
+  // Blocks partition the range.
+  size_t k = parallel_block_count(x.size(), 64);
+  vector<size_t> first(k), last(k);
+  parallel_blocks(x.size(), [&](size_t b, size_t f, size_t l) {
+    first[b] = f;
+    last[b] = l;
+  }, 64);
+  assert(first[0] == 0 && last[k - 1] == x.size());
+  for (size_t b = 1; b < k; ++b)
+    assert(first[b] == last[b - 1]);
+}
+
+// A loop within the body of another runs on the calling thread.
+void
+check_nested()
+{
+  cout << "*** nested parallel loops ***\n";
+  atomic<size_t> n(0);
+  parallel_for(100, [&](size_t) {
+    parallel_for(1000, [&](size_t) {
+      n.fetch_add(1, memory_order_relaxed);
+    }, 1);
+  }, 1);
+  assert(n == 100000);
+}
+
+// The first exception thrown by a block is rethrown after the loop, and the
+// workers remain usable.
+void
+check_exceptions()
+{
+  cout << "*** parallel exceptions ***\n";
+  bool caught = false;
+  try {
+    parallel_for(1000, [](size_t i) {
+      if (i == 500)
+        throw runtime_error("block");
+    }, 1);
+  } catch (const runtime_error&) {
+    caught = true;
+  }
+  assert(caught);
+
+  atomic<size_t> n(0);
+  parallel_for(1000, [&](size_t) { n.fetch_add(1, memory_order_relaxed); }, 1);
+  assert(n == 1000);
+}
+
+// Loops started by different threads take turns on the workers.
+void
+check_concurrent()
+{
+  cout << "*** concurrent parallel loops ***\n";
+  atomic<size_t> n(0);
+  vector<thread> ts;
+  for (int t = 0; t < 4; ++t)
+    ts.emplace_back([&] {
+      for (int i = 0; i < 100; ++i)
+        parallel_for(1000, [&](size_t) { n.fetch_add(1, memory_order_relaxed); }, 16);
+    });
+  for (thread& t : ts)
+    t.join();
+  assert(n == 400000);
+}
+
+int main()
+{
+  check_loops();
+  check_nested();
+  check_exceptions();
+  check_concurrent();
+}
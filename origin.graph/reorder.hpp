@@ -0,0 +1,222 @@
+// Copyright (c) 2009-2015 Andrew Sutton
+// All rights reserved
+
+#ifndef ORIGIN_GRAPH_REORDER_HPP
+#define ORIGIN_GRAPH_REORDER_HPP
+
+#include <cassert>
+
+#include <algorithm>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <origin.graph/handle.hpp>
+#include <origin.graph/graph.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                            [graph.reorder]
+  //                           Vertex Reordering
+  //
+  // The vertices of a graph are numbered in the order they were added, so
+  // the neighbors of a vertex are usually scattered across the vertex and
+  // edge arrays, and traversals touch a new cache line for nearly every
+  // edge. Renumbering the vertices so that neighbors have nearby numbers
+  // (or so that frequently accessed vertices are packed together) can make
+  // traversals much faster.
+  //
+  // A reordering computes a permutation: a vector p indexed by vertex, where
+  // p[v] is the new index of v. The new indexes of the vertices of g are
+  // [0, g.order()). Indexes that are not vertices (e.g., removed vertices of
+  // an adjacency list) map to std::size_t(-1). The graph is then rebuilt
+  // under the permutation by relabel.
+  //
+  //    reverse_cuthill_mckee_ordering - Breadth-first order, starting each
+  //        component from a vertex of least degree and visiting neighbors in
+  //        order of increasing degree, then reversed. Neighbors are numbered
+  //        close together, which reduces the bandwidth of the adjacency
+  //        matrix. This suits graphs with local structure (meshes, roads).
+  //    degree_sort_ordering - Vertices in order of decreasing degree. The
+  //        most frequently accessed vertices share cache lines.
+  //    hub_cluster_ordering - Vertices of greater than average degree
+  //        (hubs) first, and then the rest, each group in its original
+  //        order. This packs the hubs together, like a degree sort, but
+  //        preserves whatever locality the original order had. It suits
+  //        power-law graphs.
+  //
+  // Directed graphs are ordered by their out edges.
+
+  namespace reorder_impl
+  {
+    constexpr std::size_t npos = -1;
+
+    // Returns the permutation that numbers the vertices in the given order.
+    inline std::vector<std::size_t>
+    number(const std::vector<std::size_t>& order, std::size_t n)
+    {
+      std::vector<std::size_t> p(n, npos);
+      for (std::size_t i = 0; i < order.size(); ++i)
+        p[order[i]] = i;
+      return p;
+    }
+
+    // Returns the vertices of g, in increasing order.
+    template<typename G>
+      std::vector<std::size_t>
+      vertex_list(const G& g)
+      {
+        std::vector<std::size_t> r;
+        r.reserve(g.order());
+        for (auto v : vertices(g))
+          r.push_back(v);
+        std::sort(r.begin(), r.end());
+        return r;
+      }
+
+  } // namespace reorder_impl
+
+
+  template<typename G>
+    std::vector<std::size_t>
+    reverse_cuthill_mckee_ordering(const G& g)
+    {
+      const std::size_t n = vertex_bound(g);
+      std::vector<std::size_t> degree(n, 0);
+      for (auto v : vertices(g))
+        degree[v] = out_degree(g, v);
+      auto by_degree = [&](std::size_t u, std::size_t v) {
+        return degree[u] < degree[v];
+      };
+
+      // Start each component from its first vertex of least degree.
+      std::vector<std::size_t> starts = reorder_impl::vertex_list(g);
+      std::stable_sort(starts.begin(), starts.end(), by_degree);
+
+      // The order doubles as the queue of the breadth-first search.
+      std::vector<char> seen(n, 0);
+      std::vector<std::size_t> order;
+      order.reserve(starts.size());
+      for (std::size_t s : starts) {
+        if (seen[s])
+          continue;
+        seen[s] = 1;
+        order.push_back(s);
+        for (std::size_t i = order.size() - 1; i < order.size(); ++i) {
+          Vertex<G> u(order[i]);
+          std::size_t first = order.size();
+          for (auto e : out_edges(g, u)) {
+            std::size_t v = out_neighbor(g, e, u);
+            if (!seen[v]) {
+              seen[v] = 1;
+              order.push_back(v);
+            }
+          }
+          std::stable_sort(order.begin() + first, order.end(), by_degree);
+        }
+      }
+      std::reverse(order.begin(), order.end());
+      return reorder_impl::number(order, n);
+    }
+
+  template<typename G>
+    std::vector<std::size_t>
+    degree_sort_ordering(const G& g)
+    {
+      const std::size_t n = vertex_bound(g);
+      std::vector<std::size_t> degree(n, 0);
+      for (auto v : vertices(g))
+        degree[v] = out_degree(g, v);
+      std::vector<std::size_t> order = reorder_impl::vertex_list(g);
+      std::stable_sort(order.begin(), order.end(), [&](std::size_t u, std::size_t v) {
+        return degree[u] > degree[v];
+      });
+      return reorder_impl::number(order, n);
+    }
+
+  template<typename G>
+    std::vector<std::size_t>
+    hub_cluster_ordering(const G& g)
+    {
+      const std::size_t n = vertex_bound(g);
+      std::vector<std::size_t> order = reorder_impl::vertex_list(g);
+      if (order.empty())
+        return reorder_impl::number(order, n);
+      const double average = double(out_edge_count(g)) / order.size();
+      std::stable_partition(order.begin(), order.end(), [&](std::size_t v) {
+        return out_degree(g, Vertex<G>(v)) > average;
+      });
+      return reorder_impl::number(order, n);
+    }
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                            [graph.relabel]
+  //                               Relabeling
+  //
+  // Relabeling a graph builds a new graph of the same type, in which each
+  // vertex v of the original is the vertex p[v], and each edge (u, v) is
+  // the edge (p[u], p[v]). Vertex and edge values are copied. Edges are
+  // added in order of their new endpoints, so the out edges of each vertex
+  // are also stored in order of their targets. The graph must be
+  // constructible from a range of input edges.
+
+  namespace reorder_impl
+  {
+    // The input edge for an edge with a value of type E. Empty values are
+    // not stored.
+    template<typename E>
+      using input_edge = typename std::conditional<
+        std::is_empty<E>::value,
+        std::pair<std::size_t, std::size_t>,
+        std::tuple<std::size_t, std::size_t, E>
+      >::type;
+
+    template<typename E, typename T>
+      inline std::pair<std::size_t, std::size_t>
+      make_input(std::size_t u, std::size_t v, const T&, std::true_type)
+      {
+        return {u, v};
+      }
+
+    template<typename E, typename T>
+      inline std::tuple<std::size_t, std::size_t, E>
+      make_input(std::size_t u, std::size_t v, const T& x, std::false_type)
+      {
+        return std::tuple<std::size_t, std::size_t, E>(u, v, x);
+      }
+
+  } // namespace reorder_impl
+
+  template<typename G>
+    G
+    relabel(const G& g, const std::vector<std::size_t>& p)
+    {
+      using E = typename std::decay<decltype(g(std::declval<Edge<G>>()))>::type;
+      using input = reorder_impl::input_edge<E>;
+      assert(p.size() == vertex_bound(g));
+
+      std::vector<input> list;
+      list.reserve(g.size());
+      for (auto e : edges(g)) {
+        std::size_t u = p[source(g, e)];
+        std::size_t v = p[target(g, e)];
+        assert(u != reorder_impl::npos && v != reorder_impl::npos);
+        list.push_back(reorder_impl::make_input<E>(u, v, g(e), std::is_empty<E>{}));
+      }
+      std::stable_sort(list.begin(), list.end(), [](const input& x, const input& y) {
+        return std::make_pair(std::get<0>(x), std::get<1>(x))
+             < std::make_pair(std::get<0>(y), std::get<1>(y));
+      });
+
+      G h(list.begin(), list.end(), g.order());
+      for (auto v : vertices(g))
+        h(Vertex<G>(p[v])) = g(v);
+      return h;
+    }
+
+} // namespace origin
+
+#endif
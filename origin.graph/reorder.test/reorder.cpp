@@ -0,0 +1,141 @@
+// Copyright (c) 2009-2015 Andrew Sutton
+// All rights reserved
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <tuple>
+
+#include <origin.graph/adjacency_list.hpp>
+#include <origin.graph/adjacency_vector.hpp>
+#include <origin.graph/compressed_graph.hpp>
+#include <origin.graph/reorder.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+// Check that p maps the vertices of g onto [0, g.order()).
+template<typename G>
+  void
+  check_permutation(const G& g, const vector<size_t>& p)
+  {
+    assert(p.size() == vertex_bound(g));
+    vector<char> used(g.order(), 0);
+    size_t k = 0;
+    for (auto v : vertices(g)) {
+      assert(p[v] < g.order() && !used[p[v]]);
+      used[p[v]] = 1;
+      ++k;
+    }
+    assert(k == g.order());
+    assert(count(p.begin(), p.end(), size_t(-1)) == ptrdiff_t(p.size() - k));
+  }
+
+// Check that h is g relabeled by p: the same edges and values, under the
+// permutation.
+template<typename G>
+  void
+  check_relabel(const G& g, const vector<size_t>& p, const G& h)
+  {
+    assert(h.order() == g.order());
+    assert(h.size() == g.size());
+    using T = tuple<size_t, size_t, decay_t<decltype(g(declval<Edge<G>>()))>>;
+    vector<T> x, y;
+    for (auto e : edges(g))
+      x.emplace_back(p[source(g, e)], p[target(g, e)], g(e));
+    for (auto e : edges(h))
+      y.emplace_back(source(h, e), target(h, e), h(e));
+    sort(x.begin(), x.end());
+    sort(y.begin(), y.end());
+    assert(x == y);
+    for (auto v : vertices(g))
+      assert(h(Vertex<G>(p[v])) == g(v));
+  }
+
+template<typename G>
+  void
+  check_reorder(const G& g)
+  {
+    cout << "*** reorder (" << typestr<G>() << ") ***\n";
+    for (auto p : {reverse_cuthill_mckee_ordering(g),
+                   degree_sort_ordering(g),
+                   hub_cluster_ordering(g)}) {
+      check_permutation(g, p);
+      check_relabel(g, p, relabel(g, p));
+    }
+
+    // A degree sort leaves degrees in decreasing order.
+    G h = relabel(g, degree_sort_ordering(g));
+    for (size_t v = 1; v < h.order(); ++v)
+      assert(out_degree(h, Vertex<G>(v - 1)) >= out_degree(h, Vertex<G>(v)));
+
+    // Hub clustering puts the vertices of greater than average degree
+    // first.
+    G c = relabel(g, hub_cluster_ordering(g));
+    double average = double(out_edge_count(c)) / c.order();
+    bool hubs = true;
+    for (auto v : vertices(c)) {
+      bool hub = out_degree(c, v) > average;
+      assert(hubs || !hub);
+      hubs = hub;
+    }
+  }
+
+// Add values to vertices and edges, so that relabeling must move them.
+template<typename G>
+  G
+  with_values(const vector<pair<size_t, size_t>>& input)
+  {
+    vector<tuple<size_t, size_t, int>> edges;
+    int i = 0;
+    for (auto e : input)
+      edges.emplace_back(e.first, e.second, i++);
+    G g(edges.begin(), edges.end());
+    for (auto v : vertices(g))
+      g(v) = 2 * int(v) + 1;
+    return g;
+  }
+
+int main()
+{
+  auto input = random_edges(2000, 8000);
+  check_reorder(with_values<directed_adjacency_vector<int, int>>(input));
+  check_reorder(with_values<directed_adjacency_vector<int, int, uint32_t>>(input));
+  check_reorder(with_values<undirected_adjacency_vector<int, int, uint32_t>>(input));
+  check_reorder(with_values<compressed_directed_graph<int, int>>(input));
+  check_reorder(with_values<compressed_undirected_graph<int, int>>(input));
+
+  // Removed vertices leave gaps in the vertex indexes, which are closed
+  // by relabeling.
+  auto g = with_values<directed_adjacency_list<int, int>>(input);
+  for (size_t v = 1000; v < 2000; v += 3)
+    g.remove_vertex(v);
+  check_reorder(g);
+  auto p = degree_sort_ordering(g);
+  assert(p[1000] == size_t(-1));
+  assert(vertex_bound(relabel(g, p)) == g.order());
+
+  // Graphs without values are relabeled from pairs.
+  directed_adjacency_vector<> d(input.begin(), input.end());
+  auto dp = reverse_cuthill_mckee_ordering(d);
+  auto e = relabel(d, dp);
+  assert(e.size() == d.size());
+  for (auto v : vertices(d))
+    assert(out_degree(e, Vertex<decltype(e)>(dp[v])) == out_degree(d, v));
+
+  // Reverse Cuthill-McKee numbers a scrambled path in path order, so that
+  // every edge joins consecutive vertices.
+  vector<pair<size_t, size_t>> path;
+  for (size_t i = 0; i < 999; ++i)
+    path.emplace_back((i * 7919) % 1000, ((i + 1) * 7919) % 1000);
+  auto q = with_values<undirected_adjacency_vector<int, int>>(path);
+  auto r = relabel(q, reverse_cuthill_mckee_ordering(q));
+  for (auto e : edges(r)) {
+    size_t u = source(r, e);
+    size_t v = target(r, e);
+    assert(max(u, v) - min(u, v) == 1);
+  }
+}
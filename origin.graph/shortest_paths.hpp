@@ -0,0 +1,542 @@
+// Copyright (c) 2009-2015 Andrew Sutton
+// All rights reserved
+
+#ifndef ORIGIN_GRAPH_SHORTEST_PATHS_HPP
+#define ORIGIN_GRAPH_SHORTEST_PATHS_HPP
+
+#include <cassert>
+#include <climits>
+#include <cstdint>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <origin.graph/handle.hpp>
+#include <origin.graph/graph.hpp>
+#include <origin.graph/parallel.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                         [graph.sssp.weight]
+  //                              Edge Weights
+  //
+  // Shortest path algorithms are parameterized over an edge weight accessor,
+  // a function object that returns the weight of an edge. Weights must be
+  // non-negative. By default, the weight of an edge is its value, g(e).
+
+  template<typename G>
+    struct edge_value_accessor
+    {
+      edge_value_accessor(const G& g) : g(g) { }
+
+      auto operator()(Edge<G> e) const -> decltype(std::declval<const G&>()(e))
+      {
+        return g(e);
+      }
+
+      const G& g;
+    };
+
+  // Returns an accessor for the values of the edges of g.
+  template<typename G>
+    inline edge_value_accessor<G>
+    edge_values(const G& g) { return edge_value_accessor<G>(g); }
+
+  // The type of weight returned by the accessor W for edges of G.
+  template<typename G, typename W>
+    using Weight_type = typename std::decay<
+      decltype(std::declval<const W&>()(std::declval<Edge<G>>()))
+    >::type;
+
+
+  // The result of a single-source shortest paths search. The distance of
+  // each vertex v from the source is distance[v], and its predecessor on a
+  // shortest path is parent[v]. The parent of the source is the source.
+  // Vertices that were not reached have an invalid parent, and a distance
+  // of std::numeric_limits<D>::max().
+  template<typename G, typename D>
+    struct shortest_path_tree
+    {
+      using distance_type = D;
+
+      static constexpr D infinity() { return std::numeric_limits<D>::max(); }
+
+      bool reached(Vertex<G> v) const { return bool(parent[v]); }
+
+      std::vector<D>         distance;
+      std::vector<Vertex<G>> parent;
+    };
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                          [graph.sssp.queue]
+  //                            Priority Queues
+  //
+  // Dijkstra's algorithm is parameterized over the priority queue of vertices
+  // it has discovered but not settled. A queue for keys of type D is
+  // constructed with the vertex bound of the graph, and has the operations:
+  //
+  //    q.push(v, d)  - Insert v with key d, or decrease the key of v to d
+  //    q.pop()       - Remove a vertex with the least key, and return the
+  //                    pair (v, d)
+  //    q.empty()     - True if there are no vertices in the queue
+  //
+  // Queues may leave stale entries instead of decreasing keys; the algorithm
+  // skips popped entries whose key exceeds the distance of their vertex.
+  //
+  // A queue is selected by a selector type, whose member template queue<D>
+  // is the queue for keys of type D:
+  //
+  //    binary_heap   - A binary heap, with stale entries. This is usually
+  //                    the fastest queue for sparse graphs.
+  //    dary_heap<K>  - A K-ary heap with decrease-key, indexed by vertex. The
+  //                    queue holds at most one entry per vertex, and its
+  //                    shallower tree makes decrease-key cheaper.
+  //    radix_heap    - A radix heap for integer weights. Keys are grouped by
+  //                    their highest bit that differs from the last key
+  //                    popped, so each key is moved at most once per bit.
+
+  template<typename D>
+    class binary_heap_queue
+    {
+      using entry = std::pair<D, std::size_t>;
+    public:
+      explicit binary_heap_queue(std::size_t) { }
+
+      bool empty() const { return heap.empty(); }
+
+      void push(std::size_t v, D d) { heap.emplace(d, v); }
+
+      std::pair<std::size_t, D> pop()
+      {
+        entry x = heap.top();
+        heap.pop();
+        return {x.second, x.first};
+      }
+
+    private:
+      std::priority_queue<entry, std::vector<entry>, std::greater<entry>> heap;
+    };
+
+
+  template<typename D, std::size_t K = 4>
+    class dary_heap_queue
+    {
+      static_assert(K >= 2, "a heap has at least two children per node");
+
+      using entry = std::pair<D, std::size_t>;
+      static constexpr std::size_t npos = -1;
+    public:
+      explicit dary_heap_queue(std::size_t n)
+        : pos(n, npos)
+      { }
+
+      bool empty() const { return heap.empty(); }
+
+      void push(std::size_t v, D d);
+      std::pair<std::size_t, D> pop();
+
+    private:
+      void place(std::size_t i, const entry& x)
+      {
+        heap[i] = x;
+        pos[x.second] = i;
+      }
+
+      void sift_up(std::size_t i);
+      void sift_down(std::size_t i);
+
+      std::vector<entry>       heap;
+      std::vector<std::size_t> pos; // Position of each vertex in the heap
+    };
+
+  template<typename D, std::size_t K>
+    void
+    dary_heap_queue<D, K>::push(std::size_t v, D d)
+    {
+      std::size_t i = pos[v];
+      if (i == npos) {
+        i = heap.size();
+        heap.emplace_back(d, v);
+        pos[v] = i;
+      } else {
+        assert(d <= heap[i].first);
+        heap[i].first = d;
+      }
+      sift_up(i);
+    }
+
+  template<typename D, std::size_t K>
+    auto
+    dary_heap_queue<D, K>::pop() -> std::pair<std::size_t, D>
+    {
+      entry x = heap.front();
+      pos[x.second] = npos;
+      entry y = heap.back();
+      heap.pop_back();
+      if (!heap.empty()) {
+        place(0, y);
+        sift_down(0);
+      }
+      return {x.second, x.first};
+    }
+
+  template<typename D, std::size_t K>
+    void
+    dary_heap_queue<D, K>::sift_up(std::size_t i)
+    {
+      entry x = heap[i];
+      while (i > 0) {
+        std::size_t p = (i - 1) / K;
+        if (!(x.first < heap[p].first))
+          break;
+        place(i, heap[p]);
+        i = p;
+      }
+      place(i, x);
+    }
+
+  template<typename D, std::size_t K>
+    void
+    dary_heap_queue<D, K>::sift_down(std::size_t i)
+    {
+      entry x = heap[i];
+      const std::size_t n = heap.size();
+      for (;;) {
+        std::size_t c = i * K + 1;
+        if (c >= n)
+          break;
+        std::size_t last = std::min(c + K, n);
+        std::size_t m = c;
+        for (++c; c < last; ++c)
+          if (heap[c].first < heap[m].first)
+            m = c;
+        if (!(heap[m].first < x.first))
+          break;
+        place(i, heap[m]);
+        i = m;
+      }
+      place(i, x);
+    }
+
+
+  template<typename D>
+    class radix_heap_queue
+    {
+      static_assert(std::is_integral<D>::value, "radix heaps require integer keys");
+
+      using key_type = typename std::make_unsigned<D>::type;
+      using entry = std::pair<std::size_t, key_type>;
+
+      static constexpr int bits = std::numeric_limits<key_type>::digits;
+    public:
+      explicit radix_heap_queue(std::size_t)
+        : last(0), count(0)
+      { }
+
+      bool empty() const { return count == 0; }
+
+      void push(std::size_t v, D d);
+      std::pair<std::size_t, D> pop();
+
+    private:
+      // Returns the bucket of the key k: 0 if k is the last key, and
+      // otherwise one more than the index of the highest bit in which k
+      // differs from the last key.
+      int bucket(key_type k) const
+      {
+        std::uint64_t x = std::uint64_t(k ^ last);
+        return x == 0 ? 0 : 64 - __builtin_clzll(x);
+      }
+
+      std::array<std::vector<entry>, bits + 1> buckets;
+      key_type last;
+      std::size_t count;
+    };
+
+  template<typename D>
+    inline void
+    radix_heap_queue<D>::push(std::size_t v, D d)
+    {
+      assert(d >= 0 && key_type(d) >= last);
+      buckets[bucket(d)].emplace_back(v, d);
+      ++count;
+    }
+
+  // When the bucket of the last key is empty, the least key in the next
+  // bucket becomes the last key, and the entries of that bucket move to
+  // lower buckets.
+  template<typename D>
+    auto
+    radix_heap_queue<D>::pop() -> std::pair<std::size_t, D>
+    {
+      if (buckets[0].empty()) {
+        int i = 1;
+        while (buckets[i].empty())
+          ++i;
+        std::vector<entry>& b = buckets[i];
+        last = std::min_element(b.begin(), b.end(), [](const entry& x, const entry& y) {
+          return x.second < y.second;
+        })->second;
+        for (const entry& x : b)
+          buckets[bucket(x.second)].push_back(x);
+        b.clear();
+      }
+      entry x = buckets[0].back();
+      buckets[0].pop_back();
+      --count;
+      return {x.first, D(x.second)};
+    }
+
+
+  // Queue selectors
+  struct binary_heap
+  {
+    template<typename D>
+      using queue = binary_heap_queue<D>;
+  };
+
+  template<std::size_t K = 4>
+    struct dary_heap
+    {
+      template<typename D>
+        using queue = dary_heap_queue<D, K>;
+    };
+
+  struct radix_heap
+  {
+    template<typename D>
+      using queue = radix_heap_queue<D>;
+  };
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                       [graph.sssp.dijkstra]
+  //                          Dijkstra's Algorithm
+  //
+  // Dijkstra's algorithm finds the shortest paths from a source vertex to
+  // every vertex reachable from it. Vertices are settled in order of their
+  // distance, using the priority queue selected by Q.
+
+  template<typename G, typename W, typename Q = binary_heap>
+    shortest_path_tree<G, Weight_type<G, W>>
+    dijkstra_shortest_paths(const G& g, Vertex<G> s, W w, Q = {})
+    {
+      using D = Weight_type<G, W>;
+      using Tree = shortest_path_tree<G, D>;
+
+      const std::size_t n = vertex_bound(g);
+      assert(std::size_t(s) < n);
+
+      Tree t;
+      t.distance.assign(n, Tree::infinity());
+      t.parent.assign(n, Vertex<G>());
+      t.distance[s] = D(0);
+      t.parent[s] = s;
+
+      typename Q::template queue<D> q(n);
+      q.push(s, D(0));
+      while (!q.empty()) {
+        std::pair<std::size_t, D> x = q.pop();
+        Vertex<G> u(x.first);
+        D d = x.second;
+        if (t.distance[u] < d)
+          continue;
+        for (auto e : out_edges(g, u)) {
+          D k = w(e);
+          assert(!(k < D(0)));
+          Vertex<G> v = out_neighbor(g, e, u);
+          D dv = d + k;
+          if (dv < t.distance[v]) {
+            t.distance[v] = dv;
+            t.parent[v] = u;
+            q.push(v, dv);
+          }
+        }
+      }
+      return t;
+    }
+
+  // Find the shortest paths from s, where the weight of each edge is its
+  // value.
+  template<typename G>
+    inline auto
+    dijkstra_shortest_paths(const G& g, Vertex<G> s)
+    {
+      return dijkstra_shortest_paths(g, s, edge_values(g));
+    }
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                  [graph.sssp.delta_stepping]
+  //                             Delta-Stepping
+  //
+  // Delta-stepping is a parallel relaxation of Dijkstra's algorithm. Vertices
+  // are kept in buckets of width delta by their tentative distance, and all
+  // vertices in the lowest non-empty bucket are processed in parallel. Their
+  // out edges are relaxed, which may add vertices to the same or later
+  // buckets, until the bucket stays empty. With a delta near the average
+  // edge weight, there is enough work in each bucket to keep the threads
+  // busy, while few vertices are processed more than once.
+  //
+  // Each relaxation that improves a distance locks the target vertex, so
+  // that its distance and parent are updated together. Most relaxations do
+  // not improve a distance, and these do not lock. Each block of a bucket
+  // collects the vertices it improves, with their buckets, in its own list,
+  // and the lists are merged into the buckets after every step. The merge
+  // takes time proportional to the number of vertices found.
+  //
+  // A vertex in bucket b is at distance less than (b + 1) * delta, so its
+  // out edges only reach buckets b through b + max_weight / delta + 1. The
+  // buckets are therefore kept in a cyclic array of that many slots, indexed
+  // by the bucket number modulo its size, and the memory used by the
+  // buckets does not grow with the distances. The maximum weight is found
+  // by a pass over the edges before the search.
+  //
+  // All edges are relaxed in every step; edges are not separated into light
+  // and heavy edges. The grain is the minimum number of vertices given to
+  // each thread.
+  //
+  // See U. Meyer, P. Sanders, "Delta-stepping: a parallelizable shortest
+  // path algorithm", J. Algorithms 49 (2003).
+
+  namespace sssp_impl
+  {
+    // Returns the bucket of the distance d.
+    template<typename D>
+      inline std::size_t
+      bucket_of(D d, D delta) { return std::size_t(d / delta); }
+
+    // Returns the greatest weight of an edge of g, or 0 if there are none.
+    template<typename G, typename W>
+      Weight_type<G, W>
+      max_weight(const G& g, W w)
+      {
+        using D = Weight_type<G, W>;
+        D m = D(0);
+        for (auto u : vertices(g))
+          for (auto e : out_edges(g, u))
+            m = std::max(m, D(w(e)));
+        return m;
+      }
+
+    // A spin lock on one vertex.
+    inline void
+    lock(std::atomic<bool>& m)
+    {
+      while (m.exchange(true, std::memory_order_acquire))
+        while (m.load(std::memory_order_relaxed))
+          ;
+    }
+
+    inline void
+    unlock(std::atomic<bool>& m)
+    {
+      m.store(false, std::memory_order_release);
+    }
+
+  } // namespace sssp_impl
+
+  template<typename G, typename W>
+    shortest_path_tree<G, Weight_type<G, W>>
+    delta_stepping_shortest_paths(const G& g, Vertex<G> s, W w, Weight_type<G, W> delta,
+                                  std::size_t grain = 64)
+    {
+      using D = Weight_type<G, W>;
+      using Tree = shortest_path_tree<G, D>;
+      using sssp_impl::bucket_of;
+      using bins = std::vector<std::vector<Vertex<G>>>;
+      constexpr std::size_t npos = -1;
+
+      assert(delta > D(0));
+      const std::size_t n = vertex_bound(g);
+      assert(std::size_t(s) < n);
+
+      std::vector<std::atomic<D>>           dist(n);
+      std::vector<std::atomic<bool>>        locks(n);
+      std::vector<std::size_t>              parent(n);
+      parallel_for(n, [&](std::size_t i) {
+        dist[i].store(Tree::infinity(), std::memory_order_relaxed);
+        locks[i].store(false, std::memory_order_relaxed);
+        parent[i] = npos;
+      });
+      dist[s].store(D(0), std::memory_order_relaxed);
+      parent[s] = s;
+
+      // The pending vertices are in buckets [b, b + r), where b is the
+      // current bucket.
+      const std::size_t r = bucket_of(sssp_impl::max_weight(g, w), delta) + 2;
+      bins buckets(r);
+      buckets[0].push_back(s);
+      std::size_t pending = 1;
+      std::vector<Vertex<G>> frontier;
+      std::vector<std::vector<std::pair<std::size_t, Vertex<G>>>> found;
+      for (std::size_t b = 0; pending != 0; ) {
+        while (buckets[b % r].empty())
+          ++b;
+        frontier.swap(buckets[b % r]);
+        pending -= frontier.size();
+
+        std::size_t blocks = parallel_block_count(frontier.size(), grain);
+        if (found.size() < blocks)
+          found.resize(blocks);
+        parallel_blocks(frontier.size(), [&](std::size_t k, std::size_t first, std::size_t last) {
+          auto& local = found[k];
+          for (std::size_t i = first; i != last; ++i) {
+            Vertex<G> u = frontier[i];
+            D du = dist[u].load(std::memory_order_relaxed);
+            if (bucket_of(du, delta) != b)
+              continue; // Stale: u moved to an earlier bucket.
+            for (auto e : out_edges(g, u)) {
+              D c = w(e);
+              assert(!(c < D(0)));
+              Vertex<G> v = out_neighbor(g, e, u);
+              D dv = du + c;
+              if (!(dv < dist[v].load(std::memory_order_relaxed)))
+                continue;
+              sssp_impl::lock(locks[v]);
+              bool better = dv < dist[v].load(std::memory_order_relaxed);
+              if (better) {
+                dist[v].store(dv, std::memory_order_relaxed);
+                parent[v] = u;
+              }
+              sssp_impl::unlock(locks[v]);
+              if (better) {
+                std::size_t j = bucket_of(dv, delta);
+                assert(b <= j && j - b < r);
+                local.emplace_back(j % r, v);
+              }
+            }
+          }
+        }, grain);
+
+        for (std::size_t k = 0; k < blocks; ++k) {
+          for (const auto& x : found[k])
+            buckets[x.first].push_back(x.second);
+          pending += found[k].size();
+          found[k].clear();
+        }
+        frontier.clear();
+      }
+
+      Tree t;
+      t.distance.resize(n);
+      t.parent.resize(n);
+      parallel_for(n, [&](std::size_t i) {
+        t.distance[i] = dist[i].load(std::memory_order_relaxed);
+        t.parent[i] = Vertex<G>(parent[i]);
+      });
+      return t;
+    }
+
+} // namespace origin
+
+#endif
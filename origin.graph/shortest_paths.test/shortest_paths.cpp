@@ -0,0 +1,157 @@
+// Copyright (c) 2009-2015 Andrew Sutton
+// All rights reserved
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <tuple>
+
+#include <origin.graph/adjacency_list.hpp>
+#include <origin.graph/adjacency_vector.hpp>
+#include <origin.graph/compressed_graph.hpp>
+#include <origin.graph/shortest_paths.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+// Returns the distance of each vertex from s, computed by relaxing every
+// edge until no distance changes.
+template<typename G>
+  vector<Weight_type<G, edge_value_accessor<G>>>
+  reference_distances(const G& g, Vertex<G> s)
+  {
+    using D = Weight_type<G, edge_value_accessor<G>>;
+    vector<D> d(vertex_bound(g), numeric_limits<D>::max());
+    d[s] = 0;
+    for (bool changed = true; changed; ) {
+      changed = false;
+      for (auto u : vertices(g)) {
+        if (d[u] == numeric_limits<D>::max())
+          continue;
+        for (auto e : out_edges(g, u)) {
+          Vertex<G> v = out_neighbor(g, e, u);
+          if (d[u] + g(e) < d[v]) {
+            d[v] = d[u] + g(e);
+            changed = true;
+          }
+        }
+      }
+    }
+    return d;
+  }
+
+// Check that t is a shortest path tree of g from s: distances are those
+// of the reference, and each parent reaches its child across an edge whose
+// weight is the difference in their distances.
+template<typename G, typename T>
+  void
+  check_tree(const G& g, Vertex<G> s, const T& t)
+  {
+    assert(t.distance == reference_distances(g, s));
+    assert(t.parent[s] == s);
+    for (auto v : vertices(g)) {
+      assert(t.reached(v) == (t.distance[v] != T::infinity()));
+      if (!t.reached(v) || v == s)
+        continue;
+      Vertex<G> u = t.parent[v];
+      bool found = false;
+      for (auto e : out_edges(g, u))
+        found |= out_neighbor(g, e, u) == v && t.distance[u] + g(e) == t.distance[v];
+      assert(found);
+    }
+  }
+
+// Search from several sources with each queue and with delta-stepping.
+template<typename G>
+  void
+  check_shortest_paths(const G& g)
+  {
+    cout << "*** shortest paths (" << typestr<G>() << ") ***\n";
+    using D = Weight_type<G, edge_value_accessor<G>>;
+    auto w = edge_values(g);
+    for (auto s : {0, 1, 17, 499}) {
+      Vertex<G> v(s);
+      check_tree(g, v, dijkstra_shortest_paths(g, v));
+      check_tree(g, v, dijkstra_shortest_paths(g, v, w, dary_heap<2>{}));
+      check_tree(g, v, dijkstra_shortest_paths(g, v, w, dary_heap<4>{}));
+      check_tree(g, v, delta_stepping_shortest_paths(g, v, w, D(1)));
+      check_tree(g, v, delta_stepping_shortest_paths(g, v, w, D(16), 7));
+      check_tree(g, v, delta_stepping_shortest_paths(g, v, w, D(1000)));
+    }
+  }
+
+template<typename G>
+  void
+  check_radix_heap(const G& g)
+  {
+    cout << "*** radix heap (" << typestr<G>() << ") ***\n";
+    for (auto s : {0, 1, 17, 499}) {
+      Vertex<G> v(s);
+      check_tree(g, v, dijkstra_shortest_paths(g, v, edge_values(g), radix_heap{}));
+    }
+  }
+
+// Add a weight to each edge. Some weights are zero.
+template<typename T>
+  vector<tuple<size_t, size_t, T>>
+  weighted(const vector<pair<size_t, size_t>>& input, T scale)
+  {
+    vector<tuple<size_t, size_t, T>> r;
+    size_t i = 0;
+    for (auto e : input)
+      r.emplace_back(e.first, e.second, T((i++ * 37) % 50) * scale);
+    return r;
+  }
+
+int main()
+{
+  auto input = random_edges(2000, 8000);
+  auto wi = weighted(input, 1u);
+  auto wd = weighted(input, 0.25);
+
+  using I = directed_adjacency_vector<empty_t, unsigned>;
+  check_shortest_paths(I(wi.begin(), wi.end()));
+  check_radix_heap(I(wi.begin(), wi.end()));
+  check_shortest_paths(undirected_adjacency_vector<empty_t, unsigned>(wi.begin(), wi.end()));
+  check_radix_heap(compressed_directed_graph<empty_t, unsigned>(wi.begin(), wi.end()));
+  check_shortest_paths(compressed_directed_graph<empty_t, unsigned long, false>(wi.begin(), wi.end()));
+  check_shortest_paths(directed_adjacency_vector<empty_t, double, uint32_t>(wd.begin(), wd.end()));
+
+  // Removed vertices leave gaps in the vertex indexes.
+  directed_adjacency_list<empty_t, unsigned> g(wi.begin(), wi.end());
+  for (size_t v = 1000; v < 2000; v += 3)
+    g.remove_vertex(v);
+  check_shortest_paths(g);
+  check_radix_heap(g);
+
+  // Weights given by an accessor instead of edge values.
+  directed_adjacency_vector<> p;
+  for (int i = 0; i < 100; ++i)
+    p.add_vertex();
+  for (int i = 0; i < 99; ++i)
+    p.add_edge(i, i + 1);
+  p.add_edge(0, 99);
+  auto hops = [](Edge<decltype(p)>) { return 1; };
+  auto t = dijkstra_shortest_paths(p, vertex_handle(0), hops);
+  assert(t.distance[99] == 1);
+  assert(t.distance[98] == 98);
+  assert(t.parent[99] == vertex_handle(0));
+  auto u = delta_stepping_shortest_paths(p, vertex_handle(50), hops, 4);
+  assert(u.distance[99] == 49);
+  assert(!u.reached(vertex_handle(0)));
+  assert(u.distance[0] == numeric_limits<int>::max());
+
+  // A long path with a few heavy edges, so that the maximum weight is much
+  // greater than delta.
+  vector<tuple<size_t, size_t, unsigned>> heavy;
+  for (size_t i = 0; i + 1 < 20000; ++i)
+    heavy.emplace_back(i, i + 1, i % 1000 == 999 ? 100001 : 1);
+  compressed_directed_graph<empty_t, unsigned> h(heavy.begin(), heavy.end());
+  auto dh = dijkstra_shortest_paths(h, vertex_handle(0));
+  auto sh = delta_stepping_shortest_paths(h, vertex_handle(0), edge_values(h), 1u);
+  assert(sh.distance == dh.distance);
+  assert(sh.distance[19999] == 19999 + 19 * 100000);
+}
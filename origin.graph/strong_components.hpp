@@ -0,0 +1,228 @@
+// Copyright (c) 2009-2015 Andrew Sutton
+// All rights reserved
+
+#ifndef ORIGIN_GRAPH_STRONG_COMPONENTS_HPP
+#define ORIGIN_GRAPH_STRONG_COMPONENTS_HPP
+
+#include <cassert>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <origin.graph/handle.hpp>
+#include <origin.graph/graph.hpp>
+#include <origin.graph/components.hpp>
+#include <origin.graph/compressed_graph.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                                 [graph.scc]
+  //                       Strongly Connected Components
+  //
+  // The strongly connected components of a directed graph are its maximal
+  // subgraphs in which every vertex reaches every other. Both algorithms
+  // below are depth-first searches, written with explicit stacks so that
+  // long paths do not exhaust the call stack. The stacks are allocated
+  // once, with room for every vertex.
+  //
+  // Components are numbered in a topological order of the condensation of
+  // the graph: if an edge leads from component i to component j, then
+  // i < j. Removed vertices have component npos.
+  //
+  // Tarjan's algorithm finds the components in a single search, and needs
+  // only out edges. Kosaraju's algorithm searches the graph, and then its
+  // reverse, so the graph must store in edges (see in_edge_storage).
+
+  namespace scc_impl
+  {
+    // A frame of a depth-first search: a vertex and the out edges that
+    // remain to be followed.
+    template<typename G>
+      struct frame
+      {
+        using range = decltype(out_edges(std::declval<const G&>(), std::declval<Vertex<G>>()));
+        using iterator = decltype(std::declval<range&>().begin());
+
+        frame(const G& g, Vertex<G> v)
+          : frame(v, out_edges(g, v))
+        { }
+
+        frame(Vertex<G> v, range r)
+          : vertex(v), first(r.begin()), last(r.end())
+        { }
+
+        Vertex<G> vertex;
+        iterator  first;
+        iterator  last;
+      };
+
+  } // namespace scc_impl
+
+
+  template<typename G>
+    Requires<Directed_graph<G>(), component_map>
+    strong_components(const G& g)
+    {
+      constexpr std::size_t npos = -1;
+      const std::size_t n = vertex_bound(g);
+
+      component_map m;
+      m.component.assign(n, component_map::npos);
+      std::vector<std::size_t> index(n, npos);
+      std::vector<std::size_t> low(n);
+      std::vector<Vertex<G>> stack;
+      std::vector<scc_impl::frame<G>> calls;
+      stack.reserve(n);
+      calls.reserve(n);
+
+      std::size_t next = 0;
+      for (auto s : vertices(g)) {
+        if (index[s] != npos)
+          continue;
+        index[s] = low[s] = next++;
+        stack.push_back(s);
+        calls.emplace_back(g, s);
+        while (!calls.empty()) {
+          scc_impl::frame<G>& f = calls.back();
+          Vertex<G> u = f.vertex;
+          if (f.first != f.last) {
+            Vertex<G> v = out_neighbor(g, *f.first, u);
+            ++f.first;
+            if (index[v] == npos) {
+              index[v] = low[v] = next++;
+              stack.push_back(v);
+              calls.emplace_back(g, v);
+            } else if (m.component[v] == component_map::npos) {
+              // v is on the stack.
+              low[u] = std::min(low[u], index[v]);
+            }
+            continue;
+          }
+
+          calls.pop_back();
+          if (!calls.empty()) {
+            Vertex<G> p = calls.back().vertex;
+            low[p] = std::min(low[p], low[u]);
+          }
+          if (low[u] == index[u]) {
+            Vertex<G> v;
+            do {
+              v = stack.back();
+              stack.pop_back();
+              m.component[v] = m.count;
+            } while (v != u);
+            ++m.count;
+          }
+        }
+      }
+
+      // Tarjan's algorithm finds sinks first.
+      for (std::size_t& c : m.component)
+        if (c != component_map::npos)
+          c = m.count - 1 - c;
+      return m;
+    }
+
+
+  template<typename G>
+    Requires<Directed_graph<G>(), component_map>
+    kosaraju_strong_components(const G& g)
+    {
+      static_assert(in_edge_storage<G>::value, "graph does not store in edges");
+      assert(stores_in_edges(g));
+      const std::size_t n = vertex_bound(g);
+
+      // Order the vertices by the time their searches finish.
+      std::vector<char> seen(n, 0);
+      std::vector<Vertex<G>> finished;
+      std::vector<scc_impl::frame<G>> calls;
+      finished.reserve(n);
+      calls.reserve(n);
+      for (auto s : vertices(g)) {
+        if (seen[s])
+          continue;
+        seen[s] = 1;
+        calls.emplace_back(g, s);
+        while (!calls.empty()) {
+          scc_impl::frame<G>& f = calls.back();
+          if (f.first != f.last) {
+            Vertex<G> v = out_neighbor(g, *f.first, f.vertex);
+            ++f.first;
+            if (!seen[v]) {
+              seen[v] = 1;
+              calls.emplace_back(g, v);
+            }
+          } else {
+            finished.push_back(f.vertex);
+            calls.pop_back();
+          }
+        }
+      }
+
+      // Search the reverse graph in decreasing order of finishing time.
+      // Each search reaches exactly one component, and the components are
+      // found in topological order.
+      component_map m;
+      m.component.assign(n, component_map::npos);
+      std::vector<Vertex<G>> work;
+      work.reserve(n);
+      for (auto i = finished.rbegin(); i != finished.rend(); ++i) {
+        Vertex<G> s = *i;
+        if (m.component[s] != component_map::npos)
+          continue;
+        m.component[s] = m.count;
+        work.push_back(s);
+        while (!work.empty()) {
+          Vertex<G> u = work.back();
+          work.pop_back();
+          for (auto e : in_edges(g, u)) {
+            Vertex<G> v = in_neighbor(g, e, u);
+            if (m.component[v] == component_map::npos) {
+              m.component[v] = m.count;
+              work.push_back(v);
+            }
+          }
+        }
+        ++m.count;
+      }
+      return m;
+    }
+
+
+  // ------------------------------------------------------------------------ //
+  //                                                        [graph.condensation]
+  //                              Condensation
+  //
+  // The condensation of a directed graph has a vertex for each strongly
+  // connected component, and an edge from one component to another if any
+  // edge of the graph does. The condensation is acyclic, and since the
+  // components are numbered in topological order, its edges lead from
+  // lesser to greater vertices.
+  //
+  // The condensation is built as a graph of type H, which must be
+  // constructible from a range of pairs of vertex indexes and the number of
+  // vertices. Parallel edges are removed.
+
+  template<typename H = compressed_directed_graph<>, typename G>
+    H
+    condensation(const G& g, const component_map& m)
+    {
+      std::vector<std::pair<std::size_t, std::size_t>> arcs;
+      for (auto u : vertices(g)) {
+        std::size_t cu = m.component[u];
+        for (auto e : out_edges(g, u)) {
+          std::size_t cv = m.component[out_neighbor(g, e, u)];
+          if (cu != cv)
+            arcs.emplace_back(cu, cv);
+        }
+      }
+      std::sort(arcs.begin(), arcs.end());
+      arcs.erase(std::unique(arcs.begin(), arcs.end()), arcs.end());
+      return H(arcs.begin(), arcs.end(), m.count);
+    }
+
+} // namespace origin
+
+#endif
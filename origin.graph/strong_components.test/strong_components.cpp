@@ -0,0 +1,128 @@
+// Copyright (c) 2009-2015 Andrew Sutton
+// All rights reserved
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+
+#include <origin.graph/adjacency_list.hpp>
+#include <origin.graph/adjacency_vector.hpp>
+#include <origin.graph/compressed_graph.hpp>
+#include <origin.graph/strong_components.hpp>
+#include <origin.graph/topological_sort.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+// Returns the set of vertices reachable from s.
+template<typename G>
+  vector<char>
+  reachable(const G& g, Vertex<G> s)
+  {
+    vector<char> r(vertex_bound(g), 0);
+    vector<Vertex<G>> work {s};
+    r[s] = 1;
+    while (!work.empty()) {
+      Vertex<G> u = work.back();
+      work.pop_back();
+      for (auto e : out_edges(g, u)) {
+        Vertex<G> v = out_neighbor(g, e, u);
+        if (!r[v]) {
+          r[v] = 1;
+          work.push_back(v);
+        }
+      }
+    }
+    return r;
+  }
+
+// Check that vertices share a component exactly when they reach each
+// other, and that components are numbered in topological order.
+template<typename G>
+  void
+  check_components(const G& g, const component_map& m)
+  {
+    size_t n = vertex_bound(g);
+    vector<vector<char>> reach(n);
+    for (auto v : vertices(g))
+      reach[v] = reachable(g, v);
+    vector<char> used(m.count, 0);
+    for (auto u : vertices(g)) {
+      assert(m.component[u] < m.count);
+      used[m.component[u]] = 1;
+      for (auto v : vertices(g))
+        assert((m.component[u] == m.component[v]) == (reach[u][v] && reach[v][u]));
+      for (auto e : out_edges(g, u))
+        assert(m.component[u] <= m.component[out_neighbor(g, e, u)]);
+    }
+    assert(count(used.begin(), used.end(), 1) == ptrdiff_t(m.count));
+  }
+
+// Kosaraju's algorithm is checked only on graphs that store in edges.
+template<typename G>
+  void
+  check_kosaraju(const G& g, std::true_type)
+  {
+    if (stores_in_edges(g))
+      check_components(g, kosaraju_strong_components(g));
+  }
+
+template<typename G>
+  void
+  check_kosaraju(const G&, std::false_type)
+  { }
+
+template<typename G>
+  void
+  check_scc(const G& g)
+  {
+    cout << "*** strong components (" << typestr<G>() << ") ***\n";
+    auto m = strong_components(g);
+    check_components(g, m);
+    check_kosaraju(g, in_edge_storage<G>{});
+
+    // The condensation is acyclic, with edges from lesser to greater
+    // components.
+    auto c = condensation(g, m);
+    assert(c.order() == m.count);
+    assert(is_acyclic(c));
+    for (auto e : edges(c))
+      assert(source(c, e) < target(c, e));
+  }
+
+int main()
+{
+  auto input = random_edges(1000, 1600);
+  check_scc(directed_adjacency_vector<>(input.begin(), input.end()));
+  check_scc(directed_adjacency_vector<empty_t, empty_t, uint32_t>(input.begin(), input.end()));
+  check_scc(compressed_directed_graph<>(input.begin(), input.end()));
+  check_scc(compressed_directed_graph<empty_t, empty_t, false>(input.begin(), input.end()));
+
+  // Removed vertices leave gaps in the vertex indexes.
+  directed_adjacency_list<> g(input.begin(), input.end());
+  for (size_t v = 500; v < 1000; v += 3)
+    g.remove_vertex(v);
+  check_scc(g);
+  assert(strong_components(g).component[500] == component_map::npos);
+
+  // A long cycle does not exhaust the call stack.
+  const size_t n = 1000000;
+  vector<pair<size_t, size_t>> cycle;
+  for (size_t i = 0; i < n; ++i)
+    cycle.emplace_back(i, (i + 1) % n);
+  compressed_directed_graph<> c(cycle.begin(), cycle.end());
+  assert(strong_components(c).count == 1);
+  assert(kosaraju_strong_components(c).count == 1);
+
+  // Without the closing edge, every vertex is its own component, in path
+  // order.
+  cycle.pop_back();
+  compressed_directed_graph<> p(cycle.begin(), cycle.end());
+  auto m = strong_components(p);
+  assert(m.count == n);
+  assert(m.component[0] == 0 && m.component[n - 1] == n - 1);
+  assert(kosaraju_strong_components(p).component == m.component);
+}
@@ -0,0 +1,65 @@
+// Copyright (c) 2009-2015 Andrew Sutton
+// All rights reserved
+
+#ifndef ORIGIN_GRAPH_TOPOLOGICAL_SORT_HPP
+#define ORIGIN_GRAPH_TOPOLOGICAL_SORT_HPP
+
+#include <vector>
+
+#include <origin.graph/handle.hpp>
+#include <origin.graph/graph.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                            [graph.toposort]
+  //                           Topological Sort
+  //
+  // A topological order of a directed acyclic graph lists each vertex
+  // before the targets of its out edges. Kahn's algorithm counts the in
+  // edges of each vertex, and repeatedly emits a vertex with no remaining
+  // in edges, removing its out edges from the counts. The output array
+  // doubles as the queue of vertices ready to be emitted, so the only
+  // other storage is the array of counts. In edges need not be stored.
+  //
+  // If the graph has a cycle, no vertex on (or reachable from) the cycle is
+  // ever ready, and the result has fewer vertices than the graph. Callers
+  // can compare its size with the order of the graph to detect cycles.
+
+  template<typename G>
+    Requires<Directed_graph<G>(), std::vector<Vertex<G>>>
+    topological_sort(const G& g)
+    {
+      const std::size_t n = vertex_bound(g);
+      std::vector<std::size_t> count(n, 0);
+      for (auto u : vertices(g))
+        for (auto e : out_edges(g, u))
+          ++count[out_neighbor(g, e, u)];
+
+      std::vector<Vertex<G>> order;
+      order.reserve(g.order());
+      for (auto v : vertices(g))
+        if (count[v] == 0)
+          order.push_back(v);
+      for (std::size_t i = 0; i < order.size(); ++i) {
+        Vertex<G> u = order[i];
+        for (auto e : out_edges(g, u)) {
+          Vertex<G> v = out_neighbor(g, e, u);
+          if (--count[v] == 0)
+            order.push_back(v);
+        }
+      }
+      return order;
+    }
+
+  // Returns true if g has no cycles.
+  template<typename G>
+    inline Requires<Directed_graph<G>(), bool>
+    is_acyclic(const G& g)
+    {
+      return topological_sort(g).size() == g.order();
+    }
+
+} // namespace origin
+
+#endif
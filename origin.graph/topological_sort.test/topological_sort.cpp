@@ -0,0 +1,80 @@
+// Copyright (c) 2009-2015 Andrew Sutton
+// All rights reserved
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+
+#include <origin.graph/adjacency_list.hpp>
+#include <origin.graph/adjacency_vector.hpp>
+#include <origin.graph/compressed_graph.hpp>
+#include <origin.graph/topological_sort.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+// Check that the order contains each vertex once, before the targets of
+// its out edges.
+template<typename G>
+  void
+  check_order(const G& g, const vector<Vertex<G>>& order)
+  {
+    assert(order.size() == g.order());
+    vector<size_t> pos(vertex_bound(g), size_t(-1));
+    for (size_t i = 0; i < order.size(); ++i) {
+      assert(pos[order[i]] == size_t(-1));
+      pos[order[i]] = i;
+    }
+    for (auto u : vertices(g))
+      for (auto e : out_edges(g, u))
+        assert(pos[u] < pos[out_neighbor(g, e, u)]);
+  }
+
+template<typename G>
+  void
+  check_toposort(const G& g)
+  {
+    cout << "*** topological sort (" << typestr<G>() << ") ***\n";
+    check_order(g, topological_sort(g));
+    assert(is_acyclic(g));
+  }
+
+int main()
+{
+  // Orient random edges by a scrambled rank, so that the graph is acyclic
+  // but its topological order is not the order of its vertices.
+  auto input = random_edges(2000, 8000);
+  auto rank = [](size_t v) { return (v * 7919) % 2000; };
+  vector<pair<size_t, size_t>> dag;
+  for (auto e : input)
+    if (rank(e.first) < rank(e.second))
+      dag.push_back(e);
+    else if (rank(e.second) < rank(e.first))
+      dag.emplace_back(e.second, e.first);
+
+  check_toposort(directed_adjacency_vector<>(dag.begin(), dag.end()));
+  check_toposort(directed_adjacency_vector<empty_t, empty_t, uint32_t>(dag.begin(), dag.end()));
+  check_toposort(compressed_directed_graph<empty_t, empty_t, false>(dag.begin(), dag.end()));
+
+  directed_adjacency_list<> g(dag.begin(), dag.end());
+  for (size_t v = 1000; v < 2000; v += 3)
+    g.remove_vertex(v);
+  check_toposort(g);
+
+  // A cycle stops the sort at the vertices it reaches.
+  directed_adjacency_vector<> c;
+  for (int i = 0; i < 5; ++i)
+    c.add_vertex();
+  c.add_edge(0, 1);
+  c.add_edge(1, 2);
+  c.add_edge(2, 3);
+  c.add_edge(3, 1);
+  c.add_edge(0, 4);
+  auto order = topological_sort(c);
+  assert(order.size() == 2);
+  assert(order[0] == vertex_handle(0));
+  assert(!is_acyclic(c));
+}
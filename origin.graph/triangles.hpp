@@ -0,0 +1,311 @@
+// Copyright (c) 2009-2015 Andrew Sutton
+// All rights reserved
+
+#ifndef ORIGIN_GRAPH_TRIANGLES_HPP
+#define ORIGIN_GRAPH_TRIANGLES_HPP
+
+#include <cassert>
+#include <cstdint>
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__)
+#  include <emmintrin.h>
+#endif
+
+#include <origin.graph/handle.hpp>
+#include <origin.graph/graph.hpp>
+#include <origin.graph/parallel.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                                                          [graph.triangles]
+  //                           Triangle Counting
+  //
+  // A triangle is a set of three vertices that are pairwise adjacent. The
+  // triangle count of a vertex is the number of triangles containing it,
+  // and its local clustering coefficient is the fraction of pairs of its
+  // neighbors that are adjacent: 2t / (d (d - 1)) for a vertex of degree
+  // d in t triangles. Graphs are treated as simple: self loops and parallel
+  // edges are ignored, and the degree of a vertex is its number of distinct
+  // neighbors.
+  //
+  // The neighbors of every vertex are copied into a sorted array once.
+  // Each edge is then oriented from the endpoint of lesser degree to the
+  // endpoint of greater degree (breaking ties by index), so that every
+  // triangle is found exactly once, from its least vertex u: for each out
+  // neighbor v of u, the common out neighbors w of u and v close triangles.
+  // Orientation also bounds the out degree of every vertex by the square
+  // root of the number of edges, so hubs do not dominate the work.
+  //
+  // Sorted neighbor arrays are intersected by merging, or by galloping
+  // (exponential search) through the longer array when one is much shorter
+  // than the other. For graphs with 32-bit vertex indexes, the merge
+  // compares blocks of four neighbors at a time with SSE2, where available.
+  //
+  // Vertices are divided among threads. The triangles found from u are
+  // counted locally for u, and atomically for v and w.
+
+  // The result of triangle counting. The number of triangles containing
+  // each vertex v is count[v], and its local clustering coefficient is
+  // clustering[v]. The total number of triangles in the graph is total.
+  struct triangle_counts
+  {
+    std::vector<std::size_t> count;
+    std::vector<double>      clustering;
+    std::size_t              total = 0;
+  };
+
+
+  namespace triangles_impl
+  {
+    // Lists shorter than 1/gallop_ratio of the list they are intersected
+    // with are searched for, rather than merged.
+    constexpr std::size_t gallop_ratio = 32;
+
+    // Returns the first position in [first, last) not less than x, by
+    // exponential search from first.
+    template<typename T>
+      inline const T*
+      gallop(const T* first, const T* last, T x)
+      {
+        std::size_t step = 1;
+        const T* lo = first;
+        while (step < std::size_t(last - lo) && lo[step] < x) {
+          lo += step;
+          step *= 2;
+        }
+        return std::lower_bound(lo, lo + std::min(step + 1, std::size_t(last - lo)), x);
+      }
+
+    // Call f(x) for each x in both of the sorted, unique arrays a and b,
+    // by merging.
+    template<typename T, typename F>
+      inline void
+      scalar_intersect(const T* a, const T* a_end, const T* b, const T* b_end, F f)
+      {
+        while (a != a_end && b != b_end) {
+          if (*a < *b) {
+            ++a;
+          } else if (*b < *a) {
+            ++b;
+          } else {
+            f(*a);
+            ++a;
+            ++b;
+          }
+        }
+      }
+
+    template<typename T, typename F>
+      inline void
+      merge_intersect(const T* a, const T* a_end, const T* b, const T* b_end, F f)
+      {
+        scalar_intersect(a, a_end, b, b_end, f);
+      }
+
+#if defined(__SSE2__)
+    // Compare blocks of four elements. All rotations of the block of b are
+    // compared with the block of a, so the mask has a bit for each element
+    // of a in the block of b. The block whose last element is lesser is
+    // then consumed (or both, if equal).
+    template<typename F>
+      inline void
+      merge_intersect(const std::uint32_t* a, const std::uint32_t* a_end,
+                      const std::uint32_t* b, const std::uint32_t* b_end, F f)
+      {
+        while (a_end - a >= 4 && b_end - b >= 4) {
+          __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+          __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+          __m128i m = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi32(va, vb),
+                         _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1)))),
+            _mm_or_si128(_mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))),
+                         _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3)))));
+          int bits = _mm_movemask_ps(_mm_castsi128_ps(m));
+          for (int i = 0; bits; ++i, bits >>= 1)
+            if (bits & 1)
+              f(a[i]);
+          std::uint32_t x = a[3];
+          std::uint32_t y = b[3];
+          if (x <= y)
+            a += 4;
+          if (y <= x)
+            b += 4;
+        }
+        scalar_intersect(a, a_end, b, b_end, f);
+      }
+#endif
+
+    // Call f(x) for each x in both of the sorted, unique arrays a and b.
+    template<typename T, typename F>
+      inline void
+      intersect(const T* a, const T* a_end, const T* b, const T* b_end, F f)
+      {
+        std::size_t na = a_end - a;
+        std::size_t nb = b_end - b;
+        if (nb < na) {
+          std::swap(a, b);
+          std::swap(a_end, b_end);
+          std::swap(na, nb);
+        }
+        if (na == 0)
+          return;
+        if (na * gallop_ratio < nb) {
+          for ( ; a != a_end && b != b_end; ++a) {
+            b = gallop(b, b_end, *a);
+            if (b != b_end && *b == *a) {
+              f(*a);
+              ++b;
+            }
+          }
+          return;
+        }
+        merge_intersect(a, a_end, b, b_end, f);
+      }
+
+    // A graph in CSR form, with sorted neighbor arrays.
+    template<typename T>
+      struct sorted_adjacency
+      {
+        const T* begin(std::size_t v) const { return targets.data() + offsets[v]; }
+        const T* end(std::size_t v) const   { return targets.data() + offsets[v + 1]; }
+
+        std::vector<std::size_t> offsets;
+        std::vector<T>           targets;
+      };
+
+    // Returns the distinct neighbors of each vertex of g, other than
+    // itself, in increasing order.
+    template<typename T, typename G>
+      sorted_adjacency<T>
+      neighbors(const G& g, std::size_t n, std::size_t grain)
+      {
+        sorted_adjacency<T> a;
+        a.offsets.assign(n + 1, 0);
+        for (auto u : vertices(g))
+          a.offsets[std::size_t(u) + 1] = out_degree(g, u);
+        for (std::size_t v = 0; v < n; ++v)
+          a.offsets[v + 1] += a.offsets[v];
+        a.targets.resize(a.offsets[n]);
+        for (auto u : vertices(g)) {
+          T* p = a.targets.data() + a.offsets[u];
+          for (auto e : out_edges(g, u))
+            *p++ = T(out_neighbor(g, e, u));
+        }
+
+        // Sort each array, and count what remains after removing duplicates
+        // and self loops.
+        std::vector<std::size_t> degree(n + 1, 0);
+        parallel_for(n, [&](std::size_t v) {
+          T* first = a.targets.data() + a.offsets[v];
+          T* last = a.targets.data() + a.offsets[v + 1];
+          std::sort(first, last);
+          last = std::unique(first, last);
+          last = std::remove(first, last, T(v));
+          degree[v + 1] = last - first;
+        }, grain);
+        for (std::size_t v = 0; v < n; ++v)
+          degree[v + 1] += degree[v];
+
+        sorted_adjacency<T> r;
+        r.targets.resize(degree[n]);
+        parallel_for(n, [&](std::size_t v) {
+          std::copy_n(a.begin(v), degree[v + 1] - degree[v], r.targets.data() + degree[v]);
+        }, grain);
+        r.offsets = std::move(degree);
+        return r;
+      }
+
+    // Returns the edges of a oriented from lesser to greater degree.
+    template<typename T>
+      sorted_adjacency<T>
+      orient(const sorted_adjacency<T>& a, std::size_t n, std::size_t grain)
+      {
+        auto degree = [&](std::size_t v) { return a.offsets[v + 1] - a.offsets[v]; };
+        auto before = [&](std::size_t u, std::size_t v) {
+          std::size_t du = degree(u);
+          std::size_t dv = degree(v);
+          return du < dv || (du == dv && u < v);
+        };
+
+        sorted_adjacency<T> r;
+        r.offsets.assign(n + 1, 0);
+        parallel_for(n, [&](std::size_t u) {
+          r.offsets[u + 1] = std::count_if(a.begin(u), a.end(u), [&](T v) {
+            return before(u, v);
+          });
+        }, grain);
+        for (std::size_t v = 0; v < n; ++v)
+          r.offsets[v + 1] += r.offsets[v];
+        r.targets.resize(r.offsets[n]);
+        parallel_for(n, [&](std::size_t u) {
+          std::copy_if(a.begin(u), a.end(u), r.targets.data() + r.offsets[u], [&](T v) {
+            return before(u, v);
+          });
+        }, grain);
+        return r;
+      }
+
+  } // namespace triangles_impl
+
+
+  // Count the triangles of g. The grain is the minimum number of vertices
+  // given to each thread.
+  template<typename G>
+    Requires<Undirected_graph<G>(), triangle_counts>
+    count_triangles(const G& g, std::size_t grain = 1024)
+    {
+      using T = typename Vertex<G>::value_type;
+      const std::size_t n = vertex_bound(g);
+
+      triangles_impl::sorted_adjacency<T> a = triangles_impl::neighbors<T>(g, n, grain);
+      triangles_impl::sorted_adjacency<T> o = triangles_impl::orient(a, n, grain);
+
+      std::vector<std::atomic<std::size_t>> count(n);
+      parallel_for(n, [&](std::size_t v) {
+        count[v].store(0, std::memory_order_relaxed);
+      }, grain);
+
+      std::vector<std::size_t> total(parallel_block_count(n, grain), 0);
+      parallel_blocks(n, [&](std::size_t b, std::size_t first, std::size_t last) {
+        for (std::size_t u = first; u != last; ++u) {
+          std::size_t k = 0;
+          for (const T* p = o.begin(u); p != o.end(u); ++p) {
+            std::size_t v = *p;
+            std::size_t kv = 0;
+            triangles_impl::intersect(o.begin(u), o.end(u), o.begin(v), o.end(v), [&](T w) {
+              ++kv;
+              count[w].fetch_add(1, std::memory_order_relaxed);
+            });
+            if (kv)
+              count[v].fetch_add(kv, std::memory_order_relaxed);
+            k += kv;
+          }
+          if (k)
+            count[u].fetch_add(k, std::memory_order_relaxed);
+          total[b] += k;
+        }
+      }, grain);
+
+      triangle_counts r;
+      r.count.resize(n);
+      r.clustering.resize(n);
+      parallel_for(n, [&](std::size_t v) {
+        std::size_t t = count[v].load(std::memory_order_relaxed);
+        double d = double(a.offsets[v + 1] - a.offsets[v]);
+        r.count[v] = t;
+        r.clustering[v] = d < 2 ? 0.0 : 2 * t / (d * (d - 1));
+      }, grain);
+      for (std::size_t k : total)
+        r.total += k;
+      return r;
+    }
+
+} // namespace origin
+
+#endif
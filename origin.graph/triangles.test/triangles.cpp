@@ -0,0 +1,111 @@
+// Copyright (c) 2009-2015 Andrew Sutton
+// All rights reserved
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <set>
+
+#include <origin.graph/adjacency_list.hpp>
+#include <origin.graph/adjacency_vector.hpp>
+#include <origin.graph/compressed_graph.hpp>
+#include <origin.graph/triangles.hpp>
+
+#include "../graph.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace testing;
+
+// Returns the number of triangles containing each vertex, by testing
+// every pair of neighbors for adjacency.
+template<typename G>
+  vector<size_t>
+  reference_counts(const G& g)
+  {
+    size_t n = vertex_bound(g);
+    vector<set<size_t>> adj(n);
+    for (auto u : vertices(g))
+      for (auto e : out_edges(g, u))
+        if (out_neighbor(g, e, u) != u)
+          adj[u].insert(out_neighbor(g, e, u));
+    vector<size_t> t(n, 0);
+    for (size_t u = 0; u < n; ++u)
+      for (size_t v : adj[u])
+        for (size_t w : adj[u])
+          if (v < w && adj[v].count(w))
+            ++t[u];
+    return t;
+  }
+
+template<typename G>
+  void
+  check_triangles(const G& g)
+  {
+    cout << "*** triangles (" << typestr<G>() << ") ***\n";
+    auto t = reference_counts(g);
+    size_t sum = 0;
+    for (size_t k : t)
+      sum += k;
+    for (size_t grain : {size_t(7), size_t(1024)}) {
+      auto r = count_triangles(g, grain);
+      assert(r.count == t);
+      assert(r.total * 3 == sum);
+    }
+  }
+
+// Dense graphs, so that the neighbor arrays are long enough to use the
+// block intersection and galloping.
+vector<pair<size_t, size_t>>
+dense_edges()
+{
+  auto r = random_edges(300, 12000, 7);
+  for (size_t v = 0; v < 300; ++v)
+    r.emplace_back(0, v);
+  return r;
+}
+
+int main()
+{
+  for (auto input : {random_edges(2000, 8000), dense_edges()}) {
+    check_triangles(undirected_adjacency_vector<>(input.begin(), input.end()));
+    check_triangles(undirected_adjacency_vector<empty_t, empty_t, uint32_t>(input.begin(), input.end()));
+    check_triangles(compressed_undirected_graph<>(input.begin(), input.end()));
+
+    undirected_adjacency_list<> g(input.begin(), input.end());
+    for (size_t v = 100; v < 300; v += 3)
+      g.remove_vertex(v);
+    check_triangles(g);
+  }
+
+  // A clique on four vertices, with a pendant vertex, a parallel edge, and
+  // a self loop.
+  undirected_adjacency_vector<> k;
+  for (int i = 0; i < 5; ++i)
+    k.add_vertex();
+  for (int i = 0; i < 4; ++i)
+    for (int j = i + 1; j < 4; ++j)
+      k.add_edge(i, j);
+  k.add_edge(0, 1);
+  k.add_edge(2, 2);
+  k.add_edge(3, 4);
+  auto r = count_triangles(k);
+  assert(r.total == 4);
+  assert(r.count[0] == 3 && r.count[4] == 0);
+  assert(r.clustering[0] == 1);
+  assert(fabs(r.clustering[3] - 0.5) < 1e-12);
+  assert(r.clustering[4] == 0);
+
+  // Galloping agrees with binary search for every length, including
+  // searches that run off the end of the array.
+  for (int n = 0; n < 70; ++n) {
+    vector<int> a;
+    for (int i = 0; i < n; ++i)
+      a.push_back(2 * i);
+    const int* first = a.data();
+    const int* last = first + n;
+    for (int x = -1; x <= 2 * n + 1; ++x)
+      assert(triangles_impl::gallop(first, last, x) == lower_bound(first, last, x));
+  }
+}